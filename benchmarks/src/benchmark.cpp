@@ -0,0 +1,81 @@
+#include "benchmark.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace SirMetal::benchmark {
+
+std::vector<RegisteredBenchmark> &getRegisteredBenchmarks() {
+  static std::vector<RegisteredBenchmark> benchmarks;
+  return benchmarks;
+}
+
+Registrar::Registrar(const char *name, BenchmarkFunction function) {
+  getRegisteredBenchmarks().push_back({name, function});
+}
+
+CacheMissCounter::CacheMissCounter() {
+#if defined(__linux__)
+  perf_event_attr attr{};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(perf_event_attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // this fails on most containers and VMs, in that case we simply don't report
+  m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter() {
+#if defined(__linux__)
+  if (m_fd >= 0) { close(m_fd); }
+#endif
+}
+
+void CacheMissCounter::start() {
+#if defined(__linux__)
+  if (m_fd < 0) { return; }
+  ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+uint64_t CacheMissCounter::stop() {
+#if defined(__linux__)
+  if (m_fd < 0) { return 0; }
+  ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+  uint64_t count = 0;
+  if (read(m_fd, &count, sizeof(uint64_t)) != sizeof(uint64_t)) { return 0; }
+  return count;
+#else
+  return 0;
+#endif
+}
+
+void State::record(const char *name, const uint64_t opCount,
+                   std::vector<double> &timings, std::vector<uint64_t> &misses) {
+  const size_t count = timings.size();
+  std::sort(timings.begin(), timings.end());
+  std::sort(misses.begin(), misses.end());
+  const double ops = static_cast<double>(opCount == 0 ? 1 : opCount);
+
+  Result result{};
+  result.name = m_benchmarkName + "/" + name;
+  result.opCount = opCount;
+  result.nsPerOp = timings[count / 2] / ops;
+  result.nsPerOpMin = timings[0] / ops;
+  result.opsPerSecond = result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0;
+  result.cacheMissesPerOp =
+          m_counter->isAvailable() ? static_cast<double>(misses[count / 2]) / ops : -1.0;
+  m_results.push_back(result);
+}
+
+}// namespace SirMetal::benchmark
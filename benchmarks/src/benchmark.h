@@ -0,0 +1,136 @@
+#pragma once
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal micro benchmark harness. A benchmark is a free function registered
+// with SM_BENCHMARK, it does its own setup and then calls State::measure for
+// every operation mix it wants to time. The measured body is run a number of
+// repetitions, each preceded by the (not timed) setup, and the median is
+// reported. Where the platform allows it (linux perf events) hardware cache
+// misses are sampled around the timed body as well.
+namespace SirMetal::benchmark {
+
+struct Result {
+  std::string name;
+  uint64_t opCount;
+  double nsPerOp;       // median over the repetitions
+  double nsPerOpMin;    // best repetition
+  double opsPerSecond;  // derived from the median
+  double cacheMissesPerOp;// negative when counters are not available
+  // extra named values a benchmark wants to report, probe lengths and the like
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+class CacheMissCounter {
+ public:
+  CacheMissCounter();
+  ~CacheMissCounter();
+  bool isAvailable() const { return m_fd >= 0; }
+  void start();
+  // returns the number of misses since start, 0 if not available
+  uint64_t stop();
+
+  CacheMissCounter(const CacheMissCounter &) = delete;
+  CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+ private:
+  int m_fd = -1;
+};
+
+class State {
+ public:
+  State(const char *benchmarkName, uint32_t repetitions, CacheMissCounter *counter)
+      : m_benchmarkName(benchmarkName), m_repetitions(repetitions),
+        m_counter(counter) {}
+
+  // setup runs before every repetition and is not timed, body is timed and is
+  // expected to perform opCount operations
+  template <typename SETUP, typename BODY>
+  void measure(const char *name, const uint64_t opCount, SETUP setup, BODY body) {
+    std::vector<double> timings;
+    std::vector<uint64_t> misses;
+    timings.reserve(m_repetitions);
+    misses.reserve(m_repetitions);
+    for (uint32_t r = 0; r < m_repetitions; ++r) {
+      setup();
+      m_counter->start();
+      const auto t1 = std::chrono::high_resolution_clock::now();
+      body();
+      const auto t2 = std::chrono::high_resolution_clock::now();
+      misses.push_back(m_counter->stop());
+      timings.push_back(static_cast<double>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count()));
+    }
+    record(name, opCount, timings, misses);
+  }
+  template <typename BODY>
+  void measure(const char *name, const uint64_t opCount, BODY body) {
+    measure(name, opCount, [] {}, body);
+  }
+
+  // attaches a named value to the last measured result
+  void setCounter(const char *name, const double value) {
+    if (m_results.empty()) { return; }
+    m_results.back().counters.emplace_back(name, value);
+  }
+
+  const std::vector<Result> &getResults() const { return m_results; }
+
+ private:
+  void record(const char *name, uint64_t opCount, std::vector<double> &timings,
+              std::vector<uint64_t> &misses);
+
+ private:
+  std::string m_benchmarkName;
+  uint32_t m_repetitions;
+  CacheMissCounter *m_counter;
+  std::vector<Result> m_results;
+};
+
+typedef void (*BenchmarkFunction)(State &state);
+
+struct Registrar {
+  Registrar(const char *name, BenchmarkFunction function);
+};
+
+struct RegisteredBenchmark {
+  const char *name;
+  BenchmarkFunction function;
+};
+std::vector<RegisteredBenchmark> &getRegisteredBenchmarks();
+
+// prevents the compiler from optimizing away a computed value
+template <typename T>
+inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// small deterministic generator, we want the same mix on every run and every
+// machine, rand() is neither
+struct Random {
+  uint64_t m_state;
+  explicit Random(const uint64_t seed = 0x9E3779B97F4A7C15ull) : m_state(seed) {}
+  uint32_t next() {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 7;
+    m_state ^= m_state << 17;
+    return static_cast<uint32_t>(m_state >> 32);
+  }
+  // value in [minValue, maxValue)
+  uint32_t range(const uint32_t minValue, const uint32_t maxValue) {
+    return minValue + next() % (maxValue - minValue);
+  }
+};
+
+}// namespace SirMetal::benchmark
+
+#define SM_BENCHMARK_CONCAT_INTERNAL(a, b) a##b
+#define SM_BENCHMARK_CONCAT(a, b) SM_BENCHMARK_CONCAT_INTERNAL(a, b)
+#define SM_BENCHMARK(NAME)                                                          \
+  static void NAME(SirMetal::benchmark::State &state);                              \
+  static SirMetal::benchmark::Registrar SM_BENCHMARK_CONCAT(NAME, _registrar)(#NAME, \
+                                                                              NAME); \
+  static void NAME(SirMetal::benchmark::State &state)
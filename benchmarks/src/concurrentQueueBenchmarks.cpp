@@ -0,0 +1,154 @@
+#include "SirMetal/core/memory/cpu/mpmcQueue.h"
+#include "SirMetal/core/memory/cpu/ringBuffer.h"
+#include "SirMetal/core/memory/cpu/spscQueue.h"
+#include "benchmark.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr uint32_t QUEUE_CAPACITY = 1024;
+static constexpr uint32_t OPERATIONS_PER_PRODUCER = 200000;
+static constexpr uint32_t BATCH = 32;
+static constexpr uint32_t PAIR_COUNTS[] = {1, 2, 4, 8};
+
+// what a cross thread queue looked like before, a ring buffer behind a mutex
+class LockedRingBuffer {
+public:
+  bool push(const uint64_t value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ring.push(value);
+  }
+  bool pop(uint64_t &value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ring.isEmpty()) { return false; }
+    value = m_ring.pop();
+    return true;
+  }
+
+private:
+  std::mutex m_mutex;
+  SirMetal::RingBuffer<uint64_t> m_ring{QUEUE_CAPACITY};
+};
+
+// producers push their values, consumers pop until everything went through,
+// both sides yield when the queue is full or empty
+template <typename PUSH, typename POP>
+static void runPairs(const uint32_t pairCount, PUSH push, POP pop) {
+  const uint64_t total = static_cast<uint64_t>(pairCount) * OPERATIONS_PER_PRODUCER;
+  std::atomic<uint64_t> consumed{0};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < pairCount; ++t) {
+    threads.emplace_back([&push] {
+      for (uint32_t i = 0; i < OPERATIONS_PER_PRODUCER;) {
+        const uint32_t pushed = push(i, OPERATIONS_PER_PRODUCER - i);
+        if (pushed == 0) { std::this_thread::yield(); }
+        i += pushed;
+      }
+    });
+    threads.emplace_back([&pop, &consumed, total] {
+      uint64_t sum = 0;
+      while (consumed.load(std::memory_order_relaxed) < total) {
+        const uint32_t popped = pop(sum);
+        if (popped == 0) {
+          std::this_thread::yield();
+        } else {
+          consumed.fetch_add(popped, std::memory_order_relaxed);
+        }
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+}
+
+// pushes up to BATCH values starting at first, returns how many went in
+template <typename QUEUE>
+static uint32_t pushBatch(QUEUE &queue, const uint32_t first, const uint32_t left) {
+  uint64_t values[BATCH];
+  const uint32_t count = left < BATCH ? left : BATCH;
+  for (uint32_t b = 0; b < count; ++b) { values[b] = first + b; }
+  return queue.pushBatch(values, count);
+}
+template <typename QUEUE>
+static uint32_t popBatch(QUEUE &queue, uint64_t &sum) {
+  uint64_t values[BATCH];
+  const uint32_t popped = queue.popBatch(values, BATCH);
+  for (uint32_t b = 0; b < popped; ++b) { sum += values[b]; }
+  return popped;
+}
+
+// loader thread to render thread
+SM_BENCHMARK(SpscQueue) {
+  const uint64_t operations = OPERATIONS_PER_PRODUCER * 2ull;
+  state.measure("locked", operations, [&] {
+    LockedRingBuffer queue;
+    runPairs(
+            1, [&](const uint32_t i, uint32_t) { return queue.push(i) ? 1u : 0u; },
+            [&](uint64_t &sum) {
+              uint64_t value = 0;
+              if (!queue.pop(value)) { return 0u; }
+              sum += value;
+              return 1u;
+            });
+  });
+  state.measure("single", operations, [&] {
+    SirMetal::SpscQueue<uint64_t> queue(QUEUE_CAPACITY);
+    runPairs(
+            1, [&](const uint32_t i, uint32_t) { return queue.push(i) ? 1u : 0u; },
+            [&](uint64_t &sum) {
+              uint64_t value = 0;
+              if (!queue.pop(value)) { return 0u; }
+              sum += value;
+              return 1u;
+            });
+  });
+  state.measure("batch", operations, [&] {
+    SirMetal::SpscQueue<uint64_t> queue(QUEUE_CAPACITY);
+    runPairs(
+            1, [&](const uint32_t i, const uint32_t left) { return pushBatch(queue, i, left); },
+            [&](uint64_t &sum) { return popBatch(queue, sum); });
+  });
+}
+
+// workers posting events, every pair adds a producer and a consumer
+SM_BENCHMARK(MpmcQueueContention) {
+  for (const uint32_t pairCount : PAIR_COUNTS) {
+    const uint64_t operations = static_cast<uint64_t>(pairCount) * OPERATIONS_PER_PRODUCER * 2;
+    const std::string suffix = "/" + std::to_string(pairCount) + "pairs";
+
+    const std::string lockedName = "locked" + suffix;
+    state.measure(lockedName.c_str(), operations, [&] {
+      LockedRingBuffer queue;
+      runPairs(
+              pairCount, [&](const uint32_t i, uint32_t) { return queue.push(i) ? 1u : 0u; },
+              [&](uint64_t &sum) {
+                uint64_t value = 0;
+                if (!queue.pop(value)) { return 0u; }
+                sum += value;
+                return 1u;
+              });
+    });
+    const std::string singleName = "single" + suffix;
+    state.measure(singleName.c_str(), operations, [&] {
+      SirMetal::MpmcQueue<uint64_t> queue(QUEUE_CAPACITY);
+      runPairs(
+              pairCount, [&](const uint32_t i, uint32_t) { return queue.push(i) ? 1u : 0u; },
+              [&](uint64_t &sum) {
+                uint64_t value = 0;
+                if (!queue.pop(value)) { return 0u; }
+                sum += value;
+                return 1u;
+              });
+    });
+    const std::string batchName = "batch" + suffix;
+    state.measure(batchName.c_str(), operations, [&] {
+      SirMetal::MpmcQueue<uint64_t> queue(QUEUE_CAPACITY);
+      runPairs(
+              pairCount,
+              [&](const uint32_t i, const uint32_t left) { return pushBatch(queue, i, left); },
+              [&](uint64_t &sum) { return popBatch(queue, sum); });
+    });
+  }
+}
@@ -0,0 +1,67 @@
+#include "SirMetal/core/memory/cpu/densePool.h"
+#include "SirMetal/core/memory/cpu/slotMap.h"
+#include "benchmark.h"
+
+#include <vector>
+
+// a system updating every live object once a frame, the pool was half
+// emptied at random so the slot map walks over holes
+static constexpr uint32_t OBJECT_COUNT = 1u << 16;
+
+struct Particle {
+  float position[3];
+  float velocity[3];
+};
+
+SM_BENCHMARK(DensePool) {
+  SirMetal::DensePool<Particle> densePool(OBJECT_COUNT);
+  SirMetal::SlotMap<Particle, SirMetal::TextureHandle> slotMap(OBJECT_COUNT);
+  std::vector<SirMetal::DensePoolHandle> denseHandles;
+  std::vector<SirMetal::TextureHandle> slotHandles;
+  for (uint32_t i = 0; i < OBJECT_COUNT; ++i) {
+    const Particle particle{{0, 0, 0}, {1, 2, 3}};
+    denseHandles.push_back(densePool.insert(particle));
+    slotHandles.push_back(slotMap.insert(particle));
+  }
+  SirMetal::benchmark::Random random(3);
+  for (uint32_t i = 0; i < OBJECT_COUNT / 2; ++i) {
+    const uint32_t slot = random.next() % OBJECT_COUNT;
+    densePool.remove(denseHandles[slot]);
+    slotMap.remove(slotHandles[slot]);
+  }
+  const uint32_t liveCount = densePool.size();
+
+  auto update = [](Particle &particle) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      particle.position[axis] += particle.velocity[axis] * 0.016f;
+    }
+  };
+  state.measure("iterateDensePool", liveCount, [&] {
+    Particle *particles = densePool.data();
+    const uint32_t count = densePool.size();
+    for (uint32_t i = 0; i < count; ++i) { update(particles[i]); }
+    SirMetal::benchmark::doNotOptimize(particles[0].position[0]);
+  });
+  state.measure("iterateSlotMap", liveCount, [&] {
+    slotMap.forEach([&](SirMetal::TextureHandle, Particle &particle) { update(particle); });
+  });
+
+  // every live handle once, shuffled
+  std::vector<SirMetal::DensePoolHandle> order(liveCount);
+  for (uint32_t i = 0; i < liveCount; ++i) { order[i] = densePool.getHandle(i); }
+  for (uint32_t i = liveCount - 1; i > 0; --i) { std::swap(order[i], order[random.next() % (i + 1)]); }
+  state.measure("get", liveCount, [&] {
+    float sum = 0;
+    for (const SirMetal::DensePoolHandle handle : order) {
+      sum += densePool.get(handle)->velocity[0];
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  state.measure("removeInsert", liveCount, [&] {
+    for (uint32_t i = 0; i < liveCount; ++i) {
+      const Particle particle = *densePool.get(order[i]);
+      densePool.remove(order[i]);
+      order[i] = densePool.insert(particle);
+    }
+  });
+}
@@ -0,0 +1,323 @@
+#include "SirMetal/core/hashing/hashing.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/stringHashMap.h"
+#include "benchmark.h"
+
+#include <memory>
+#include <string>
+
+using IntMap = SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32>;
+
+static constexpr uint32_t HASH_MAP_BINS = 1u << 16;
+// the map grows past 75%, higher loads are not reachable anymore
+static constexpr uint32_t LOAD_FACTORS_PERCENT[] = {25, 50, 75};
+
+static std::vector<uint32_t> generateUniqueKeys(const uint32_t count, uint64_t seed) {
+  // odd multiplier is a bijection on 32 bits, keys are unique and well spread
+  SirMetal::benchmark::Random random(seed);
+  const uint32_t offset = random.next();
+  std::vector<uint32_t> keys(count);
+  for (uint32_t i = 0; i < count; ++i) { keys[i] = (i * 2654435761u) ^ offset; }
+  // shuffle such that lookups don't follow insertion order
+  for (uint32_t i = count - 1; i > 0; --i) {
+    std::swap(keys[i], keys[random.next() % (i + 1)]);
+  }
+  return keys;
+}
+
+static void fillMap(IntMap &map, const std::vector<uint32_t> &keys) {
+  for (uint32_t k : keys) { map.insert(k, k); }
+}
+
+SM_BENCHMARK(HashMap) {
+  char name[64];
+  for (uint32_t loadFactor : LOAD_FACTORS_PERCENT) {
+    const uint32_t count = (HASH_MAP_BINS * loadFactor) / 100;
+    const std::vector<uint32_t> keys = generateUniqueKeys(count, 1);
+    // keys in the same space but never inserted
+    const std::vector<uint32_t> missingKeys = generateUniqueKeys(count, 2);
+    std::unique_ptr<IntMap> map;
+
+    snprintf(name, sizeof(name), "insert/load%u", loadFactor);
+    state.measure(
+            name, count, [&] { map = std::make_unique<IntMap>(HASH_MAP_BINS); },
+            [&] { fillMap(*map, keys); });
+
+    map = std::make_unique<IntMap>(HASH_MAP_BINS);
+    fillMap(*map, keys);
+    snprintf(name, sizeof(name), "getHit/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t sum = 0;
+      for (uint32_t k : keys) {
+        uint32_t value;
+        map->get(k, value);
+        sum += value;
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+
+    snprintf(name, sizeof(name), "getMiss/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t found = 0;
+      for (uint32_t k : missingKeys) { found += map->containsKey(k); }
+      SirMetal::benchmark::doNotOptimize(found);
+    });
+
+    snprintf(name, sizeof(name), "remove/load%u", loadFactor);
+    state.measure(
+            name, count,
+            [&] {
+              map = std::make_unique<IntMap>(HASH_MAP_BINS);
+              fillMap(*map, keys);
+            },
+            [&] {
+              for (uint32_t k : keys) { map->remove(k); }
+            });
+
+    // steady state churn, the map stays at the given load while keys come and go
+    snprintf(name, sizeof(name), "churn/load%u", loadFactor);
+    const std::vector<uint32_t> churnKeys = generateUniqueKeys(count, 3);
+    state.measure(
+            name, count * 2,
+            [&] {
+              map = std::make_unique<IntMap>(HASH_MAP_BINS);
+              fillMap(*map, keys);
+            },
+            [&] {
+              for (uint32_t i = 0; i < count; ++i) {
+                map->remove(keys[i]);
+                map->insert(churnKeys[i], i);
+              }
+            });
+    const SirMetal::HashMapStats stats = map->getStats();
+    state.setCounter("deleted", stats.deletedBins);
+    state.setCounter("avgProbe", stats.averageProbeLength);
+
+    // lookups after the churn, tombstones left behind are what would slow them
+    snprintf(name, sizeof(name), "containsAfterChurn/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t found = 0;
+      for (uint32_t k : missingKeys) { found += map->containsKey(k); }
+      SirMetal::benchmark::doNotOptimize(found);
+    });
+  }
+}
+
+// Reference copy of the fixed size map indexing with a modulo, the way HashMap
+// worked before growth and power of two bins were added. Only kept to compare
+// probe lengths and lookup cost against.
+class ModuloIntMap {
+public:
+  explicit ModuloIntMap(const uint32_t bins)
+      : m_keys(bins, 0), m_values(bins, 0), m_used(bins, 0), m_bins(bins) {}
+  bool insert(const uint32_t key, const uint32_t value) {
+    uint32_t bin = SirMetal::hashUint32(key) % m_bins;
+    for (uint32_t i = 0; i < m_bins; ++i) {
+      if (!m_used[bin]) {
+        m_keys[bin] = key;
+        m_values[bin] = value;
+        m_used[bin] = 1;
+        return true;
+      }
+      bin = (bin + 1) % m_bins;
+    }
+    return false;
+  }
+  bool get(const uint32_t key, uint32_t &value) const {
+    uint32_t bin = SirMetal::hashUint32(key) % m_bins;
+    for (uint32_t i = 0; i < m_bins; ++i) {
+      if (!m_used[bin]) { return false; }
+      if (m_keys[bin] == key) {
+        value = m_values[bin];
+        return true;
+      }
+      bin = (bin + 1) % m_bins;
+    }
+    return false;
+  }
+  uint32_t probeLength(const uint32_t bin) const {
+    const uint32_t home = SirMetal::hashUint32(m_keys[bin]) % m_bins;
+    return bin >= home ? bin - home : bin + m_bins - home;
+  }
+  uint32_t binCount() const { return m_bins; }
+  bool isBinUsed(const uint32_t bin) const { return m_used[bin] != 0; }
+
+private:
+  std::vector<uint32_t> m_keys;
+  std::vector<uint32_t> m_values;
+  std::vector<uint8_t> m_used;
+  uint32_t m_bins;
+};
+
+// average and max distance of every stored key from its home bin
+template <typename MAP, typename PROBE>
+static void reportProbeLengths(SirMetal::benchmark::State &state, MAP &map,
+                               PROBE probeLength) {
+  uint64_t total = 0;
+  uint32_t maxProbe = 0;
+  uint32_t used = 0;
+  for (uint32_t bin = 0; bin < map.binCount(); ++bin) {
+    if (!map.isBinUsed(bin)) { continue; }
+    const uint32_t probe = probeLength(bin);
+    total += probe;
+    maxProbe = probe > maxProbe ? probe : maxProbe;
+    ++used;
+  }
+  state.setCounter("avgProbe", used ? static_cast<double>(total) / used : 0.0);
+  state.setCounter("maxProbe", maxProbe);
+  state.setCounter("bins", map.binCount());
+}
+
+// same key sets stored in the old modulo map sized by hand for the target load
+// and in the current map sized through reserve
+SM_BENCHMARK(HashMapProbe) {
+  char name[64];
+  const uint32_t count = 50000;
+  const std::vector<uint32_t> keys = generateUniqueKeys(count, 1);
+  const std::vector<uint32_t> missingKeys = generateUniqueKeys(count, 2);
+  for (uint32_t loadFactor : LOAD_FACTORS_PERCENT) {
+    ModuloIntMap moduloMap((count * 100) / loadFactor);
+    for (uint32_t k : keys) { moduloMap.insert(k, k); }
+    IntMap map(16);
+    map.reserve(count);
+    fillMap(map, keys);
+
+    snprintf(name, sizeof(name), "moduloGetHit/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t sum = 0;
+      for (uint32_t k : keys) {
+        uint32_t value = 0;
+        moduloMap.get(k, value);
+        sum += value;
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+    reportProbeLengths(state, moduloMap,
+                       [&](uint32_t bin) { return moduloMap.probeLength(bin); });
+
+    snprintf(name, sizeof(name), "moduloGetMiss/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t found = 0;
+      for (uint32_t k : missingKeys) {
+        uint32_t value;
+        found += moduloMap.get(k, value);
+      }
+      SirMetal::benchmark::doNotOptimize(found);
+    });
+
+    snprintf(name, sizeof(name), "maskGetHit/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t sum = 0;
+      for (uint32_t k : keys) {
+        uint32_t value = 0;
+        map.get(k, value);
+        sum += value;
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+    reportProbeLengths(state, map, [&](uint32_t bin) { return map.probeLength(bin); });
+
+    snprintf(name, sizeof(name), "maskGetMiss/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t found = 0;
+      for (uint32_t k : missingKeys) { found += map.containsKey(k); }
+      SirMetal::benchmark::doNotOptimize(found);
+    });
+  }
+}
+
+// table well past the last level cache, every lookup is a cache miss. The
+// single gets pay them one after the other, the batch overlaps them
+SM_BENCHMARK(HashMapBatch) {
+  const uint32_t tableKeys = 1u << 22;
+  const uint32_t lookups = 1u << 20;
+  const std::vector<uint32_t> keys = generateUniqueKeys(tableKeys, 1);
+  IntMap map(16);
+  map.reserve(tableKeys);
+  fillMap(map, keys);
+
+  // half hits half misses, in random order
+  SirMetal::benchmark::Random random(7);
+  std::vector<uint32_t> lookupKeys(lookups);
+  for (uint32_t i = 0; i < lookups; ++i) {
+    lookupKeys[i] = (i & 1) ? keys[random.range(0, tableKeys)] : random.next();
+  }
+  std::vector<uint32_t> values(lookups);
+  std::unique_ptr<bool[]> found(new bool[lookups]);
+
+  state.measure("singleGet", lookups, [&] {
+    for (uint32_t i = 0; i < lookups; ++i) {
+      found[i] = map.get(lookupKeys[i], values[i]);
+    }
+    SirMetal::benchmark::doNotOptimize(values[lookups - 1]);
+  });
+  state.setCounter("tableMB",
+                   (map.binCount() * (sizeof(uint32_t) * 2 + 1)) / (1024.0 * 1024.0));
+  state.measure("getBatch", lookups, [&] {
+    map.getBatch(lookupKeys.data(), values.data(), found.get(), lookups);
+    SirMetal::benchmark::doNotOptimize(values[lookups - 1]);
+  });
+  // what a per frame resolve of a few hundred handles looks like
+  const uint32_t frameBatch = 256;
+  state.measure("getBatch256", lookups, [&] {
+    for (uint32_t i = 0; i < lookups; i += frameBatch) {
+      map.getBatch(lookupKeys.data() + i, values.data() + i, found.get() + i, frameBatch);
+    }
+    SirMetal::benchmark::doNotOptimize(values[lookups - 1]);
+  });
+}
+
+// resource style names, lots of keys sharing a long prefix is the worst case
+// for a strcmp per probed bin
+SM_BENCHMARK(StringHashMap) {
+  using StringMap = SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32>;
+  SirMetal::StringPool pool(64 * 1024 * 1024);
+  SirMetal::globals::STRING_POOL = &pool;
+  char name[64];
+  const uint32_t count = 20000;
+  std::vector<std::string> keys(count);
+  std::vector<std::string> missingKeys(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    keys[i] = "resources/meshes/environment/props/mesh_" + std::to_string(i);
+    missingKeys[i] = "resources/meshes/environment/props/mesh_" + std::to_string(i + count);
+  }
+  std::vector<uint32_t> hashes(count);
+  for (uint32_t i = 0; i < count; ++i) { hashes[i] = SirMetal::hashString32(keys[i].c_str()); }
+
+  for (uint32_t loadFactor : LOAD_FACTORS_PERCENT) {
+    const uint32_t bins = (count * 100) / loadFactor;
+    StringMap map(bins);
+    for (uint32_t i = 0; i < count; ++i) { map.insert(keys[i].c_str(), i); }
+
+    snprintf(name, sizeof(name), "getHit/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t sum = 0;
+      for (const std::string &k : keys) {
+        uint32_t value = 0;
+        map.get(k.c_str(), value);
+        sum += value;
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+    reportProbeLengths(state, map, [&](uint32_t bin) { return map.probeLength(bin); });
+
+    snprintf(name, sizeof(name), "getMiss/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t found = 0;
+      for (const std::string &k : missingKeys) { found += map.containsKey(k.c_str()); }
+      SirMetal::benchmark::doNotOptimize(found);
+    });
+
+    // callers keeping the hash of the names they look up every frame
+    snprintf(name, sizeof(name), "findPrecomputed/load%u", loadFactor);
+    state.measure(name, count, [&] {
+      uint32_t sum = 0;
+      for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t *value = map.find(keys[i].c_str(), hashes[i]);
+        sum += value != nullptr ? *value : 0;
+      }
+      SirMetal::benchmark::doNotOptimize(sum);
+    });
+  }
+  SirMetal::globals::STRING_POOL = nullptr;
+}
@@ -0,0 +1,83 @@
+#include "SirMetal/core/jobs/jobSystem.h"
+#include "benchmark.h"
+
+#include <atomic>
+#include <math.h>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t WORKER_COUNTS[] = {0, 1, 3, 7};
+static constexpr uint32_t EMPTY_JOBS = 10000;
+static constexpr uint32_t ELEMENT_COUNT = 1u << 20;
+
+// what a loader does per corner, a gather and a bit of math
+static void transformRange(const float *input, float *output, const uint32_t begin,
+                           const uint32_t end) {
+  for (uint32_t i = begin; i < end; ++i) { output[i] = sqrtf(input[i] * input[i] + 1.0f) * 0.5f; }
+}
+
+// the cost of a job itself, push, pop or steal and the group count
+SM_BENCHMARK(JobSystemOverhead) {
+  for (const uint32_t workerCount : WORKER_COUNTS) {
+    SirMetal::JobSystem jobSystem;
+    jobSystem.initialize(workerCount);
+    const std::string suffix = "/" + std::to_string(workerCount) + "workers";
+    std::atomic<uint32_t> counter{0};
+
+    const std::string emptyName = "emptyJobs" + suffix;
+    state.measure(emptyName.c_str(), EMPTY_JOBS, [&] {
+      SirMetal::TaskGroup group;
+      for (uint32_t i = 0; i < EMPTY_JOBS; ++i) {
+        jobSystem.run(group, [&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+      jobSystem.wait(group);
+    });
+    // a chain of dependent groups, every stage parked until the previous one
+    // is done
+    const std::string chainName = "dependencyChain" + suffix;
+    state.measure(chainName.c_str(), 64 * 16, [&] {
+      SirMetal::TaskGroup stages[64];
+      for (uint32_t j = 0; j < 16; ++j) {
+        jobSystem.run(stages[0], [&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+      }
+      for (uint32_t s = 1; s < 64; ++s) {
+        for (uint32_t j = 0; j < 16; ++j) {
+          jobSystem.runAfter(stages[s - 1], stages[s],
+                             [&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+      }
+      jobSystem.wait(stages[63]);
+    });
+    SirMetal::benchmark::doNotOptimize(counter.load());
+    jobSystem.cleanup();
+  }
+}
+
+// a flat loop against the same loop split over the threads
+SM_BENCHMARK(JobSystemParallelFor) {
+  std::vector<float> input(ELEMENT_COUNT);
+  std::vector<float> output(ELEMENT_COUNT);
+  SirMetal::benchmark::Random random(42);
+  for (float &value : input) { value = static_cast<float>(random.range(0, 1000)); }
+
+  state.measure("serial", ELEMENT_COUNT, [&] {
+    transformRange(input.data(), output.data(), 0, ELEMENT_COUNT);
+    SirMetal::benchmark::doNotOptimize(output.data());
+  });
+  const uint32_t grains[] = {0, 256, 16 * 1024};
+  for (const uint32_t workerCount : WORKER_COUNTS) {
+    SirMetal::JobSystem jobSystem;
+    jobSystem.initialize(workerCount);
+    for (const uint32_t grain : grains) {
+      const std::string name = "parallelFor/" + std::to_string(workerCount) + "workers/grain" +
+                               (grain == 0 ? std::string("Auto") : std::to_string(grain));
+      state.measure(name.c_str(), ELEMENT_COUNT, [&] {
+        jobSystem.parallelFor(ELEMENT_COUNT, grain, [&](const uint32_t begin, const uint32_t end) {
+          transformRange(input.data(), output.data(), begin, end);
+        });
+        SirMetal::benchmark::doNotOptimize(output.data());
+      });
+    }
+    jobSystem.cleanup();
+  }
+}
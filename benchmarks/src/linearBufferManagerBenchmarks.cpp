@@ -0,0 +1,65 @@
+#include "SirMetal/core/core.h"
+#include "SirMetal/core/memory/cpu/linearBufferManager.h"
+#include "SirMetal/core/memory/cpu/offsetAllocator.h"
+#include "benchmark.h"
+
+#include <memory>
+
+static constexpr uint32_t ALLOCATIONS = 16384;
+static constexpr uint32_t CHURN_OPERATIONS = 20000;
+
+// same workload on both trackers, they share the handle and range types
+template <typename MANAGER>
+static void runBufferTracker(SirMetal::benchmark::State &state) {
+  std::unique_ptr<MANAGER> manager;
+  std::vector<SirMetal::BufferRangeHandle> handles(ALLOCATIONS);
+  std::vector<uint32_t> sizes(ALLOCATIONS);
+  std::vector<uint32_t> slots(CHURN_OPERATIONS);
+  SirMetal::benchmark::Random random;
+  for (uint32_t &size : sizes) { size = random.range(256, 64 * 1024); }
+  for (uint32_t &slot : slots) { slot = random.range(0, ALLOCATIONS); }
+  auto setup = [&] { manager = std::make_unique<MANAGER>(2048 * SirMetal::MB_TO_BYTE); };
+  auto allocateAll = [&] {
+    for (uint32_t i = 0; i < ALLOCATIONS; ++i) {
+      handles[i] = manager->allocate(sizes[i], 256);
+    }
+  };
+
+  state.measure("allocate", ALLOCATIONS, setup, allocateAll);
+  state.measure(
+          "free", ALLOCATIONS,
+          [&] {
+            setup();
+            allocateAll();
+          },
+          [&] {
+            for (uint32_t i = 0; i < ALLOCATIONS; ++i) { manager->free(handles[i]); }
+          });
+  // constant buffer style usage, fill up then reset everything
+  state.measure("allocateClear", ALLOCATIONS, setup, [&] {
+    allocateAll();
+    manager->clear();
+  });
+  // buffers streamed in and out, a random one is freed and a new size takes
+  // its place
+  state.measure(
+          "churn", CHURN_OPERATIONS * 2,
+          [&] {
+            setup();
+            allocateAll();
+          },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              const uint32_t slot = slots[i];
+              if (handles[slot].isHandleValid()) { manager->free(handles[slot]); }
+              handles[slot] = manager->allocate(sizes[(slot + i) % ALLOCATIONS], 256);
+            }
+          });
+  uint32_t failed = 0;
+  for (const SirMetal::BufferRangeHandle handle : handles) { failed += !handle.isHandleValid(); }
+  state.setCounter("failedAllocations", failed);
+}
+
+SM_BENCHMARK(LinearBufferManager) { runBufferTracker<SirMetal::LinearBufferManager>(state); }
+
+SM_BENCHMARK(OffsetAllocator) { runBufferTracker<SirMetal::OffsetAllocator>(state); }
@@ -0,0 +1,81 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// usage: benchmarks [--filter substring] [--repetitions N] [--json path]
+int main(int argc, char *argv[]) {
+  const char *filter = nullptr;
+  const char *jsonPath = nullptr;
+  uint32_t repetitions = 9;
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = (i + 1) < argc;
+    if ((strcmp(argv[i], "--filter") == 0) & hasValue) {
+      filter = argv[++i];
+    } else if ((strcmp(argv[i], "--json") == 0) & hasValue) {
+      jsonPath = argv[++i];
+    } else if ((strcmp(argv[i], "--repetitions") == 0) & hasValue) {
+      repetitions = static_cast<uint32_t>(atoi(argv[++i]));
+      repetitions = repetitions == 0 ? 1 : repetitions;
+    } else {
+      printf("usage: %s [--filter substring] [--repetitions N] [--json path]\n",
+             argv[0]);
+      return 1;
+    }
+  }
+
+  SirMetal::benchmark::CacheMissCounter counter;
+  if (!counter.isAvailable()) {
+    printf("[WARN] hardware cache miss counters not available, not reporting them\n");
+  }
+
+  std::vector<SirMetal::benchmark::Result> results;
+  printf("%-60s %12s %12s %16s %12s\n", "benchmark", "ns/op", "min ns/op", "ops/s",
+         "misses/op");
+  for (const auto &registered : SirMetal::benchmark::getRegisteredBenchmarks()) {
+    if ((filter != nullptr) && (strstr(registered.name, filter) == nullptr)) {
+      continue;
+    }
+    SirMetal::benchmark::State state(registered.name, repetitions, &counter);
+    registered.function(state);
+    for (const auto &result : state.getResults()) {
+      char misses[32] = "n/a";
+      if (result.cacheMissesPerOp >= 0.0) {
+        snprintf(misses, sizeof(misses), "%.3f", result.cacheMissesPerOp);
+      }
+      printf("%-60s %12.2f %12.2f %16.0f %12s", result.name.c_str(), result.nsPerOp,
+             result.nsPerOpMin, result.opsPerSecond, misses);
+      for (const auto &c : result.counters) { printf("  %s=%.3f", c.first.c_str(), c.second); }
+      printf("\n");
+      results.push_back(result);
+    }
+  }
+
+  if (jsonPath == nullptr) { return 0; }
+  FILE *fp = fopen(jsonPath, "w");
+  if (fp == nullptr) {
+    printf("[Error] Could not open file %s for writing\n", jsonPath);
+    return 1;
+  }
+  fprintf(fp, "{\n  \"repetitions\": %u,\n  \"cacheMissesAvailable\": %s,\n", repetitions,
+          counter.isAvailable() ? "true" : "false");
+  fprintf(fp, "  \"benchmarks\": [\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto &r = results[i];
+    fprintf(fp,
+            "    {\"name\": \"%s\", \"ops\": %llu, \"nsPerOp\": %.4f, "
+            "\"nsPerOpMin\": %.4f, \"opsPerSecond\": %.1f, "
+            "\"cacheMissesPerOp\": %.4f, \"counters\": {",
+            r.name.c_str(), static_cast<unsigned long long>(r.opCount), r.nsPerOp,
+            r.nsPerOpMin, r.opsPerSecond, r.cacheMissesPerOp);
+    for (size_t c = 0; c < r.counters.size(); ++c) {
+      fprintf(fp, "%s\"%s\": %.4f", c == 0 ? "" : ", ", r.counters[c].first.c_str(),
+              r.counters[c].second);
+    }
+    fprintf(fp, "}}%s\n", (i + 1) < results.size() ? "," : "");
+  }
+  fprintf(fp, "  ]\n}\n");
+  fclose(fp);
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include "SirMetal/resources/meshes/meshCache.h"
+#include "SirMetal/resources/meshes/vertexStreams.h"
+#include "benchmark.h"
+
+#include <filesystem>
+#include <string>
+
+// a warm start, the cooked mesh is mapped and read once as the upload would
+static constexpr uint32_t VERTEX_COUNT = 1u << 18;
+
+SM_BENCHMARK(MeshCache) {
+  SirMetal::MeshLoadResult mesh;
+  mesh.name = "benchmarkMesh";
+  mesh.vertices.resize(SirMetal::computeVertexBlobLayout(VERTEX_COUNT, 4, mesh.ranges));
+  SirMetal::benchmark::Random random(11);
+  for (float &value : mesh.vertices) { value = static_cast<float>(random.range(0, 1000)); }
+  for (uint32_t i = 0; i < VERTEX_COUNT * 3; ++i) {
+    mesh.indices.push_back(random.next() % VERTEX_COUNT);
+  }
+
+  const std::string folder =
+          (std::filesystem::temp_directory_path() / "sirMetalMeshCacheBenchmarks").string();
+  const std::string path = SirMetal::getMeshCachePath(folder, 1);
+
+  state.measure("write", VERTEX_COUNT, [&] {
+    SirMetal::benchmark::doNotOptimize(SirMetal::writeMeshCache(path.c_str(), 1, mesh));
+  });
+  // touches a float per page, what the GPU copy costs on top of the mapping
+  state.measure("openAndRead", VERTEX_COUNT, [&] {
+    SirMetal::CachedMesh cached;
+    cached.open(path.c_str(), 1);
+    const float *vertices = cached.getVertices();
+    float sum = 0.0f;
+    for (uint64_t i = 0; i < cached.getVertexSizeInBytes() / sizeof(float); i += 1024) {
+      sum += vertices[i];
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  std::filesystem::remove_all(folder);
+}
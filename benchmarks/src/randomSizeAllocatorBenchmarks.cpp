@@ -0,0 +1,46 @@
+#include "SirMetal/core/memory/cpu/randomSizeAllocator.h"
+#include "benchmark.h"
+
+#include <memory>
+
+static constexpr uint32_t ALLOCATOR_SIZE_IN_BYTES = 64u * 1024u * 1024u;
+static constexpr uint32_t LIVE_ALLOCATIONS = 2048;
+static constexpr uint32_t CHURN_OPERATIONS = 20000;
+
+SM_BENCHMARK(RandomSizeAllocator) {
+  std::unique_ptr<SirMetal::RandomSizeAllocator> alloc;
+  std::vector<SirMetal::RandomSizeAllocationHandle> live(LIVE_ALLOCATIONS);
+  std::vector<uint32_t> sizes(CHURN_OPERATIONS);
+  std::vector<uint32_t> slots(CHURN_OPERATIONS);
+  SirMetal::benchmark::Random random;
+  for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+    sizes[i] = random.range(16, 1024);
+    slots[i] = random.range(0, LIVE_ALLOCATIONS);
+  }
+  auto setup = [&] {
+    alloc = std::make_unique<SirMetal::RandomSizeAllocator>();
+    alloc->initialize(ALLOCATOR_SIZE_IN_BYTES);
+  };
+
+  state.measure("allocate", LIVE_ALLOCATIONS, setup, [&] {
+    for (uint32_t i = 0; i < LIVE_ALLOCATIONS; ++i) { live[i] = alloc->allocate(sizes[i]); }
+  });
+
+  state.measure(
+          "churn", CHURN_OPERATIONS * 2,
+          [&] {
+            setup();
+            for (uint32_t i = 0; i < LIVE_ALLOCATIONS; ++i) {
+              live[i] = alloc->allocate(sizes[i]);
+            }
+          },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              const uint32_t slot = slots[i];
+              alloc->freeAllocation(live[slot]);
+              live[slot] = alloc->allocate(sizes[i]);
+            }
+          });
+  state.setCounter("freeBlocks", static_cast<double>(alloc->getFreeBlocksCount()));
+  state.setCounter("freeKB", static_cast<double>(alloc->getFreeBytes()) / 1024);
+}
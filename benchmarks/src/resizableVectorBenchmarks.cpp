@@ -0,0 +1,54 @@
+#include "SirMetal/core/memory/cpu/containerAllocators.h"
+#include "SirMetal/core/memory/cpu/resizableVector.h"
+#include "benchmark.h"
+
+#include <memory>
+
+static constexpr uint32_t ELEMENTS = 1u << 20;
+
+struct FatElement {
+  float values[16];
+};
+
+SM_BENCHMARK(ResizableVector) {
+  std::unique_ptr<SirMetal::ResizableVector<float>> vec;
+  state.measure(
+          "pushBackGrow", ELEMENTS,
+          [&] { vec = std::make_unique<SirMetal::ResizableVector<float>>(16); },
+          [&] {
+            for (uint32_t i = 0; i < ELEMENTS; ++i) { vec->pushBack(static_cast<float>(i)); }
+          });
+  state.measure(
+          "pushBackReserved", ELEMENTS,
+          [&] { vec = std::make_unique<SirMetal::ResizableVector<float>>(ELEMENTS); },
+          [&] {
+            for (uint32_t i = 0; i < ELEMENTS; ++i) { vec->pushBack(static_cast<float>(i)); }
+          });
+
+  std::unique_ptr<SirMetal::ResizableVector<FatElement>> fatVec;
+  const FatElement element{};
+  state.measure(
+          "pushBackGrowFat", ELEMENTS / 16,
+          [&] { fatVec = std::make_unique<SirMetal::ResizableVector<FatElement>>(16); },
+          [&] {
+            for (uint32_t i = 0; i < ELEMENTS / 16; ++i) { fatVec->pushBack(element); }
+          });
+
+  // per frame scratch vectors, grown from frame memory instead of the heap
+  SirMetal::StackAllocator stack;
+  stack.initialize(64 * 1024 * 1024);
+  SirMetal::StackAllocatorAdapter frame(&stack);
+  using FrameVector = SirMetal::ResizableVector<float, SirMetal::StackAllocatorAdapter>;
+  std::unique_ptr<FrameVector> frameVec;
+  state.measure(
+          "pushBackGrowFrameMemory", ELEMENTS,
+          [&] {
+            frameVec.reset();
+            stack.reset();
+            frameVec = std::make_unique<FrameVector>(16, &frame);
+          },
+          [&] {
+            for (uint32_t i = 0; i < ELEMENTS; ++i) { frameVec->pushBack(static_cast<float>(i)); }
+          });
+  frameVec.reset();
+}
@@ -0,0 +1,28 @@
+#include "SirMetal/core/memory/cpu/overridingRingBuffer.h"
+#include "SirMetal/core/memory/cpu/ringBuffer.h"
+#include "benchmark.h"
+
+static constexpr int RING_SIZE = 1000;
+static constexpr uint32_t OPERATIONS = 1000000;
+static constexpr uint32_t BATCH = 64;
+
+SM_BENCHMARK(RingBuffer) {
+  SirMetal::RingBuffer<uint64_t> ring(RING_SIZE);
+  // producer pushes a batch, consumer drains it, as a queue between systems
+  state.measure("pushPopBatch", OPERATIONS * 2, [&] {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < OPERATIONS; i += BATCH) {
+      for (uint32_t b = 0; b < BATCH; ++b) { ring.push(i + b); }
+      for (uint32_t b = 0; b < BATCH; ++b) { sum += ring.pop(); }
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+}
+
+SM_BENCHMARK(OverridingRingBuffer) {
+  SirMetal::OverridingRingBuffer<uint64_t> ring(RING_SIZE);
+  state.measure("push", OPERATIONS, [&] {
+    for (uint32_t i = 0; i < OPERATIONS; ++i) { ring.push(i); }
+    SirMetal::benchmark::doNotOptimize(ring.back());
+  });
+}
@@ -0,0 +1,57 @@
+#include "SirMetal/core/memory/cpu/slotMap.h"
+#include "benchmark.h"
+
+#include <unordered_map>
+#include <vector>
+
+// resource handles looked up every draw, the managers used to keep their data
+// in an unordered_map keyed by the handle index
+static constexpr uint32_t RESOURCE_COUNT = 4096;
+static constexpr uint32_t LOOKUPS = 1u << 20;
+
+struct Resource {
+  void *native;
+  uint32_t size;
+  uint32_t flags;
+};
+
+SM_BENCHMARK(SlotMap) {
+  SirMetal::SlotMap<Resource, SirMetal::TextureHandle> slotMap;
+  std::unordered_map<uint32_t, Resource> unorderedMap;
+  std::vector<SirMetal::TextureHandle> handles;
+  for (uint32_t i = 0; i < RESOURCE_COUNT; ++i) {
+    const Resource resource{nullptr, i, 0};
+    handles.push_back(slotMap.insert(resource));
+    unorderedMap[SirMetal::getIndexFromHandle(handles.back())] = resource;
+  }
+  // random draw order over the live resources
+  SirMetal::benchmark::Random random(1);
+  std::vector<SirMetal::TextureHandle> order(LOOKUPS);
+  for (auto &handle : order) { handle = handles[random.next() % RESOURCE_COUNT]; }
+
+  state.measure("getSlotMap", LOOKUPS, [&] {
+    uint32_t sum = 0;
+    for (const SirMetal::TextureHandle handle : order) {
+      const Resource *found = slotMap.get(handle);
+      sum += found != nullptr ? found->size : 0;
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  state.measure("getUnorderedMap", LOOKUPS, [&] {
+    uint32_t sum = 0;
+    for (const SirMetal::TextureHandle handle : order) {
+      auto found = unorderedMap.find(SirMetal::getIndexFromHandle(handle));
+      sum += found != unorderedMap.end() ? found->second.size : 0;
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+
+  // steady state churn, resources streamed in and out
+  state.measure("removeInsert", LOOKUPS, [&] {
+    for (uint32_t i = 0; i < LOOKUPS; ++i) {
+      const uint32_t slot = i % RESOURCE_COUNT;
+      slotMap.remove(handles[slot]);
+      handles[slot] = slotMap.insert(Resource{nullptr, i, 0});
+    }
+  });
+}
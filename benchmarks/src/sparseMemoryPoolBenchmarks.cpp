@@ -0,0 +1,57 @@
+#include "SirMetal/core/memory/cpu/sparseMemoryPool.h"
+#include "benchmark.h"
+
+#include <memory>
+
+struct PoolItem {
+  uint32_t values[4];
+};
+
+static constexpr uint32_t POOL_SIZE = 1u << 16;
+static constexpr uint32_t LARGE_POOL_SIZE = 1u << 22;
+static constexpr uint32_t CHURN_OPERATIONS = 100000;
+
+SM_BENCHMARK(SparseMemoryPool) {
+  std::unique_ptr<SirMetal::SparseMemoryPool<PoolItem>> pool;
+  std::vector<uint32_t> live(POOL_SIZE / 2);
+  std::vector<uint32_t> slots(CHURN_OPERATIONS);
+  SirMetal::benchmark::Random random;
+  for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+    slots[i] = random.range(0, POOL_SIZE / 2);
+  }
+
+  state.measure(
+          "allocate", POOL_SIZE,
+          [&] { pool = std::make_unique<SirMetal::SparseMemoryPool<PoolItem>>(POOL_SIZE); },
+          [&] {
+            for (uint32_t i = 0; i < POOL_SIZE; ++i) {
+              uint32_t index;
+              pool->getFreeMemoryData(index).values[0] = i;
+            }
+          });
+
+  state.measure(
+          "churn", CHURN_OPERATIONS * 2,
+          [&] {
+            pool = std::make_unique<SirMetal::SparseMemoryPool<PoolItem>>(POOL_SIZE);
+            for (uint32_t &index : live) { pool->getFreeMemoryData(index); }
+          },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              const uint32_t slot = slots[i];
+              pool->free(live[slot]);
+              pool->getFreeMemoryData(live[slot]).values[0] = i;
+            }
+          });
+
+  // level reset on a big pool, a quarter of it was used
+  state.measure("constructLarge", 1, [&] {
+    pool.reset();
+    pool = std::make_unique<SirMetal::SparseMemoryPool<PoolItem>>(LARGE_POOL_SIZE);
+  });
+  for (uint32_t i = 0; i < LARGE_POOL_SIZE / 4; ++i) {
+    uint32_t index;
+    pool->getFreeMemoryData(index);
+  }
+  state.measure("clearLarge", 1, [&] { pool->clear(); });
+}
@@ -0,0 +1,61 @@
+#include "SirMetal/core/hashing/stringId.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "benchmark.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace SirMetal::literals;
+
+// shader names looked up once per draw when building the PSO key
+static constexpr uint32_t LOOKUPS = 1u << 20;
+static constexpr uint32_t SHADER_COUNT = 64;
+
+SM_BENCHMARK(StringId) {
+  std::vector<std::string> names(SHADER_COUNT);
+  std::vector<SirMetal::StringId> ids(SHADER_COUNT);
+  SirMetal::HashMap<SirMetal::StringId, uint32_t, SirMetal::hashStringId> idMap(SHADER_COUNT);
+  for (uint32_t i = 0; i < SHADER_COUNT; ++i) {
+    names[i] = "shaders/passes/deferredLighting_" + std::to_string(i);
+    ids[i] = SirMetal::StringId(names[i].c_str(), names[i].size());
+    idMap.insert(ids[i], i);
+  }
+  SirMetal::benchmark::Random random(1);
+  std::vector<uint32_t> order(LOOKUPS);
+  for (uint32_t &i : order) { i = random.next() % SHADER_COUNT; }
+
+  // what the PSO key used to pay, hashing the material shader name every draw
+  state.measure("stdHashString", LOOKUPS, [&] {
+    std::hash<std::string> hasher;
+    size_t sum = 0;
+    for (uint32_t i : order) { sum += hasher(names[i]); }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  state.measure("hashRuntimeName", LOOKUPS, [&] {
+    uint64_t sum = 0;
+    for (uint32_t i : order) {
+      sum += SirMetal::StringId(names[i].c_str(), names[i].size()).getHash();
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  // material keeps the id, the key only combines the integer
+  state.measure("idLookup", LOOKUPS, [&] {
+    uint32_t sum = 0;
+    for (uint32_t i : order) {
+      uint32_t value = 0;
+      idMap.get(ids[i], value);
+      sum += value;
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+  state.measure("literalLookup", LOOKUPS, [&] {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < LOOKUPS; ++i) {
+      uint32_t value = 0;
+      idMap.get("shaders/passes/deferredLighting_7"_sid, value);
+      sum += value;
+    }
+    SirMetal::benchmark::doNotOptimize(sum);
+  });
+}
@@ -0,0 +1,95 @@
+#include "SirMetal/core/memory/cpu/threadCachingPool.h"
+#include "SirMetal/core/memory/cpu/threeSizesPool.h"
+#include "benchmark.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+static constexpr uint32_t PAGE_SIZE_IN_BYTES = 4u * 1024u * 1024u;
+static constexpr uint32_t LIVE_PER_THREAD = 256;
+static constexpr uint32_t OPERATIONS_PER_THREAD = 100000;
+static constexpr uint32_t THREAD_COUNTS[] = {1, 2, 4, 8, 16, 32};
+
+// what a loading thread does with the string pool, mostly names and paths
+struct ThreadWorkload {
+  std::vector<uint32_t> sizes;
+  std::vector<uint32_t> slots;
+};
+
+static std::vector<ThreadWorkload> generateWorkloads(const uint32_t threadCount) {
+  std::vector<ThreadWorkload> workloads(threadCount);
+  for (uint32_t t = 0; t < threadCount; ++t) {
+    SirMetal::benchmark::Random random(t + 1);
+    workloads[t].sizes.resize(OPERATIONS_PER_THREAD);
+    workloads[t].slots.resize(OPERATIONS_PER_THREAD);
+    for (uint32_t i = 0; i < OPERATIONS_PER_THREAD; ++i) {
+      workloads[t].sizes[i] =
+              random.range(0, 10) < 8 ? random.range(5, 65) : random.range(64, 512);
+      workloads[t].slots[i] = random.range(0, LIVE_PER_THREAD);
+    }
+  }
+  return workloads;
+}
+
+// every thread frees a random live block and allocates a new one in its place
+template <typename ALLOCATE, typename FREE>
+static void runThreads(const std::vector<ThreadWorkload> &workloads, ALLOCATE allocate,
+                       FREE free) {
+  std::vector<std::thread> threads;
+  threads.reserve(workloads.size());
+  for (const ThreadWorkload &workload : workloads) {
+    threads.emplace_back([&workload, &allocate, &free] {
+      void *live[LIVE_PER_THREAD] = {};
+      for (uint32_t i = 0; i < OPERATIONS_PER_THREAD; ++i) {
+        const uint32_t slot = workload.slots[i];
+        if (live[slot] != nullptr) { free(live[slot]); }
+        live[slot] = allocate(workload.sizes[i]);
+      }
+      for (void *memory : live) {
+        if (memory != nullptr) { free(memory); }
+      }
+    });
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+}
+
+SM_BENCHMARK(ThreadCachingPoolScaling) {
+  for (const uint32_t threadCount : THREAD_COUNTS) {
+    const std::vector<ThreadWorkload> workloads = generateWorkloads(threadCount);
+    const uint64_t operations = static_cast<uint64_t>(threadCount) * OPERATIONS_PER_THREAD * 2;
+
+    // what we had to do before, the whole pool behind one lock
+    std::unique_ptr<SirMetal::ThreeSizesPool> pool;
+    std::mutex mutex;
+    const std::string lockedName = "locked/" + std::to_string(threadCount) + "threads";
+    state.measure(
+            lockedName.c_str(), operations,
+            [&] { pool = std::make_unique<SirMetal::ThreeSizesPool>(PAGE_SIZE_IN_BYTES); },
+            [&] {
+              runThreads(
+                      workloads,
+                      [&](uint32_t size) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        return pool->allocate(size);
+                      },
+                      [&](void *memory) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        pool->free(memory);
+                      });
+            });
+
+    std::unique_ptr<SirMetal::ThreadCachingPool> cachingPool;
+    const std::string cachedName = "cached/" + std::to_string(threadCount) + "threads";
+    state.measure(
+            cachedName.c_str(), operations,
+            [&] { cachingPool = std::make_unique<SirMetal::ThreadCachingPool>(PAGE_SIZE_IN_BYTES); },
+            [&] {
+              runThreads(
+                      workloads, [&](uint32_t size) { return cachingPool->allocate(size); },
+                      [&](void *memory) { cachingPool->free(memory); });
+            });
+    state.setCounter("threadCaches", cachingPool->getThreadCacheCount());
+  }
+}
@@ -0,0 +1,100 @@
+#include "SirMetal/core/memory/cpu/stringPool.h"
+#include "SirMetal/core/memory/cpu/threeSizesPool.h"
+#include "benchmark.h"
+
+#include <memory>
+#include <string>
+
+static constexpr uint32_t POOL_SIZE_IN_BYTES = 64u * 1024u * 1024u;
+static constexpr uint32_t LIVE_ALLOCATIONS = 4096;
+static constexpr uint32_t CHURN_OPERATIONS = 100000;
+
+// mix roughly matching what the engine does with the pool, mostly short names,
+// some paths and the occasional big blob
+static uint32_t randomAllocationSize(SirMetal::benchmark::Random &random) {
+  const uint32_t bucket = random.range(0, 100);
+  if (bucket < 70) { return random.range(4, 64); }
+  if (bucket < 95) { return random.range(64, 256); }
+  return random.range(256, 4096);
+}
+
+SM_BENCHMARK(ThreeSizesPool) {
+  std::unique_ptr<SirMetal::ThreeSizesPool> pool;
+  std::vector<void *> live(LIVE_ALLOCATIONS);
+  std::vector<uint32_t> sizes(CHURN_OPERATIONS);
+  std::vector<uint32_t> slots(CHURN_OPERATIONS);
+  SirMetal::benchmark::Random random;
+  for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+    sizes[i] = randomAllocationSize(random);
+    slots[i] = random.range(0, LIVE_ALLOCATIONS);
+  }
+
+  state.measure(
+          "allocate", LIVE_ALLOCATIONS,
+          [&] { pool = std::make_unique<SirMetal::ThreeSizesPool>(POOL_SIZE_IN_BYTES); },
+          [&] {
+            for (uint32_t i = 0; i < LIVE_ALLOCATIONS; ++i) {
+              live[i] = pool->allocate(sizes[i]);
+            }
+          });
+
+  // free one random live allocation and allocate a new one in its place
+  state.measure(
+          "churn", CHURN_OPERATIONS * 2,
+          [&] {
+            pool = std::make_unique<SirMetal::ThreeSizesPool>(POOL_SIZE_IN_BYTES);
+            for (uint32_t i = 0; i < LIVE_ALLOCATIONS; ++i) {
+              live[i] = pool->allocate(sizes[i]);
+            }
+          },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              const uint32_t slot = slots[i];
+              pool->free(live[slot]);
+              live[slot] = pool->allocate(sizes[i]);
+            }
+          });
+}
+
+SM_BENCHMARK(StringPool) {
+  std::unique_ptr<SirMetal::StringPool> pool;
+  SirMetal::benchmark::Random random;
+  std::vector<std::string> strings(CHURN_OPERATIONS);
+  std::vector<uint32_t> slots(CHURN_OPERATIONS);
+  for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+    const uint32_t len = random.range(4, 128);
+    strings[i].resize(len);
+    for (uint32_t c = 0; c < len; ++c) {
+      strings[i][c] = static_cast<char>('a' + random.range(0, 26));
+    }
+    slots[i] = random.range(0, LIVE_ALLOCATIONS);
+  }
+  std::vector<const char *> live(LIVE_ALLOCATIONS);
+
+  state.measure(
+          "persistentChurn", CHURN_OPERATIONS * 2,
+          [&] {
+            pool = std::make_unique<SirMetal::StringPool>(POOL_SIZE_IN_BYTES);
+            for (uint32_t i = 0; i < LIVE_ALLOCATIONS; ++i) {
+              live[i] = pool->allocatePersistent(strings[i].c_str());
+            }
+          },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              const uint32_t slot = slots[i];
+              pool->free(live[slot]);
+              live[slot] = pool->allocatePersistent(strings[i].c_str());
+            }
+          });
+
+  // per frame usage, a burst of temporary strings followed by a reset
+  state.measure(
+          "frameAllocate", CHURN_OPERATIONS,
+          [&] { pool = std::make_unique<SirMetal::StringPool>(POOL_SIZE_IN_BYTES); },
+          [&] {
+            for (uint32_t i = 0; i < CHURN_OPERATIONS; ++i) {
+              SirMetal::benchmark::doNotOptimize(pool->allocateFrame(strings[i].c_str()));
+            }
+            pool->resetFrameMemory();
+          });
+}
@@ -0,0 +1,112 @@
+#include "SirMetal/core/memory/cpu/threeSizesPool.h"
+#include "SirMetal/core/memory/cpu/tlsfAllocator.h"
+#include "benchmark.h"
+
+#include <memory>
+
+// Replays the allocations the StringPool does over a long session, mostly
+// names, some paths, wide strings and the occasional file loaded in memory,
+// with a live set of strings constantly replaced
+static constexpr uint32_t POOL_SIZE_IN_BYTES = 32u * 1024u * 1024u;
+static constexpr uint32_t POOL_PAGE_SIZE_IN_BYTES = 1024u * 1024u;
+static constexpr uint32_t LIVE_STRINGS = 16384;
+static constexpr uint32_t OPERATIONS = 2000000;
+
+static uint32_t randomStringAllocationSize(SirMetal::benchmark::Random &random) {
+  const uint32_t bucket = random.range(0, 1000);
+  // names, +1 for the terminator
+  if (bucket < 700) { return random.range(4, 64) + 1; }
+  // paths and concatenations
+  if (bucket < 950) { return random.range(32, 256) + 1; }
+  // wide strings
+  if (bucket < 999) { return (random.range(4, 128) + 1) * 4; }
+  // shader or config file loaded persistent
+  return random.range(1024, 64 * 1024);
+}
+
+struct StringWorkload {
+  std::vector<uint32_t> sizes;
+  std::vector<uint32_t> slots;
+};
+
+static StringWorkload generateWorkload() {
+  StringWorkload workload;
+  SirMetal::benchmark::Random random(7);
+  workload.sizes.resize(OPERATIONS);
+  workload.slots.resize(OPERATIONS);
+  for (uint32_t i = 0; i < OPERATIONS; ++i) {
+    workload.sizes[i] = randomStringAllocationSize(random);
+    workload.slots[i] = random.range(0, LIVE_STRINGS);
+  }
+  return workload;
+}
+
+// runs the churn until the end or the first allocation failure, returns the
+// number of operations done. The ThreeSizesPool asserts when it runs out, it
+// is checked before every allocation instead
+template <typename ALLOC_FN, typename FREE_FN>
+static uint32_t replay(const StringWorkload &workload, std::vector<void *> &live,
+                       std::vector<uint32_t> &liveSizes, uint64_t &liveBytes,
+                       ALLOC_FN allocate, FREE_FN free) {
+  liveBytes = 0;
+  for (uint32_t i = 0; i < LIVE_STRINGS; ++i) {
+    live[i] = allocate(workload.sizes[i]);
+    liveSizes[i] = workload.sizes[i];
+    liveBytes += workload.sizes[i];
+  }
+  for (uint32_t i = LIVE_STRINGS; i < OPERATIONS; ++i) {
+    const uint32_t slot = workload.slots[i];
+    free(live[slot]);
+    liveBytes -= liveSizes[slot];
+    void *memory = allocate(workload.sizes[i]);
+    if (memory == nullptr) {
+      live[slot] = nullptr;
+      liveSizes[slot] = 0;
+      return i;
+    }
+    live[slot] = memory;
+    liveSizes[slot] = workload.sizes[i];
+    liveBytes += workload.sizes[i];
+  }
+  return OPERATIONS;
+}
+
+SM_BENCHMARK(StringFragmentation) {
+  const StringWorkload workload = generateWorkload();
+  std::vector<void *> live(LIVE_STRINGS);
+  std::vector<uint32_t> liveSizes(LIVE_STRINGS);
+  uint64_t liveBytes = 0;
+  uint32_t operations = 0;
+
+  // the pool grows a page at the time, it never runs out, what matters is how
+  // much it had to grab to hold the live strings
+  std::unique_ptr<SirMetal::ThreeSizesPool> pool;
+  auto poolAllocate = [&](uint32_t size) { return pool->allocate(size); };
+  auto poolFree = [&](void *memory) {
+    if (memory != nullptr) { pool->free(memory); }
+  };
+  state.measure(
+          "threeSizesPool", OPERATIONS * 2,
+          [&] { pool = std::make_unique<SirMetal::ThreeSizesPool>(POOL_PAGE_SIZE_IN_BYTES); },
+          [&] { operations = replay(workload, live, liveSizes, liveBytes, poolAllocate, poolFree); });
+  const uint64_t poolFootprint = pool->getHighWaterMark() + pool->getBypassBytes();
+  state.setCounter("operationsBeforeOutOfMemory", operations);
+  state.setCounter("liveBytes", static_cast<double>(liveBytes));
+  state.setCounter("pages", pool->getPageCount());
+  state.setCounter("bypassAllocations", pool->getBypassAllocCount());
+  state.setCounter("footprintOverLive", static_cast<double>(poolFootprint) / liveBytes);
+
+  std::unique_ptr<SirMetal::TlsfAllocator> tlsf;
+  auto tlsfAllocate = [&](uint32_t size) { return tlsf->allocate(size); };
+  auto tlsfFree = [&](void *memory) { tlsf->free(memory); };
+  state.measure(
+          "tlsf", OPERATIONS * 2,
+          [&] { tlsf = std::make_unique<SirMetal::TlsfAllocator>(POOL_SIZE_IN_BYTES); },
+          [&] { operations = replay(workload, live, liveSizes, liveBytes, tlsfAllocate, tlsfFree); });
+  const uint32_t tlsfLeft = tlsf->getLargestFreeBlock();
+  state.setCounter("operationsBeforeOutOfMemory", operations);
+  state.setCounter("liveBytes", static_cast<double>(liveBytes));
+  state.setCounter("largestAllocationLeft", tlsfLeft);
+  state.setCounter("footprintOverLive",
+                   static_cast<double>(POOL_SIZE_IN_BYTES - tlsfLeft) / liveBytes);
+}
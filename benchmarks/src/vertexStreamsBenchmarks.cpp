@@ -0,0 +1,75 @@
+#include "SirMetal/resources/meshes/vertexStreams.h"
+#include "benchmark.h"
+
+#include <float.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+// a gltf view interleaving position, normal and uv, what exporters often write
+static constexpr uint32_t VERTEX_COUNT = 1u << 18;
+
+struct InterleavedVertex {
+  float position[3];
+  float normal[3];
+  float uv[2];
+};
+
+SM_BENCHMARK(VertexStreams) {
+  std::vector<InterleavedVertex> source(VERTEX_COUNT);
+  SirMetal::benchmark::Random random(7);
+  for (InterleavedVertex &vertex : source) {
+    for (float &value : vertex.position) { value = static_cast<float>(random.range(0, 1000)); }
+    for (float &value : vertex.normal) { value = static_cast<float>(random.range(0, 1)); }
+    for (float &value : vertex.uv) { value = static_cast<float>(random.range(0, 1)); }
+  }
+  const auto *bytes = reinterpret_cast<const char *>(source.data());
+
+  // a vector per attribute grown a component at a time, a pass for the
+  // bounding box, then merged in the blob
+  state.measure("pushBackThenMerge", VERTEX_COUNT, [&] {
+    std::vector<float> attributes[3];
+    for (uint32_t i = 0; i < VERTEX_COUNT; ++i) {
+      const InterleavedVertex &vertex = source[i];
+      for (uint32_t c = 0; c < 3; ++c) { attributes[0].push_back(vertex.position[c]); }
+      attributes[0].push_back(1.0f);
+      for (uint32_t c = 0; c < 3; ++c) { attributes[1].push_back(vertex.normal[c]); }
+      attributes[1].push_back(0.0f);
+      attributes[2].push_back(vertex.uv[0]);
+      attributes[2].push_back(vertex.uv[1]);
+    }
+    float boundingBox[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t p = 0; p < attributes[0].size(); p += 4) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        const float value = attributes[0][p + c];
+        boundingBox[c] = value < boundingBox[c] ? value : boundingBox[c];
+        boundingBox[c + 3] = value > boundingBox[c + 3] ? value : boundingBox[c + 3];
+      }
+    }
+    SirMetal::MemoryRange ranges[3];
+    std::vector<float> blob(SirMetal::computeVertexBlobLayout(VERTEX_COUNT, 3, ranges));
+    for (uint32_t a = 0; a < 3; ++a) {
+      memcpy(reinterpret_cast<char *>(blob.data()) + ranges[a].m_offset, attributes[a].data(),
+             ranges[a].m_size);
+    }
+    SirMetal::benchmark::doNotOptimize(blob.data());
+    SirMetal::benchmark::doNotOptimize(boundingBox[0]);
+  });
+
+  // strided loads straight in the blob, bounding box in the same pass
+  state.measure("extractToBlob", VERTEX_COUNT, [&] {
+    SirMetal::MemoryRange ranges[3];
+    std::vector<float> blob(SirMetal::computeVertexBlobLayout(VERTEX_COUNT, 3, ranges));
+    float boundingBox[6];
+    SirMetal::extractFloat3ToFloat4(bytes + offsetof(InterleavedVertex, position),
+                                    sizeof(InterleavedVertex), VERTEX_COUNT, 1.0f,
+                                    blob.data() + ranges[0].m_offset / 4, boundingBox);
+    SirMetal::extractFloat3ToFloat4(bytes + offsetof(InterleavedVertex, normal),
+                                    sizeof(InterleavedVertex), VERTEX_COUNT, 0.0f,
+                                    blob.data() + ranges[1].m_offset / 4);
+    SirMetal::extractFloat2(bytes + offsetof(InterleavedVertex, uv), sizeof(InterleavedVertex),
+                            VERTEX_COUNT, blob.data() + ranges[2].m_offset / 4);
+    SirMetal::benchmark::doNotOptimize(blob.data());
+    SirMetal::benchmark::doNotOptimize(boundingBox[0]);
+  });
+}
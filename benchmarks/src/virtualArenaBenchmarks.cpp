@@ -0,0 +1,46 @@
+#include "SirMetal/core/memory/cpu/resizableVector.h"
+#include "SirMetal/core/memory/cpu/virtualArena.h"
+#include "benchmark.h"
+
+#include <memory>
+
+static constexpr uint32_t ELEMENT_COUNT = 4u * 1024u * 1024u;
+static constexpr uint64_t ARENA_RESERVE = 1ull << 32;
+
+// growing a vector from a small reserve, the heap one copies on every doubling,
+// the arena one commits the next pages and never moves
+SM_BENCHMARK(VirtualArenaVectorGrowth) {
+  std::unique_ptr<SirMetal::ResizableVector<uint32_t>> heapVector;
+  state.measure(
+          "heap", ELEMENT_COUNT,
+          [&] {
+            heapVector.reset();
+            heapVector = std::make_unique<SirMetal::ResizableVector<uint32_t>>(16);
+          },
+          [&] {
+            for (uint32_t i = 0; i < ELEMENT_COUNT; ++i) { heapVector->pushBack(i); }
+          });
+  heapVector.reset();
+
+  std::unique_ptr<SirMetal::VirtualArena> arena;
+  std::unique_ptr<SirMetal::ResizableVector<uint32_t, SirMetal::VirtualArena>> arenaVector;
+  auto arenaRun = [&](const char *name, const uint32_t flags) {
+    state.measure(
+            name, ELEMENT_COUNT,
+            [&] {
+              arenaVector.reset();
+              arena = std::make_unique<SirMetal::VirtualArena>();
+              arena->reserve(ARENA_RESERVE, flags);
+              arenaVector =
+                      std::make_unique<SirMetal::ResizableVector<uint32_t, SirMetal::VirtualArena>>(
+                              16, arena.get());
+            },
+            [&] {
+              for (uint32_t i = 0; i < ELEMENT_COUNT; ++i) { arenaVector->pushBack(i); }
+            });
+    state.setCounter("committedMB", static_cast<double>(arena->getCommittedSize()) / (1024 * 1024));
+    arenaVector.reset();
+  };
+  arenaRun("virtualArena", SirMetal::VIRTUAL_ARENA_FLAG_NONE);
+  arenaRun("virtualArenaHugePages", SirMetal::VIRTUAL_ARENA_FLAG_HUGE_PAGES);
+}
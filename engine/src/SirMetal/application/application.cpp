@@ -4,7 +4,9 @@
 #include "SirMetal/application/window.h"
 #include "SirMetal/core/event.h"
 #include "SirMetal/core/input.h"
+#include "SirMetal/core/memory/cpu/frameAllocator.h"
 #include "SirMetal/engine.h"
+#include "SirMetal/resources/asyncLoader.h"
 
 /*
 #include "blackHole/application/layer.h"
@@ -55,6 +57,9 @@ void Application::run() {
   while (m_run) {
     m_window->onUpdate();
     m_engine->m_timings.newFrame();
+    m_engine->m_frameAllocator->newFrame(m_engine->m_timings.m_totalNumberOfFrames);
+    // background loads done cooking get their GPU resources before the layers run
+    m_engine->m_asyncLoader->processUploads();
     // TODO process queue event
     // EventQueue *currentQueue = m_queuedEndOfFrameEventsCurrent;
     // flipEndOfFrameQueue();
@@ -64,7 +69,7 @@ void Application::run() {
     //}
     // currentQueue->allocCount = 0;
     /*
-    m_engine->m_debugRenderer->newFrame();
+    m_engine->m_debugRenderer->newFrame(m_engine);
     m_engine->m_actionManager->processActionButtons();
     m_engine->m_actionManager->processActionAxis();
     m_engine->m_renderingContext->beginScene(0.2f, 0.2f, 0.2f, 1.0f);
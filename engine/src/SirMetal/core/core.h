@@ -1,6 +1,9 @@
 #pragma once
 
-// defined here such that I don't have to worry about including cstdint
+// defined here such that I don't have to worry about including cstdint, the
+// typedefs match the Apple ones, other platforms (int64_t is long on LP64 linux)
+// go through the system header
+#if defined(__APPLE__)
 typedef signed char int8_t;
 typedef short int16_t;
 typedef int int32_t;
@@ -9,6 +12,9 @@ typedef unsigned char uint8_t;
 typedef unsigned short uint16_t;
 typedef unsigned int uint32_t;
 typedef unsigned long long uint64_t;
+#else
+#include <stdint.h>
+#endif
 
 constexpr uint16_t UINT16_MAX_VALUE = 65535;
 constexpr uint8_t UINT8_MAX_VALUE = 255;
@@ -37,4 +37,24 @@ inline uint32_t hashString32(const char *const&value) {
   return util::Hash32(value, len);
 }
 
+// FNV-1a, way slower than farmhash on long strings but it can run at compile
+// time, the same function is used at runtime such that a name hashed in either
+// place gives the same value. Used for the StringId, see stringId.h
+constexpr uint64_t FNV_OFFSET_BASIS_64 = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV_PRIME_64 = 0x100000001b3ull;
+constexpr uint64_t hashStringFnv64(const char *value, const size_t len) {
+  uint64_t hash = FNV_OFFSET_BASIS_64;
+  for (size_t i = 0; i < len; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(value[i])) * FNV_PRIME_64;
+  }
+  return hash;
+}
+constexpr uint64_t hashStringFnv64(const char *value) {
+  uint64_t hash = FNV_OFFSET_BASIS_64;
+  for (; *value != '\0'; ++value) {
+    hash = (hash ^ static_cast<uint8_t>(*value)) * FNV_PRIME_64;
+  }
+  return hash;
+}
+
 } // namespace SirMetal
\ No newline at end of file
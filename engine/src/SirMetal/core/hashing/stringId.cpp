@@ -0,0 +1,58 @@
+#include "SirMetal/core/hashing/stringId.h"
+#include <assert.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/stringPool.h"
+
+namespace SirMetal {
+
+#ifndef NDEBUG
+namespace {
+using NameTable = HashMap<uint64_t, const char *, hashUint64>;
+// resources can get registered from loading threads
+std::mutex NAMES_MUTEX;
+NameTable *NAMES = nullptr;
+} // namespace
+#endif
+
+StringId registerStringId(const char *name) {
+  const StringId id(name);
+#ifndef NDEBUG
+  if (globals::STRING_POOL == nullptr) { return id; }
+  std::lock_guard<std::mutex> lock(NAMES_MUTEX);
+  if (NAMES == nullptr) { NAMES = new NameTable(256); }
+  const char *registered = nullptr;
+  if (NAMES->get(id.getHash(), registered)) {
+    if (strcmp(registered, name) != 0) {
+      printf("[ERROR] String id collision between %s and %s\n", registered, name);
+      assert(0 && "string id collision");
+    }
+    return id;
+  }
+  NAMES->insert(id.getHash(), globals::STRING_POOL->allocatePersistent(name));
+#endif
+  return id;
+}
+
+void clearStringIdNames() {
+#ifndef NDEBUG
+  // the names themselves go away with the string pool
+  std::lock_guard<std::mutex> lock(NAMES_MUTEX);
+  delete NAMES;
+  NAMES = nullptr;
+#endif
+}
+
+const char *StringId::getDebugName() const {
+#ifndef NDEBUG
+  std::lock_guard<std::mutex> lock(NAMES_MUTEX);
+  const char *registered = nullptr;
+  if ((NAMES != nullptr) && NAMES->get(m_hash, registered)) { return registered; }
+#endif
+  return "<unknown>";
+}
+
+} // namespace SirMetal
@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SirMetal/core/hashing/hashing.h"
+
+namespace SirMetal {
+
+// 64 bits hash of a name, resources and shaders are looked up and compared
+// by it instead of by string. Literals are hashed at compile time with the
+// _sid operator, names only known at runtime go through the same function so
+// both match. Id 0 is the invalid id.
+class StringId {
+public:
+  constexpr StringId() = default;
+  constexpr explicit StringId(const uint64_t hash) : m_hash(hash) {}
+  constexpr explicit StringId(const char *name) : m_hash(hashStringFnv64(name)) {}
+  constexpr StringId(const char *name, const size_t len)
+      : m_hash(hashStringFnv64(name, len)) {}
+
+  [[nodiscard]] constexpr uint64_t getHash() const { return m_hash; }
+  [[nodiscard]] constexpr bool isValid() const { return m_hash != 0; }
+
+  constexpr bool operator==(const StringId other) const { return m_hash == other.m_hash; }
+  constexpr bool operator!=(const StringId other) const { return m_hash != other.m_hash; }
+  constexpr bool operator<(const StringId other) const { return m_hash < other.m_hash; }
+
+  // name the id was registered with, see registerStringId. Names are only
+  // tracked in debug builds, returns "<unknown>" otherwise or when the id was
+  // never registered
+  [[nodiscard]] const char *getDebugName() const;
+
+private:
+  uint64_t m_hash = 0;
+};
+
+// hashes the name and, in debug builds, records it in the reverse table such
+// that getDebugName can print it, the copy of the name lives in
+// globals::STRING_POOL. Also reports hash collisions between registered names.
+StringId registerStringId(const char *name);
+// drops the reverse table, needs to happen before the string pool goes away
+void clearStringIdNames();
+
+inline uint32_t hashStringId(const StringId &id) { return hashUint64(id.getHash()); }
+
+inline namespace literals {
+constexpr StringId operator""_sid(const char *name, const size_t len) {
+  return StringId(name, len);
+}
+} // namespace literals
+
+} // namespace SirMetal
@@ -0,0 +1,213 @@
+#include "SirMetal/core/jobs/jobSystem.h"
+
+namespace SirMetal {
+
+namespace globals {
+JobSystem *JOB_SYSTEM = nullptr;
+}
+
+namespace {
+// page the jobs are carved from, jobs are a cache line each
+constexpr uint32_t JOB_POOL_PAGE_SIZE = 64 * 1024;
+
+// system and index of the calling thread, a thread belongs to one system
+thread_local const JobSystem *t_jobSystem = nullptr;
+thread_local uint32_t t_threadIndex = JobSystem::NOT_A_WORKER;
+// picks the first victim to steal from, xorshift
+thread_local uint32_t t_stealSeed = 0x9E3779B9;
+
+uint32_t nextStealSeed() {
+  uint32_t seed = t_stealSeed;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  t_stealSeed = seed;
+  return seed;
+}
+} // namespace
+
+JobSystem::JobSystem() : m_jobPool(JOB_POOL_PAGE_SIZE), m_injectionQueue(INJECTION_QUEUE_CAPACITY) {}
+
+JobSystem::~JobSystem() {
+  if (m_threadCount != 0) { cleanup(); }
+}
+
+void JobSystem::initialize(uint32_t workerCount) {
+  assert(m_threadCount == 0 && "job system already initialized");
+  if (workerCount == AUTO_WORKER_COUNT) {
+    const uint32_t cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+  m_threadCount = workerCount + 1;
+  m_deques.reserve(m_threadCount);
+  for (uint32_t i = 0; i < m_threadCount; ++i) {
+    m_deques.push_back(new WorkStealingDeque<jobs::Job>(DEQUE_CAPACITY));
+  }
+  t_jobSystem = this;
+  t_threadIndex = 0;
+  m_running.store(true, std::memory_order_release);
+  m_threads.reserve(workerCount);
+  for (uint32_t i = 1; i < m_threadCount; ++i) {
+    m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+}
+
+void JobSystem::cleanup() {
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_running.store(false, std::memory_order_release);
+  }
+  m_wakeCondition.notify_all();
+  for (std::thread &thread : m_threads) { thread.join(); }
+  m_threads.clear();
+  for (WorkStealingDeque<jobs::Job> *deque : m_deques) {
+    assert(deque->isEmptyApprox() && "job system cleaned up with jobs still queued");
+    delete deque;
+  }
+  m_deques.clear();
+  m_jobPool.flushThreadCache();
+  if (t_jobSystem == this) {
+    t_jobSystem = nullptr;
+    t_threadIndex = NOT_A_WORKER;
+  }
+  m_threadCount = 0;
+}
+
+uint32_t JobSystem::getCurrentThreadIndex() const {
+  return t_jobSystem == this ? t_threadIndex : NOT_A_WORKER;
+}
+
+uint32_t JobSystem::getDefaultGrainSize(const uint32_t count) const {
+  // a few chunks per thread, such that a slow chunk can be balanced by stealing
+  const uint32_t grainSize = count / (m_threadCount * 8);
+  return grainSize > 0 ? grainSize : 1;
+}
+
+void JobSystem::wait(TaskGroup &group) {
+  assert(m_threadCount != 0 && "job system not initialized");
+  const uint32_t threadIndex = getCurrentThreadIndex();
+  while (!group.isDone()) {
+    jobs::Job *job = findJob(threadIndex);
+    if (job != nullptr) {
+      execute(job);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  // the thread taking the count to zero might still hold the lock, the group
+  // is likely to go out of scope as soon as we return
+  std::lock_guard<std::mutex> lock(group.m_mutex);
+}
+
+void JobSystem::submit(jobs::Job *job) {
+  assert(m_threadCount != 0 && "job system not initialized");
+  const uint32_t threadIndex = getCurrentThreadIndex();
+  const bool queued = threadIndex != NOT_A_WORKER ? m_deques[threadIndex]->push(job)
+                                                  : m_injectionQueue.push(job);
+  if (!queued) {
+    // no room left, running it here is the back pressure
+    execute(job);
+    return;
+  }
+  wakeWorker();
+}
+
+jobs::Job *JobSystem::findJob(const uint32_t threadIndex) {
+  jobs::Job *job = nullptr;
+  if (threadIndex != NOT_A_WORKER) {
+    job = m_deques[threadIndex]->pop();
+    if (job != nullptr) { return job; }
+  }
+  if (m_injectionQueue.pop(job)) { return job; }
+  const uint32_t first = nextStealSeed() % m_threadCount;
+  for (uint32_t i = 0; i < m_threadCount; ++i) {
+    uint32_t victim = first + i;
+    victim = victim >= m_threadCount ? victim - m_threadCount : victim;
+    if (victim == threadIndex) { continue; }
+    job = m_deques[victim]->steal();
+    if (job != nullptr) { return job; }
+  }
+  return nullptr;
+}
+
+void JobSystem::execute(jobs::Job *job) {
+  TaskGroup &group = *job->group;
+  job->invoke(job);
+  m_jobPool.free(job);
+  finishJob(group);
+}
+
+void JobSystem::finishJob(TaskGroup &group) {
+  // not the last job, a plain decrement, the group is not touched after
+  uint32_t pending = group.m_pending.load(std::memory_order_relaxed);
+  while (pending > 1) {
+    if (group.m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  assert(pending == 1);
+  // might be the last one, the count reaches zero under the lock such that no
+  // job gets parked after the continuations are taken
+  std::vector<jobs::Job *> continuations;
+  {
+    std::lock_guard<std::mutex> lock(group.m_mutex);
+    if (group.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      continuations.swap(group.m_continuations);
+    }
+  }
+  for (jobs::Job *job : continuations) { submit(job); }
+}
+
+bool JobSystem::hasQueuedJobs() const {
+  if (m_injectionQueue.sizeApprox() != 0) { return true; }
+  for (const WorkStealingDeque<jobs::Job> *deque : m_deques) {
+    if (!deque->isEmptyApprox()) { return true; }
+  }
+  return false;
+}
+
+void JobSystem::wakeWorker() {
+  // pairs with the sleeping count bump of workerLoop, either we see the
+  // sleeper or the sleeper sees our job
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_sleepingCount.load(std::memory_order_seq_cst) == 0) { return; }
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    ++m_wakeEpoch;
+  }
+  m_wakeCondition.notify_one();
+}
+
+void JobSystem::workerLoop(const uint32_t threadIndex) {
+  t_jobSystem = this;
+  t_threadIndex = threadIndex;
+  t_stealSeed = 0x9E3779B9 ^ (threadIndex * 0x85EBCA6B);
+  uint32_t idleSpins = 0;
+  while (m_running.load(std::memory_order_acquire)) {
+    jobs::Job *job = findJob(threadIndex);
+    if (job != nullptr) {
+      execute(job);
+      idleSpins = 0;
+      continue;
+    }
+    if (++idleSpins < IDLE_SPINS_BEFORE_SLEEP) {
+      std::this_thread::yield();
+      continue;
+    }
+    idleSpins = 0;
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+    const uint64_t epoch = m_wakeEpoch;
+    if (!hasQueuedJobs()) {
+      m_wakeCondition.wait(lock, [this, epoch] {
+        return (m_wakeEpoch != epoch) || !m_running.load(std::memory_order_acquire);
+      });
+    }
+    m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+  }
+  // the blocks cached by this thread go back to the pool before it exits
+  m_jobPool.flushThreadCache();
+}
+
+} // namespace SirMetal
@@ -0,0 +1,210 @@
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SirMetal/core/jobs/workStealingDeque.h"
+#include "SirMetal/core/memory/cpu/mpmcQueue.h"
+#include "SirMetal/core/memory/cpu/threadCachingPool.h"
+
+namespace SirMetal {
+
+class TaskGroup;
+
+namespace jobs {
+// bytes a job can hold of its callable, captures past that do not compile,
+// capture by reference or pointer instead
+constexpr uint32_t JOB_STORAGE_SIZE = 48;
+
+// a job is a cache line, the callable is stored in place, no std::function
+// and no allocation other than the job itself
+struct Job {
+  // runs the callable and destroys it
+  void (*invoke)(Job *job);
+  TaskGroup *group;
+  alignas(void *) unsigned char storage[JOB_STORAGE_SIZE];
+};
+} // namespace jobs
+
+// Counter of the jobs of a group not done yet, waiting on the group returns
+// once it reaches zero. Jobs can be made to depend on a group, they are parked
+// in the group and pushed by the thread finishing its last job. The group has
+// to outlive its jobs, waiting on it before it goes out of scope is enough.
+class TaskGroup final {
+public:
+  TaskGroup() = default;
+  ~TaskGroup() { assert(isDone() && "task group destroyed with jobs still pending"); }
+
+  [[nodiscard]] bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+  [[nodiscard]] uint32_t getPendingCount() const {
+    return m_pending.load(std::memory_order_acquire);
+  }
+
+  // deleted copy constructor and assignment operator
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+private:
+  friend class JobSystem;
+  std::atomic<uint32_t> m_pending{0};
+  // only taken to park a job and by the job taking the count to zero
+  std::mutex m_mutex;
+  std::vector<jobs::Job *> m_continuations;
+};
+
+// Work stealing job system. Every thread, the one calling initialize included,
+// owns a Chase-Lev deque, jobs pushed from a thread go to the bottom of its own
+// deque and it pops them back from there, newest first. A thread out of jobs
+// steals the oldest job of another deque, starting from a random one. Threads
+// which are not part of the system push to a shared MpmcQueue instead. Idle
+// workers spin a little then sleep until a job is pushed.
+// The main thread has no loop of its own, it runs jobs while it waits on a
+// group, with no workers (single core) everything runs in wait.
+// Jobs are allocated from a ThreadCachingPool, they can be freed from whatever
+// thread ran them without a lock.
+class JobSystem final {
+public:
+  // one thread less than the cores, the main thread is the last one
+  static constexpr uint32_t AUTO_WORKER_COUNT = 0xFFFFFFFF;
+  static constexpr uint32_t DEQUE_CAPACITY = 4096;
+  static constexpr uint32_t INJECTION_QUEUE_CAPACITY = 4096;
+  static constexpr uint32_t IDLE_SPINS_BEFORE_SLEEP = 64;
+  static constexpr uint32_t NOT_A_WORKER = 0xFFFFFFFF;
+
+public:
+  JobSystem();
+  ~JobSystem();
+
+  // the calling thread becomes thread 0 of the system
+  void initialize(uint32_t workerCount = AUTO_WORKER_COUNT);
+  // every group has to be waited on before, jobs still queued do not run
+  void cleanup();
+
+  // queues fn() as part of group, if the deque of the thread is full the job
+  // runs right away instead
+  template <typename FN>
+  void run(TaskGroup &group, FN &&fn) {
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    submit(createJob(group, std::forward<FN>(fn)));
+  }
+
+  // queues fn() as part of group once every job of dependency is done, right
+  // away if it already is. The job counts as pending in group from now
+  template <typename FN>
+  void runAfter(TaskGroup &dependency, TaskGroup &group, FN &&fn) {
+    assert(&dependency != &group && "a group can not depend on itself");
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    jobs::Job *job = createJob(group, std::forward<FN>(fn));
+    {
+      // the count only reaches zero under the lock, the job is either parked
+      // before or sees the group done
+      std::lock_guard<std::mutex> lock(dependency.m_mutex);
+      if (!dependency.isDone()) {
+        dependency.m_continuations.push_back(job);
+        return;
+      }
+    }
+    submit(job);
+  }
+
+  // runs jobs, of any group, on the calling thread until group is done
+  void wait(TaskGroup &group);
+
+  // calls fn(begin, end) over chunks of [0, count) of at most grainSize, on
+  // any thread, and returns once all of them ran. The range is split in halves,
+  // one half is pushed and the other kept, such that the thieves take the
+  // biggest chunks left and the pushes are log2 deep. A grain size of 0 gives
+  // every thread a few chunks to balance
+  template <typename FN>
+  void parallelFor(const uint32_t count, uint32_t grainSize, FN &&fn) {
+    if (count == 0) { return; }
+    if (grainSize == 0) { grainSize = getDefaultGrainSize(count); }
+    if (count <= grainSize) {
+      fn(0u, count);
+      return;
+    }
+    TaskGroup group;
+    splitRange(group, fn, 0, count, grainSize);
+    wait(group);
+  }
+
+  // getters
+  [[nodiscard]] uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_threads.size()); }
+  // workers plus the main thread
+  [[nodiscard]] uint32_t getThreadCount() const { return m_threadCount; }
+  // 0 for the main thread, NOT_A_WORKER for threads outside the system
+  [[nodiscard]] uint32_t getCurrentThreadIndex() const;
+
+  // deleted copy constructor and assignment operator
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+private:
+  template <typename FN>
+  jobs::Job *createJob(TaskGroup &group, FN &&fn) {
+    using Callable = std::decay_t<FN>;
+    static_assert(sizeof(Callable) <= jobs::JOB_STORAGE_SIZE,
+                  "job callable too big, capture by reference or pointer");
+    static_assert(alignof(Callable) <= alignof(void *), "job callable over aligned");
+    auto *job = static_cast<jobs::Job *>(m_jobPool.allocate(sizeof(jobs::Job)));
+    job->group = &group;
+    new (job->storage) Callable(std::forward<FN>(fn));
+    job->invoke = [](jobs::Job *self) {
+      auto *callable = std::launder(reinterpret_cast<Callable *>(self->storage));
+      (*callable)();
+      callable->~Callable();
+    };
+    return job;
+  }
+
+  template <typename FN>
+  void splitRange(TaskGroup &group, FN &fn, const uint32_t begin, uint32_t end,
+                  const uint32_t grainSize) {
+    while (end - begin > grainSize) {
+      const uint32_t middle = begin + (end - begin) / 2;
+      FN *function = &fn;
+      run(group, [this, &group, function, middle, end, grainSize]() {
+        splitRange(group, *function, middle, end, grainSize);
+      });
+      end = middle;
+    }
+    fn(begin, end);
+  }
+
+  uint32_t getDefaultGrainSize(uint32_t count) const;
+  void submit(jobs::Job *job);
+  jobs::Job *findJob(uint32_t threadIndex);
+  void execute(jobs::Job *job);
+  void finishJob(TaskGroup &group);
+  bool hasQueuedJobs() const;
+  void wakeWorker();
+  void workerLoop(uint32_t threadIndex);
+
+private:
+  ThreadCachingPool m_jobPool;
+  MpmcQueue<jobs::Job *> m_injectionQueue;
+  std::vector<WorkStealingDeque<jobs::Job> *> m_deques;
+  std::vector<std::thread> m_threads;
+  uint32_t m_threadCount = 0;
+  std::atomic<bool> m_running{false};
+
+  // sleeping workers, a push bumps the epoch to wake one up
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wakeCondition;
+  uint64_t m_wakeEpoch = 0;
+  std::atomic<uint32_t> m_sleepingCount{0};
+};
+
+namespace globals {
+// engine wide job system, loaders fall back to a serial loop when it is not set
+extern JobSystem *JOB_SYSTEM;
+} // namespace globals
+
+} // namespace SirMetal
@@ -0,0 +1,96 @@
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+
+#include "SirMetal/core/memory/cpu/spscQueue.h"
+
+namespace SirMetal {
+
+// Bounded Chase-Lev work stealing deque of pointers, with the memory orders of
+// Le et al. "Correct and Efficient Work-Stealing for Weak Memory Models".
+// The owner thread pushes and pops at the bottom, like a stack, the most
+// recent job is the one still hot in cache. Any other thread steals from the
+// top, the oldest job, which for a recursive split is the biggest chunk left.
+// Owner push and pop only touch bottom, there is a compare exchange on top
+// only when owner and thieves race for the last job. The buffer does not
+// grow, a push on a full deque fails and the caller deals with the job.
+template <typename T>
+class WorkStealingDeque final {
+public:
+  explicit WorkStealingDeque(const uint32_t capacity) {
+    const uint32_t rounded = roundUpToPowerOfTwo(capacity);
+    m_mask = rounded - 1;
+    m_buffer = new std::atomic<T *>[rounded];
+    for (uint32_t i = 0; i < rounded; ++i) { m_buffer[i].store(nullptr, std::memory_order_relaxed); }
+  }
+  ~WorkStealingDeque() { delete[] m_buffer; }
+
+  // owner only, false if the deque is full
+  bool push(T *value) {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<int64_t>(m_mask)) { return false; }
+    m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+    // publishes the slot to the thieves reading bottom
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // owner only, nullptr if the deque is empty
+  T *pop() {
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    // the thieves have to see the smaller bottom before we read top
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T *value = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // last job, a thief might be after it too
+      if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+        value = nullptr;
+      }
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  // any thread, nullptr if the deque is empty or another thread won the race
+  T *steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) { return nullptr; }
+    T *value = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return value;
+  }
+
+  // only a snapshot, used to decide whether a thread can go to sleep
+  [[nodiscard]] bool isEmptyApprox() const {
+    return m_bottom.load(std::memory_order_acquire) <= m_top.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] uint32_t capacity() const { return m_mask + 1; }
+
+  // deleted copy constructor and assignment operator
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+private:
+  // thieves side
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};
+  // owner side
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0};
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<T *> *m_buffer = nullptr;
+  uint32_t m_mask = 0;
+};
+
+} // namespace SirMetal
@@ -0,0 +1,110 @@
+#pragma once
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <type_traits>
+#include <utility>
+
+#include "SirMetal/core/memory/cpu/stackAllocator.h"
+
+namespace SirMetal {
+
+// The cpu containers (HashMap, ResizableVector, RingBuffer) take an optional
+// ALLOCATOR*, when null they fall back to the heap. Anything exposing
+//   void *allocate(uint32_t sizeInByte);
+//   void free(void *memory);
+// can be used, ThreeSizesPool, ThreadCachingPool and TlsfAllocator do out of
+// the box, the classes below adapt or wrap the other engine allocators.
+// An allocator able to grow a block without moving it, like VirtualArena, can
+// also expose
+//   bool tryGrowInPlace(void *memory, uint64_t newSizeInByte);
+// ResizableVector then grows in place and skips the copy.
+template <typename ALLOCATOR, typename = void>
+struct canGrowInPlace : std::false_type {};
+template <typename ALLOCATOR>
+struct canGrowInPlace<ALLOCATOR,
+                      std::void_t<decltype(std::declval<ALLOCATOR &>().tryGrowInPlace(
+                              static_cast<void *>(nullptr), uint64_t{}))>>
+    : std::true_type {};
+
+// Hands out frame memory from a StackAllocator, free is a no op since the
+// memory goes away in bulk when the stack is reset. A container living in it
+// must not outlive the frame. The interface has no alignment, every block is
+// aligned like malloc would, the stack default of 1 is not enough for the
+// element types the containers hold.
+class StackAllocatorAdapter {
+public:
+  explicit StackAllocatorAdapter(StackAllocator *stack) : m_stack(stack) {}
+
+  void *allocate(const uint32_t sizeInByte) {
+    return m_stack->allocate(sizeInByte, alignof(max_align_t));
+  }
+  void free(void *) {}
+
+private:
+  StackAllocator *m_stack;
+};
+
+// Forwards to another allocator and keeps track of the bytes in use against a
+// budget, such that every container allocation is attributed to a system.
+// Going over budget does not fail the allocation, it is reported once and
+// recorded in the stats.
+template <typename ALLOCATOR>
+class BudgetAllocator {
+public:
+  BudgetAllocator(ALLOCATOR *allocator, const char *name, const uint64_t budgetInByte)
+      : m_allocator(allocator), m_name(name), m_budgetInByte(budgetInByte) {}
+
+  void *allocate(const uint32_t sizeInByte) {
+    // the size is stored in front of the allocation so free can account it,
+    // the header takes a whole max_align_t, a parent block aligned like
+    // malloc stays aligned like malloc once the header is skipped
+    auto *header =
+            reinterpret_cast<uint64_t *>(m_allocator->allocate(sizeInByte + HEADER_SIZE));
+    *header = sizeInByte;
+    m_usedBytes += sizeInByte;
+    m_peakBytes = m_usedBytes > m_peakBytes ? m_usedBytes : m_peakBytes;
+    ++m_allocationCount;
+    if ((m_usedBytes > m_budgetInByte) & !m_overBudget) {
+      printf("[WARN] %s went over its memory budget of %llu bytes\n", m_name,
+             static_cast<unsigned long long>(m_budgetInByte));
+      m_overBudget = true;
+    }
+    return reinterpret_cast<char *>(header) + HEADER_SIZE;
+  }
+
+  void free(void *memory) {
+    if (memory == nullptr) { return; }
+    auto *header = reinterpret_cast<uint64_t *>(static_cast<char *>(memory) - HEADER_SIZE);
+    assert(*header <= m_usedBytes);
+    m_usedBytes -= *header;
+    --m_allocationCount;
+    m_allocator->free(header);
+  }
+
+  const char *getName() const { return m_name; }
+  uint64_t getBudget() const { return m_budgetInByte; }
+  uint64_t getUsedBytes() const { return m_usedBytes; }
+  uint64_t getPeakBytes() const { return m_peakBytes; }
+  uint32_t getAllocationCount() const { return m_allocationCount; }
+  bool hasGoneOverBudget() const { return m_overBudget; }
+
+  // deleted copy constructors and assignment operator
+  BudgetAllocator(const BudgetAllocator &) = delete;
+  BudgetAllocator &operator=(const BudgetAllocator &) = delete;
+
+private:
+  static constexpr uint32_t HEADER_SIZE = alignof(max_align_t);
+  static_assert(HEADER_SIZE >= sizeof(uint64_t), "header too small for the size");
+
+  ALLOCATOR *m_allocator;
+  const char *m_name;
+  uint64_t m_budgetInByte;
+  uint64_t m_usedBytes = 0;
+  uint64_t m_peakBytes = 0;
+  uint32_t m_allocationCount = 0;
+  bool m_overBudget = false;
+};
+
+} // namespace SirMetal
@@ -0,0 +1,132 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+#include "SirMetal/core/memory/cpu/sparseMemoryPool.h"
+
+namespace SirMetal {
+
+struct DensePoolHandle {
+  static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+  uint32_t index = INVALID_INDEX;
+  uint32_t generation = 0;
+  inline bool isHandleValid() const { return index != INVALID_INDEX; }
+};
+
+// Typed object pool, live objects are packed at the front of a dense array
+// and handles go through a sparse indirection. The sparse slots come from a
+// SparseMemoryPool and hold where the object sits in the dense array, every
+// sparse slot also has a generation which is bumped when its object goes
+// away, a handle from an older generation is stale and fails the lookup.
+// Removing swaps the last object in the hole, objects move but handles stay
+// valid, pointers and dense indices do not survive a remove.
+// Systems walk the live objects with data()/size() or forEach, a linear walk
+// over contiguous memory, no liveness check per element.
+template <typename T>
+class DensePool final {
+public:
+  explicit DensePool(const uint32_t poolSize) : m_sparse(poolSize) {
+    m_dense.reserve(poolSize);
+    m_denseToSparse.reserve(poolSize);
+  }
+
+  DensePoolHandle insert(const T &value) {
+    T copy = value;
+    return insert(std::move(copy));
+  }
+
+  DensePoolHandle insert(T &&value) {
+    if (size() == m_sparse.getPoolSize()) {
+      printf("[ERROR] Dense pool is full, pool size is %u\n", m_sparse.getPoolSize());
+      assert(0 && "dense pool is full");
+      return {};
+    }
+    uint32_t sparseIndex;
+    m_sparse.getFreeMemoryData(sparseIndex).denseIndex = size();
+    // fresh sparse slots come in order from the high water mark
+    if (sparseIndex == m_generations.size()) { m_generations.push_back(0); }
+    m_dense.emplace_back(std::move(value));
+    m_denseToSparse.push_back(sparseIndex);
+    return {sparseIndex, m_generations[sparseIndex]};
+  }
+
+  // returns nullptr if the handle is stale or was never handed out
+  inline T *get(const DensePoolHandle handle) {
+    return isValid(handle) ? &m_dense[m_sparse[handle.index].denseIndex] : nullptr;
+  }
+  inline const T *get(const DensePoolHandle handle) const {
+    return isValid(handle) ? &m_dense[m_sparse.getConstRef(handle.index).denseIndex] : nullptr;
+  }
+
+  // a generation is only handed out while its slot is live, matching the
+  // current one is enough
+  [[nodiscard]] inline bool isValid(const DensePoolHandle handle) const {
+    return (handle.index < m_generations.size()) &&
+           (m_generations[handle.index] == handle.generation);
+  }
+
+  bool remove(const DensePoolHandle handle) {
+    if (!isValid(handle)) { return false; }
+    const uint32_t denseIndex = m_sparse[handle.index].denseIndex;
+    const uint32_t last = size() - 1;
+    if (denseIndex != last) {
+      // the last object fills the hole, its sparse slot follows it
+      m_dense[denseIndex] = std::move(m_dense[last]);
+      m_denseToSparse[denseIndex] = m_denseToSparse[last];
+      m_sparse[m_denseToSparse[denseIndex]].denseIndex = denseIndex;
+    }
+    m_dense.pop_back();
+    m_denseToSparse.pop_back();
+    m_sparse.free(handle.index);
+    ++m_generations[handle.index];
+    return true;
+  }
+
+  // removes everything, outstanding handles become stale. The generations
+  // are kept, the sparse slots are reused from the start after a clear
+  void clear() {
+    for (const uint32_t sparseIndex : m_denseToSparse) { ++m_generations[sparseIndex]; }
+    m_dense.clear();
+    m_denseToSparse.clear();
+    m_sparse.clear();
+  }
+
+  // calls fn(T&) for every live object, in dense order
+  template <typename FN>
+  void forEach(FN fn) {
+    for (T &value : m_dense) { fn(value); }
+  }
+
+  // handle of the object at a dense index, to go from a walk back to a handle
+  [[nodiscard]] DensePoolHandle getHandle(const uint32_t denseIndex) const {
+    assert(denseIndex < size());
+    const uint32_t sparseIndex = m_denseToSparse[denseIndex];
+    return {sparseIndex, m_generations[sparseIndex]};
+  }
+
+  [[nodiscard]] inline T *data() { return m_dense.data(); }
+  [[nodiscard]] inline const T *data() const { return m_dense.data(); }
+  [[nodiscard]] inline uint32_t size() const { return static_cast<uint32_t>(m_dense.size()); }
+  [[nodiscard]] inline uint32_t getPoolSize() const { return m_sparse.getPoolSize(); }
+
+  // deleted copy constructor and assignment operator
+  DensePool(const DensePool &) = delete;
+  DensePool &operator=(const DensePool &) = delete;
+
+private:
+  struct SparseSlot {
+    uint32_t denseIndex = 0;
+  };
+
+private:
+  SparseMemoryPool<SparseSlot> m_sparse;
+  // kept out of the sparse slots, a freed slot holds the free list link
+  std::vector<uint32_t> m_generations;
+  std::vector<T> m_dense;
+  std::vector<uint32_t> m_denseToSparse;
+};
+
+} // namespace SirMetal
@@ -0,0 +1,82 @@
+#pragma once
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SirMetal/core/memory/cpu/stackAllocator.h"
+
+// not thread safe
+namespace SirMetal {
+
+// N buffered frame memory, every frame allocates from its own stack and a
+// stack is only reset when its frame comes around again, bufferCount frames
+// later. Memory the GPU may still be reading for a frame in flight is not
+// overwritten. The buffer index follows the frame number the same way the
+// constant buffers do, bufferCount is meant to be EngineContext::inFlightFrames.
+class FrameAllocator final {
+public:
+  FrameAllocator() = default;
+  ~FrameAllocator() {
+    delete[] m_buffers;
+    delete[] m_memory;
+  }
+
+  void initialize(const size_t sizePerFrameInByte, const uint32_t bufferCount) {
+    assert(m_memory == nullptr);
+    assert(bufferCount > 0);
+    // every slice starts on a 16 bytes boundary, as the heap would give
+    m_sizePerFrame = (sizePerFrameInByte + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    m_bufferCount = bufferCount;
+    m_memory = new char[m_sizePerFrame * bufferCount];
+    m_buffers = new StackAllocator[bufferCount];
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+      char *start = m_memory + m_sizePerFrame * i;
+      m_buffers[i].setMemoryStartEnd(start, start + m_sizePerFrame);
+    }
+    m_frameIndex = 0;
+  }
+
+  // moves to the stack of the frame and drops what was allocated in it
+  // bufferCount frames ago
+  void newFrame(const uint64_t frameNumber) {
+    assert(m_buffers != nullptr);
+    m_frameIndex = static_cast<uint32_t>(frameNumber % m_bufferCount);
+    m_buffers[m_frameIndex].reset();
+  }
+
+  void *allocate(const size_t sizeInByte, const size_t alignment = ALIGNMENT) {
+    return getCurrent().allocate(sizeInByte, alignment);
+  }
+  template <typename T>
+  T *allocateArray(const size_t count) {
+    return getCurrent().allocateArray<T>(count);
+  }
+
+  // the stack of the current frame, to take markers or scopes on it
+  StackAllocator &getCurrent() {
+    assert(m_buffers != nullptr);
+    return m_buffers[m_frameIndex];
+  }
+  const StackAllocator &getCurrent() const {
+    assert(m_buffers != nullptr);
+    return m_buffers[m_frameIndex];
+  }
+
+  uint32_t getFrameIndex() const { return m_frameIndex; }
+  uint32_t getBufferCount() const { return m_bufferCount; }
+  size_t getSizePerFrame() const { return m_sizePerFrame; }
+
+  // deleted copy constructor and assignment operator
+  FrameAllocator(const FrameAllocator &) = delete;
+  FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+private:
+  static constexpr size_t ALIGNMENT = 16;
+  char *m_memory = nullptr;
+  StackAllocator *m_buffers = nullptr;
+  size_t m_sizePerFrame = 0;
+  uint32_t m_bufferCount = 0;
+  uint32_t m_frameIndex = 0;
+};
+
+} // namespace SirMetal
@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SM_HASH_MAP_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SM_HASH_MAP_NEON 1
+#endif
+
+namespace SirMetal {
+
+// Control bytes used by the HashMap, one per bin. A used bin stores the low 7
+// bits of the key hash, free and deleted bins have the high bit set, such that
+// a group of bins can be tested against a tag in a single vector compare and
+// the full key is only touched on a tag match.
+namespace hashMapControl {
+
+static constexpr uint8_t FREE = 0x80;
+static constexpr uint8_t DELETED = 0xFE;
+// number of bins tested at once, the control array has this many extra bytes
+// mirroring the first bins so a group can be loaded at any position
+static constexpr uint32_t GROUP_WIDTH = 16;
+// number of keys hashed and prefetched ahead of probing in the batch lookups,
+// enough to overlap the cache misses without spilling the hashes out of registers
+static constexpr uint32_t BATCH_SIZE = 16;
+
+inline uint8_t tag(const uint32_t hash) { return static_cast<uint8_t>(hash & 0x7F); }
+// the tag bits are not used for the home bin, otherwise all keys in a bin
+// would also share the same tag
+inline uint32_t home(const uint32_t hash) { return hash >> 7; }
+inline bool isUsed(const uint8_t control) { return (control & 0x80) == 0; }
+
+// bit i of the returned masks is set when bin i of the group matches
+struct Group {
+#if SM_HASH_MAP_SSE2
+  explicit Group(const uint8_t *control)
+      : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i *>(control))) {}
+
+  inline uint32_t match(const uint8_t value) const {
+    const __m128i cmp = _mm_cmpeq_epi8(m_control, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(cmp));
+  }
+  // free and deleted are the only values with the high bit set
+  inline uint32_t matchFreeOrDeleted() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(m_control));
+  }
+
+  __m128i m_control;
+#elif SM_HASH_MAP_NEON
+  explicit Group(const uint8_t *control) : m_control(vld1q_u8(control)) {}
+
+  inline uint32_t match(const uint8_t value) const {
+    return toMask(vceqq_u8(m_control, vdupq_n_u8(value)));
+  }
+  inline uint32_t matchFreeOrDeleted() const {
+    return toMask(vcltq_s8(vreinterpretq_s8_u8(m_control), vdupq_n_s8(0)));
+  }
+  // neon has no movemask, we keep one bit per lane and add the lanes up
+  static inline uint32_t toMask(const uint8x16_t cmp) {
+    static const uint8_t BITS[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                     1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t bits = vandq_u8(cmp, vld1q_u8(BITS));
+    return static_cast<uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+           (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+  }
+
+  uint8x16_t m_control;
+#else
+  explicit Group(const uint8_t *control) : m_control(control) {}
+
+  inline uint32_t match(const uint8_t value) const {
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) { mask |= (m_control[i] == value) << i; }
+    return mask;
+  }
+  inline uint32_t matchFreeOrDeleted() const {
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) { mask |= (m_control[i] >> 7) << i; }
+    return mask;
+  }
+
+  const uint8_t *m_control;
+#endif
+  inline uint32_t matchFree() const { return match(FREE); }
+};
+
+// index of the lowest set bit, mask must not be zero
+inline uint32_t lowestBit(const uint32_t mask) {
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+}
+inline void prefetch(const void *address) { __builtin_prefetch(address); }
+
+// index of the highest set bit, mask must not be zero
+inline uint32_t highestBit(const uint32_t mask) {
+  return 31u - static_cast<uint32_t>(__builtin_clz(mask));
+}
+
+// A removed bin can go back to free, instead of becoming a tombstone, when no
+// probe sequence ever went past it. Probes only move to the next group when the
+// current one has no free bin, so that is the case when the run of non free
+// bins around the removed one is shorter than a group.
+inline bool canFreeOnRemove(const uint8_t *control, const uint32_t bin,
+                            const uint32_t mask) {
+  const uint32_t freeAfter = Group(control + bin).matchFree();
+  const uint32_t freeBefore =
+          Group(control + ((bin - GROUP_WIDTH) & mask)).matchFree();
+  if ((freeAfter == 0) | (freeBefore == 0)) { return false; }
+  // bin itself is counted in the bins after
+  const uint32_t usedAfter = lowestBit(freeAfter);
+  const uint32_t usedBefore = (GROUP_WIDTH - 1) - highestBit(freeBefore);
+  return (usedAfter + usedBefore) < GROUP_WIDTH;
+}
+
+} // namespace hashMapControl
+
+// snapshot of the table health, computing it walks all the bins
+struct HashMapStats {
+  uint32_t binCount = 0;
+  uint32_t usedBins = 0;
+  uint32_t deletedBins = 0;
+  // distance in bins of the stored keys from their home bin
+  float averageProbeLength = 0.0f;
+  uint32_t maxProbeLength = 0;
+};
+} // namespace SirMetal
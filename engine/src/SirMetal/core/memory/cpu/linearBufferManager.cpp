@@ -24,25 +24,34 @@ BufferRangeHandle LinearBufferManager::allocate(const uint64_t allocSizeInBytes,
   ;
   for (uint32_t i = 0; i < count; ++i) {
     BufferRangeTracker &range = m_freeAllocations[i];
-    if (allocSizeInBytes > range.m_actualAllocSize) {
+    // the free range has to fit the allocation once its offset is aligned
+    const uint64_t alignedOffset = alignTo(range.m_range.m_offset, alignment);
+    const uint64_t padding = alignedOffset - range.m_range.m_offset;
+    if (allocSizeInBytes + padding > range.m_actualAllocSize) {
       continue;
     }
 
-    // if we are here means the allocation could fit!
+    // if we are here means the allocation could fit! the padding is lost
+    range.m_range.m_offset = alignedOffset;
+    range.m_actualAllocSize -= padding;
     range.m_range.m_size = allocSizeInBytes;
     range.m_magicNumber = MAGIC_NUMBER_COUNTER++;
-    range.m_allocIndex = i;
-    // we need to move it back into the free
+    // m_allocIndex is still the slot the range had in m_allocations, we need
+    // to move it back there
     m_allocations[range.m_allocIndex] = range;
-    m_freeAllocations.removeByPatchingFromLast(i);
-    // lets return the handle
+    // building the handle before the removal, patching from the last element
+    // overrides what range points to
     const BufferRangeHandle handle{static_cast<uint32_t>(
         (range.m_magicNumber << 16u) | range.m_allocIndex)};
+    m_freeAllocations.removeByPatchingFromLast(i);
     m_allocCount += 1;
     return handle;
   }
 
-  // if we are here we need a new allocation
+  // if we are here we need a new allocation, none of the free ranges fit
+  if (!allocationFits) {
+    return BufferRangeHandle{};
+  }
   BufferRangeTracker toReturn{};
   toReturn.m_range = {alignedStackPointer, allocSizeInBytes};
   toReturn.m_allocIndex = static_cast<uint16_t>(m_allocations.size());
@@ -0,0 +1,177 @@
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+#include <utility>
+
+#include "SirMetal/core/memory/cpu/spscQueue.h"
+
+namespace SirMetal {
+
+// Bounded lock free queue for any number of producer and consumer threads,
+// after Dmitry Vyukov's bounded MPMC queue. Every cell carries a sequence
+// number telling which lap of the ring it is ready for. A producer claims the
+// cell at the enqueue position with a compare exchange, writes the value and
+// publishes it by bumping the sequence, a consumer does the same on the
+// dequeue position. Threads only contend on the position they move, cells are
+// handed over with the sequence alone. Capacity is rounded up to a power of
+// two. Batches claim a run of ready cells with a single compare exchange,
+// under contention that is one fight for the position per batch instead of
+// one per value.
+template <typename T>
+class MpmcQueue final {
+public:
+  explicit MpmcQueue(const uint32_t capacity) {
+    const uint32_t rounded = roundUpToPowerOfTwo(capacity);
+    assert(rounded >= 2 && rounded <= (1u << 30));
+    m_mask = rounded - 1;
+    m_cells = new Cell[rounded];
+    for (uint32_t i = 0; i < rounded; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~MpmcQueue() { delete[] m_cells; }
+
+  // false if the queue is full
+  bool push(const T &value) {
+    T copy = value;
+    return push(std::move(copy));
+  }
+  bool push(T &&value) {
+    uint32_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &m_cells[position & m_mask];
+      const uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<int32_t>(sequence - position);
+      if (difference == 0) {
+        if (m_enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // the cell still holds the value of the previous lap
+        return false;
+      } else {
+        position = m_enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+  // pushes as many values as fit, returns how many were pushed
+  uint32_t pushBatch(const T *values, const uint32_t count) {
+    // nothing to claim, the loop below would spin on a ready cell
+    if (count == 0) { return 0; }
+    uint32_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    uint32_t claimed;
+    for (;;) {
+      // run of cells ready for this lap, nobody else can touch them until
+      // the position moves past them
+      claimed = 0;
+      while ((claimed < count) && (m_cells[(position + claimed) & m_mask].sequence.load(
+                                           std::memory_order_acquire) == position + claimed)) {
+        ++claimed;
+      }
+      if (claimed == 0) {
+        const uint32_t sequence = m_cells[position & m_mask].sequence.load(std::memory_order_acquire);
+        if (static_cast<int32_t>(sequence - position) < 0) { return 0; }
+        position = m_enqueuePosition.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (m_enqueuePosition.compare_exchange_weak(position, position + claimed,
+                                                  std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    for (uint32_t i = 0; i < claimed; ++i) {
+      Cell &cell = m_cells[(position + i) & m_mask];
+      cell.value = values[i];
+      cell.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return claimed;
+  }
+
+  // false if the queue is empty
+  bool pop(T &value) {
+    uint32_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &m_cells[position & m_mask];
+      const uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<int32_t>(sequence - (position + 1));
+      if (difference == 0) {
+        if (m_dequeuePosition.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // nothing published in the cell yet
+        return false;
+      } else {
+        position = m_dequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    // ready for the producers of the next lap
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+  // pops up to maxCount values, returns how many were popped
+  uint32_t popBatch(T *values, const uint32_t maxCount) {
+    if (maxCount == 0) { return 0; }
+    uint32_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    uint32_t claimed;
+    for (;;) {
+      claimed = 0;
+      while ((claimed < maxCount) && (m_cells[(position + claimed) & m_mask].sequence.load(
+                                              std::memory_order_acquire) == position + claimed + 1)) {
+        ++claimed;
+      }
+      if (claimed == 0) {
+        const uint32_t sequence = m_cells[position & m_mask].sequence.load(std::memory_order_acquire);
+        if (static_cast<int32_t>(sequence - (position + 1)) < 0) { return 0; }
+        position = m_dequeuePosition.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (m_dequeuePosition.compare_exchange_weak(position, position + claimed,
+                                                  std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    for (uint32_t i = 0; i < claimed; ++i) {
+      Cell &cell = m_cells[(position + i) & m_mask];
+      values[i] = std::move(cell.value);
+      cell.sequence.store(position + i + m_mask + 1, std::memory_order_release);
+    }
+    return claimed;
+  }
+
+  // only a snapshot, other threads keep moving the positions
+  [[nodiscard]] uint32_t sizeApprox() const {
+    const uint32_t enqueue = m_enqueuePosition.load(std::memory_order_acquire);
+    const uint32_t dequeue = m_dequeuePosition.load(std::memory_order_acquire);
+    const auto size = static_cast<int32_t>(enqueue - dequeue);
+    return size > 0 ? static_cast<uint32_t>(size) : 0;
+  }
+  [[nodiscard]] uint32_t capacity() const { return m_mask + 1; }
+
+  // deleted copy constructor and assignment operator
+  MpmcQueue(const MpmcQueue &) = delete;
+  MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    T value;
+  };
+
+private:
+  alignas(QUEUE_CACHE_LINE_SIZE) Cell *m_cells = nullptr;
+  uint32_t m_mask = 0;
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<uint32_t> m_enqueuePosition{0};
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<uint32_t> m_dequeuePosition{0};
+};
+
+} // namespace SirMetal
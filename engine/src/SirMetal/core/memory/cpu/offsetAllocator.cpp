@@ -0,0 +1,268 @@
+#include "SirMetal/core/memory/cpu/offsetAllocator.h"
+#include <stdio.h>
+
+namespace SirMetal {
+
+namespace offsetAllocator {
+namespace {
+inline uint32_t highestBit(const uint32_t mask) {
+  return 31u - static_cast<uint32_t>(__builtin_clz(mask));
+}
+// lowest set bit at or after startBit, UNUSED if none
+inline uint32_t lowestBitAfter(const uint32_t mask, const uint32_t startBit) {
+  const uint32_t masked = startBit < 32 ? mask & (~0u << startBit) : 0;
+  return masked == 0 ? 0xFFFFFFFF : static_cast<uint32_t>(__builtin_ctz(masked));
+}
+} // namespace
+
+uint32_t sizeToBinRoundUp(const uint32_t size) {
+  // below the mantissa range the size is the bin, like a denormal
+  if (size < MANTISSA_VALUE) { return size; }
+  const uint32_t mantissaStartBit = highestBit(size) - MANTISSA_BITS;
+  const uint32_t exponent = mantissaStartBit + 1;
+  uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+  // any bit below the mantissa rounds up, an overflow of the mantissa carries
+  // in the exponent through the addition
+  const uint32_t lowBitsMask = (1u << mantissaStartBit) - 1;
+  if ((size & lowBitsMask) != 0) { ++mantissa; }
+  return (exponent << MANTISSA_BITS) + mantissa;
+}
+
+uint32_t sizeToBinRoundDown(const uint32_t size) {
+  if (size < MANTISSA_VALUE) { return size; }
+  const uint32_t mantissaStartBit = highestBit(size) - MANTISSA_BITS;
+  const uint32_t exponent = mantissaStartBit + 1;
+  const uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+  return (exponent << MANTISSA_BITS) | mantissa;
+}
+
+uint32_t binToSize(const uint32_t bin) {
+  const uint32_t exponent = bin >> MANTISSA_BITS;
+  const uint32_t mantissa = bin & MANTISSA_MASK;
+  if (exponent == 0) { return mantissa; }
+  return (mantissa | MANTISSA_VALUE) << (exponent - 1);
+}
+} // namespace offsetAllocator
+
+using namespace offsetAllocator;
+
+OffsetAllocator::OffsetAllocator(const uint64_t bufferSizeInBytes, const uint32_t maxAllocations)
+    : m_bufferSizeInBytes(bufferSizeInBytes), m_maxAllocations(maxAllocations) {
+  assert(bufferSizeInBytes > 0 && bufferSizeInBytes <= UINT32_MAX &&
+         "offset allocator tracks 32 bits offsets");
+  assert(maxAllocations > 1 && maxAllocations <= MAX_ALLOCATIONS);
+  m_nodes = new Node[maxAllocations];
+  m_freeNodes = new uint32_t[maxAllocations];
+  clear();
+}
+
+OffsetAllocator::~OffsetAllocator() {
+  delete[] m_nodes;
+  delete[] m_freeNodes;
+}
+
+void OffsetAllocator::clear() {
+  m_allocCount = 0;
+  m_freeRegionCount = 0;
+  m_freeBytes = 0;
+  m_usedBinsTop = 0;
+  for (uint8_t &bins : m_usedBins) { bins = 0; }
+  for (uint32_t &index : m_binIndices) { index = UNUSED; }
+  m_freeNodeCount = 0;
+  m_nodeHighWaterMark = 0;
+  // the whole buffer starts as a single free region
+  insertNodeIntoBin(static_cast<uint32_t>(m_bufferSizeInBytes), 0);
+}
+
+uint32_t OffsetAllocator::findFreeNode(const uint32_t sizeInBytes) const {
+  // rounding up, any region in the bin or after it fits
+  const uint32_t minBinIndex = sizeToBinRoundUp(sizeInBytes);
+  const uint32_t minTopBinIndex = minBinIndex >> MANTISSA_BITS;
+  const uint32_t minLeafBinIndex = minBinIndex & MANTISSA_MASK;
+  if (minTopBinIndex >= TOP_BIN_COUNT) { return UNUSED; }
+
+  uint32_t topBinIndex = minTopBinIndex;
+  uint32_t leafBinIndex = UNUSED;
+  if ((m_usedBinsTop & (1u << topBinIndex)) != 0) {
+    leafBinIndex = lowestBitAfter(m_usedBins[topBinIndex], minLeafBinIndex);
+  }
+  if (leafBinIndex == UNUSED) {
+    // nothing in the top bin from the leaf on, next used top bin
+    topBinIndex = lowestBitAfter(m_usedBinsTop, minTopBinIndex + 1);
+    if (topBinIndex == UNUSED) { return UNUSED; }
+    leafBinIndex = static_cast<uint32_t>(__builtin_ctz(m_usedBins[topBinIndex]));
+  }
+  return m_binIndices[(topBinIndex << MANTISSA_BITS) | leafBinIndex];
+}
+
+uint32_t OffsetAllocator::findAlignedFreeNode(const uint64_t allocSizeInBytes,
+                                              const uint32_t alignment) const {
+  if (allocSizeInBytes > m_freeBytes) { return UNUSED; }
+  // regions mostly start aligned when every allocation uses the same
+  // alignment, trying the exact size first and only paying for the worst
+  // case padding when the region found does not fit once aligned
+  uint32_t nodeIndex = findFreeNode(static_cast<uint32_t>(allocSizeInBytes));
+  if ((nodeIndex == UNUSED) | (alignment <= 1)) { return nodeIndex; }
+  const Node &node = m_nodes[nodeIndex];
+  const uint64_t padding = (alignment - node.dataOffset % alignment) % alignment;
+  if (padding + allocSizeInBytes <= node.dataSize) { return nodeIndex; }
+  const uint64_t paddedSize = allocSizeInBytes + alignment - 1;
+  if (paddedSize > m_freeBytes) { return UNUSED; }
+  return findFreeNode(static_cast<uint32_t>(paddedSize));
+}
+
+BufferRangeHandle OffsetAllocator::allocate(const uint64_t allocSizeInBytes,
+                                            const uint32_t alignment) {
+  assert(allocSizeInBytes > 0);
+  assert(alignment > 0);
+  // a split might need a node, keeping one around
+  if (!hasFreeNode()) { return BufferRangeHandle{}; }
+  const uint32_t nodeIndex = findAlignedFreeNode(allocSizeInBytes, alignment);
+  if (nodeIndex == UNUSED) { return BufferRangeHandle{}; }
+  removeNodeFromBin(nodeIndex);
+
+  Node &node = m_nodes[nodeIndex];
+  const uint32_t nodeTotalSize = node.dataSize;
+  const uint64_t alignedOffset =
+          (static_cast<uint64_t>(node.dataOffset) + alignment - 1) / alignment * alignment;
+  node.padding = static_cast<uint32_t>(alignedOffset - node.dataOffset);
+  node.requestedSize = static_cast<uint32_t>(allocSizeInBytes);
+  node.dataSize = node.padding + node.requestedSize;
+  node.used = true;
+  node.magicNumber = m_magicNumberCounter++;
+  // zero is never handed out, a handle of zero is the invalid one
+  if (m_magicNumberCounter == (1u << (32 - HANDLE_INDEX_BITS))) { m_magicNumberCounter = 1; }
+
+  // the left over goes back as a free region right after the allocation
+  const uint32_t remainder = nodeTotalSize - node.dataSize;
+  if (remainder > 0) {
+    const uint32_t newNodeIndex = insertNodeIntoBin(remainder, node.dataOffset + node.dataSize);
+    Node &newNode = m_nodes[newNodeIndex];
+    if (node.neighborNext != UNUSED) { m_nodes[node.neighborNext].neighborPrev = newNodeIndex; }
+    newNode.neighborPrev = nodeIndex;
+    newNode.neighborNext = node.neighborNext;
+    node.neighborNext = newNodeIndex;
+  }
+  ++m_allocCount;
+  return BufferRangeHandle{(static_cast<uint32_t>(node.magicNumber) << HANDLE_INDEX_BITS) |
+                           nodeIndex};
+}
+
+void OffsetAllocator::free(const BufferRangeHandle handle) {
+  const uint32_t nodeIndex = getNodeIndex(handle);
+  Node &node = m_nodes[nodeIndex];
+  assert(node.used && "double free in the offset allocator");
+
+  uint32_t offset = node.dataOffset;
+  uint32_t size = node.dataSize;
+  if ((node.neighborPrev != UNUSED) && !m_nodes[node.neighborPrev].used) {
+    // merging with the free region before, it takes its place in the chain
+    const Node &prevNode = m_nodes[node.neighborPrev];
+    offset = prevNode.dataOffset;
+    size += prevNode.dataSize;
+    const uint32_t prevIndex = node.neighborPrev;
+    removeNodeFromBin(prevIndex);
+    assert(prevNode.neighborNext == nodeIndex);
+    node.neighborPrev = prevNode.neighborPrev;
+    releaseNode(prevIndex);
+  }
+  if ((node.neighborNext != UNUSED) && !m_nodes[node.neighborNext].used) {
+    const Node &nextNode = m_nodes[node.neighborNext];
+    size += nextNode.dataSize;
+    const uint32_t nextIndex = node.neighborNext;
+    removeNodeFromBin(nextIndex);
+    assert(nextNode.neighborPrev == nodeIndex);
+    node.neighborNext = nextNode.neighborNext;
+    releaseNode(nextIndex);
+  }
+  const uint32_t neighborNext = node.neighborNext;
+  const uint32_t neighborPrev = node.neighborPrev;
+  node.used = false;
+  node.magicNumber = 0;
+  releaseNode(nodeIndex);
+  --m_allocCount;
+
+  // the merged region as a fresh node, patched back in the chain
+  const uint32_t combinedIndex = insertNodeIntoBin(size, offset);
+  Node &combined = m_nodes[combinedIndex];
+  if (neighborNext != UNUSED) {
+    combined.neighborNext = neighborNext;
+    m_nodes[neighborNext].neighborPrev = combinedIndex;
+  }
+  if (neighborPrev != UNUSED) {
+    combined.neighborPrev = neighborPrev;
+    m_nodes[neighborPrev].neighborNext = combinedIndex;
+  }
+}
+
+BufferRange OffsetAllocator::getBufferRange(const BufferRangeHandle handle) const {
+  const Node &node = m_nodes[getNodeIndex(handle)];
+  assert(node.used);
+  return BufferRange{static_cast<uint64_t>(node.dataOffset) + node.padding, node.requestedSize};
+}
+
+bool OffsetAllocator::canAllocate(const uint64_t allocSizeInBytes, const uint32_t alignment) const {
+  if (!hasFreeNode()) { return false; }
+  return findAlignedFreeNode(allocSizeInBytes, alignment) != UNUSED;
+}
+
+uint64_t OffsetAllocator::getLargestFreeRegion() const {
+  if (m_usedBinsTop == 0) { return 0; }
+  const uint32_t topBinIndex = highestBit(m_usedBinsTop);
+  const uint32_t leafBinIndex = highestBit(m_usedBins[topBinIndex]);
+  return binToSize((topBinIndex << MANTISSA_BITS) | leafBinIndex);
+}
+
+uint32_t OffsetAllocator::insertNodeIntoBin(const uint32_t size, const uint32_t dataOffset) {
+  const uint32_t binIndex = sizeToBinRoundDown(size);
+  const uint32_t topBinIndex = binIndex >> MANTISSA_BITS;
+  const uint32_t leafBinIndex = binIndex & MANTISSA_MASK;
+  if (m_binIndices[binIndex] == UNUSED) {
+    m_usedBins[topBinIndex] |= 1u << leafBinIndex;
+    m_usedBinsTop |= 1u << topBinIndex;
+  }
+
+  // pushing at the front of the bin list
+  const uint32_t topNodeIndex = m_binIndices[binIndex];
+  const uint32_t nodeIndex = acquireNode();
+  Node &node = m_nodes[nodeIndex];
+  node = Node{dataOffset, size, 0, 0, UNUSED, topNodeIndex, UNUSED, UNUSED, 0, false};
+  if (topNodeIndex != UNUSED) { m_nodes[topNodeIndex].binListPrev = nodeIndex; }
+  m_binIndices[binIndex] = nodeIndex;
+
+  m_freeBytes += size;
+  ++m_freeRegionCount;
+  return nodeIndex;
+}
+
+void OffsetAllocator::removeNodeFromBin(const uint32_t nodeIndex) {
+  const Node &node = m_nodes[nodeIndex];
+  if (node.binListPrev != UNUSED) {
+    m_nodes[node.binListPrev].binListNext = node.binListNext;
+    if (node.binListNext != UNUSED) { m_nodes[node.binListNext].binListPrev = node.binListPrev; }
+  } else {
+    // first of its bin, the bin head moves
+    const uint32_t binIndex = sizeToBinRoundDown(node.dataSize);
+    const uint32_t topBinIndex = binIndex >> MANTISSA_BITS;
+    const uint32_t leafBinIndex = binIndex & MANTISSA_MASK;
+    m_binIndices[binIndex] = node.binListNext;
+    if (node.binListNext != UNUSED) { m_nodes[node.binListNext].binListPrev = UNUSED; }
+    if (m_binIndices[binIndex] == UNUSED) {
+      m_usedBins[topBinIndex] &= ~(1u << leafBinIndex);
+      if (m_usedBins[topBinIndex] == 0) { m_usedBinsTop &= ~(1u << topBinIndex); }
+    }
+  }
+  m_freeBytes -= node.dataSize;
+  --m_freeRegionCount;
+}
+
+uint32_t OffsetAllocator::getNodeIndex(const BufferRangeHandle handle) const {
+  assert(handle.isHandleValid());
+  const uint32_t index = handle.handle & HANDLE_INDEX_MASK;
+  assert(index < m_maxAllocations);
+  assert(m_nodes[index].magicNumber == (handle.handle >> HANDLE_INDEX_BITS) &&
+         "invalid magic handle for offset allocator");
+  return index;
+}
+
+} // namespace SirMetal
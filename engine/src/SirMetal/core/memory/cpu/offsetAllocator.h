@@ -0,0 +1,132 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+
+#include "SirMetal/core/memory/cpu/linearBufferManager.h"
+
+namespace SirMetal {
+
+namespace offsetAllocator {
+// sizes are binned like a tiny float, 3 bits of mantissa and 5 of exponent,
+// every power of two is split in 8 bins, the bin of a size is within 12.5%
+// of it all the way up to 4GB. 256 bins, 32 top bins of 8 leaf bins each
+constexpr uint32_t MANTISSA_BITS = 3;
+constexpr uint32_t MANTISSA_VALUE = 1u << MANTISSA_BITS;
+constexpr uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+constexpr uint32_t TOP_BIN_COUNT = 32;
+constexpr uint32_t BINS_PER_LEAF = 8;
+constexpr uint32_t LEAF_BIN_COUNT = TOP_BIN_COUNT * BINS_PER_LEAF;
+
+// bin whose regions are all at least size big, used when searching
+uint32_t sizeToBinRoundUp(uint32_t size);
+// bin a region of size belongs to
+uint32_t sizeToBinRoundDown(uint32_t size);
+// smallest size stored in the bin
+uint32_t binToSize(uint32_t bin);
+} // namespace offsetAllocator
+
+// Sub allocator for a buffer it does not own, like the LinearBufferManager it
+// only tracks offsets, such that the memory can live on the GPU. Same handles
+// and ranges as the LinearBufferManager, it can be dropped in its place.
+// After Sebastian Aaltonen's OffsetAllocator. Every region, free or used, is a
+// node linked to the nodes right before and after it in the buffer. Free nodes
+// sit in the list of their size bin, a two level bitmap tells which bins are
+// not empty, such that finding a region big enough is two bit scans. A freed
+// region is merged with its free neighbours, the buffer does not fragment in
+// ever smaller holes. Allocate and free are O(1). A search rounds the size up
+// to the next bin, a region can be up to 12.5% bigger than needed, the left
+// over is split off as a new free region.
+// Alignment moves the offset up inside the region found, the padding belongs
+// to the allocation until it is freed. If the region is too small once aligned
+// the search is redone with alignment - 1 bytes more.
+class OffsetAllocator {
+public:
+  static constexpr uint32_t DEFAULT_MAX_ALLOCATIONS = 128 * 1024;
+  // handles keep the node index in the low bits, the rest is a magic number
+  // to catch stale handles
+  static constexpr uint32_t HANDLE_INDEX_BITS = 22;
+  static constexpr uint32_t MAX_ALLOCATIONS = 1u << HANDLE_INDEX_BITS;
+
+public:
+  // maxAllocations bounds the number of regions, free or used, tracked at once
+  explicit OffsetAllocator(uint64_t bufferSizeInBytes,
+                           uint32_t maxAllocations = DEFAULT_MAX_ALLOCATIONS);
+  ~OffsetAllocator();
+
+  // invalid handle if nothing fits or all the nodes are in use
+  BufferRangeHandle allocate(uint64_t allocSizeInBytes, uint32_t alignment);
+  void free(BufferRangeHandle handle);
+  // drops every allocation, outstanding handles must not be used anymore
+  void clear();
+
+  [[nodiscard]] BufferRange getBufferRange(BufferRangeHandle handle) const;
+  [[nodiscard]] bool canAllocate(uint64_t allocSizeInBytes, uint32_t alignment = 1) const;
+
+  // getters
+  [[nodiscard]] uint64_t getBufferSizeInBytes() const { return m_bufferSizeInBytes; }
+  [[nodiscard]] uint32_t getAllocationsCount() const { return m_allocCount; }
+  [[nodiscard]] uint32_t getFreeRegionsCount() const { return m_freeRegionCount; }
+  [[nodiscard]] uint64_t getFreeBytes() const { return m_freeBytes; }
+  // a lower bound, the size of the bin of the biggest region
+  [[nodiscard]] uint64_t getLargestFreeRegion() const;
+
+  // deleted copy constructor and assignment operator
+  OffsetAllocator(const OffsetAllocator &) = delete;
+  OffsetAllocator &operator=(const OffsetAllocator &) = delete;
+
+private:
+  static constexpr uint32_t UNUSED = 0xFFFFFFFF;
+  static constexpr uint32_t HANDLE_INDEX_MASK = MAX_ALLOCATIONS - 1;
+
+  // no initializers, the node array is not touched until nodes get used
+  struct Node {
+    uint32_t dataOffset;
+    uint32_t dataSize;
+    // bytes skipped at the start of the region to align the allocation
+    uint32_t padding;
+    uint32_t requestedSize;
+    uint32_t binListPrev;
+    uint32_t binListNext;
+    uint32_t neighborPrev;
+    uint32_t neighborNext;
+    uint16_t magicNumber;
+    bool used;
+  };
+
+  uint32_t findFreeNode(uint32_t sizeInBytes) const;
+  uint32_t insertNodeIntoBin(uint32_t size, uint32_t dataOffset);
+  void removeNodeFromBin(uint32_t nodeIndex);
+  uint32_t acquireNode() {
+    // recycled nodes first, then the ones never used
+    if (m_freeNodeCount > 0) { return m_freeNodes[--m_freeNodeCount]; }
+    assert(m_nodeHighWaterMark < m_maxAllocations && "offset allocator ran out of nodes");
+    return m_nodeHighWaterMark++;
+  }
+  void releaseNode(uint32_t nodeIndex) { m_freeNodes[m_freeNodeCount++] = nodeIndex; }
+  bool hasFreeNode() const {
+    return (m_freeNodeCount > 0) | (m_nodeHighWaterMark < m_maxAllocations);
+  }
+  uint32_t findAlignedFreeNode(uint64_t allocSizeInBytes, uint32_t alignment) const;
+  uint32_t getNodeIndex(BufferRangeHandle handle) const;
+
+private:
+  uint64_t m_bufferSizeInBytes;
+  uint32_t m_maxAllocations;
+  uint32_t m_allocCount = 0;
+  uint32_t m_freeRegionCount = 0;
+  uint64_t m_freeBytes = 0;
+  uint16_t m_magicNumberCounter = 1;
+
+  uint32_t m_usedBinsTop = 0;
+  uint8_t m_usedBins[offsetAllocator::TOP_BIN_COUNT]{};
+  // first node of every bin list, UNUSED when empty
+  uint32_t m_binIndices[offsetAllocator::LEAF_BIN_COUNT]{};
+
+  Node *m_nodes = nullptr;
+  // released node indices, nodes past the high water mark were never used
+  uint32_t *m_freeNodes = nullptr;
+  uint32_t m_freeNodeCount = 0;
+  uint32_t m_nodeHighWaterMark = 0;
+};
+
+} // namespace SirMetal
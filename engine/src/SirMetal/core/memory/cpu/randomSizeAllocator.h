@@ -1,16 +1,62 @@
 #pragma once
 #include <assert.h>
+#include <stdint.h>
 
+#include <stdio.h>
+#include <string.h>
+
+#include "SirMetal/core/hashing/hashing.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/virtualArena.h"
+#include <algorithm>
 #include "vector"
 namespace SirMetal {
 
 struct RandomSizeAllocationHandle {
   uint32_t offset = 0;
-  uint16_t allocSize = 0;
-  uint16_t dataSize = 0;
+  uint32_t allocSize = 0;
+  uint32_t dataSize = 0;
   inline bool isHandleValid() const { return allocSize > 0; }
 };
 
+// Where compact() moved the live memory, one entry per run of live blocks that
+// moved, sorted by old offset. Handles in a run keep their relative position.
+struct RandomSizeAllocationRemap {
+  struct Range {
+    uint32_t oldOffset;
+    uint32_t newOffset;
+    uint32_t size;
+  };
+  std::vector<Range> ranges;
+
+  // handles not in any range did not move and are returned as they are
+  RandomSizeAllocationHandle remap(RandomSizeAllocationHandle handle) const {
+    uint32_t low = 0;
+    auto high = static_cast<uint32_t>(ranges.size());
+    while (low < high) {
+      const uint32_t middle = (low + high) / 2;
+      if (ranges[middle].oldOffset <= handle.offset) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    if (low == 0) { return handle; }
+    const Range &range = ranges[low - 1];
+    if (handle.offset - range.oldOffset < range.size) {
+      handle.offset = range.newOffset + (handle.offset - range.oldOffset);
+    }
+    return handle;
+  }
+};
+
+// Hands out offsets in a single range of memory. The memory itself is never
+// touched by the bookkeeping, free blocks are described out of band. They are
+// indexed by size in segregated lists with a two level bitmap, same layout as
+// the TlsfAllocator, such that finding a fitting block is a couple of bit scans,
+// and by start and end offset such that a freed block is merged with the free
+// blocks around it in constant time. Nothing is ever moved behind the user's
+// back, compact() does it on request and returns how handles moved.
 class RandomSizeAllocator final {
   static const int DEBUG_VALUE = 0xBEEFBAAD;
 
@@ -24,40 +70,62 @@ class RandomSizeAllocator final {
   }
 
  public:
-  RandomSizeAllocator() = default;
-  void initialize(const uint32_t totalSizeInByte,
-                  const int reservedAllocations = 20) {
-    m_memory = new char[totalSizeInByte];
+  RandomSizeAllocator() : m_freeByStart(FREE_MAP_BINS), m_freeByEnd(FREE_MAP_BINS) {
+    for (auto &lists : m_freeLists) {
+      for (uint32_t &list : lists) { list = NO_BLOCK; }
+    }
+  }
+  // the total size is only reserved, pages get committed as the unfragmented
+  // pointer moves up, so the allocator can be sized generously
+  void initialize(const uint32_t totalSizeInByte) {
+    const bool reserved = m_arena.reserve(totalSizeInByte);
+    assert(reserved && "could not reserve the allocator address range");
+    (void)reserved;
+    m_memory = m_arena.getBase();
     m_unfragmentedPtr = m_memory;
     m_end = m_memory + totalSizeInByte;
-    m_allocations.reserve(reservedAllocations);
-#if SE_DEBUG
-    set32BitMem(m_memory, totalSizeInByte, DEBUG_VALUE);
-#endif
   }
-  ~RandomSizeAllocator() { delete m_memory; }
 
-  RandomSizeAllocationHandle allocate(const uint16_t sizeInByte) {
-    // first inspect if we have any free allocation blocks
+  RandomSizeAllocationHandle allocate(const uint32_t sizeInByte) {
+    assert(sizeInByte > 0);
     RandomSizeAllocationHandle toReturnHandle;
-    const int allocCount = static_cast<int>(m_allocations.size());
-    const RandomSizeAllocationHandle *allocs = m_allocations.data();
-    int foundIndex = -1;
-    for (int i = 0; i < allocCount; ++i) {
-      if (sizeInByte <= allocs[i].allocSize) {
-        foundIndex = i;
-        break;
+    const uint32_t block = findFreeBlock(sizeInByte);
+    if (block != NO_BLOCK) {
+      const uint32_t blockOffset = m_blocks[block].offset;
+      const uint32_t blockSize = m_blocks[block].size;
+      removeFreeBlock(block);
+      toReturnHandle.offset = blockOffset;
+      toReturnHandle.allocSize = blockSize;
+      // splitting only if what is left is worth tracking, otherwise the block
+      // is handed out whole
+      if (blockSize - sizeInByte >= MIN_SPLIT_SIZE) {
+        toReturnHandle.allocSize = sizeInByte;
+        insertFreeBlock(blockOffset + sizeInByte, blockSize - sizeInByte);
       }
-    }
-    if (foundIndex != -1) {
-      toReturnHandle = m_allocations[foundIndex];
       toReturnHandle.dataSize = sizeInByte;
-      // patching the hole in the allocation list
-      m_allocations[foundIndex] = m_allocations[m_allocations.size() - 1];
-      m_allocations.pop_back();
     } else {
       // lets make a new allocation
-      assert(m_unfragmentedPtr + sizeInByte < m_end);
+      if (sizeInByte > static_cast<uint64_t>(m_end - m_unfragmentedPtr)) {
+        printf("[ERROR] Random size allocator out of memory, requested %u bytes\n",
+               sizeInByte);
+        assert(0 && "random size allocator out of memory");
+        return {};
+      }
+      const auto newTop = static_cast<uint64_t>(m_unfragmentedPtr - m_memory) + sizeInByte;
+      if (newTop > m_arena.getCommittedSize()) {
+        const uint64_t oldCommitted = m_arena.getCommittedSize();
+        if (!m_arena.commit(newTop)) {
+          printf("[ERROR] Random size allocator could not commit memory, requested %u bytes\n",
+                 sizeInByte);
+          assert(0 && "random size allocator could not commit memory");
+          return {};
+        }
+#if SE_DEBUG
+        set32BitMem(m_memory + oldCommitted,
+                    static_cast<int>(m_arena.getCommittedSize() - oldCommitted), DEBUG_VALUE);
+#endif
+        (void)oldCommitted;
+      }
       toReturnHandle.allocSize = sizeInByte;
       toReturnHandle.dataSize = sizeInByte;
       toReturnHandle.offset =
@@ -73,14 +141,89 @@ class RandomSizeAllocator final {
     return toReturnHandle;
   }
   inline char *getPointer(const RandomSizeAllocationHandle handle) const {
-    assert((m_memory + handle.offset + handle.allocSize) < m_end);
+    assert((m_memory + handle.offset + handle.allocSize) <= m_end);
     return m_memory + handle.offset;
   }
   void freeAllocation(const RandomSizeAllocationHandle handle) {
-    m_allocations.push_back(handle);
+    assert(handle.isHandleValid());
+    assert((handle.offset + handle.allocSize <=
+            static_cast<uint64_t>(m_unfragmentedPtr - m_memory)) &&
+           "freeing memory never handed out");
+    uint32_t block = NO_BLOCK;
 #if SE_DEBUG
+    // a freed block gets merged with its neighbours, a second free of it
+    // falls anywhere in a bigger free block, not only at its start. Walks
+    // every free block, too slow for the regular debug build
+    assert(!overlapsFreeBlock(handle.offset, handle.allocSize) && "double free");
     tagMemoryAsFreed(handle);
 #endif
+    uint32_t offset = handle.offset;
+    uint32_t size = handle.allocSize;
+    // merging with the free neighbours, at most one on each side since free
+    // blocks are always merged
+    if (m_freeByEnd.get(offset, block)) {
+      offset = m_blocks[block].offset;
+      size += m_blocks[block].size;
+      removeFreeBlock(block);
+    }
+    if (m_freeByStart.get(handle.offset + handle.allocSize, block)) {
+      size += m_blocks[block].size;
+      removeFreeBlock(block);
+    }
+    insertFreeBlock(offset, size);
+  }
+
+  // moves the live blocks down to close every hole, afterwards the allocator
+  // is one contiguous run of live memory followed by the unfragmented space.
+  // Every handle and pointer taken before becomes stale, handles have to go
+  // through the returned remap. Pages past the live memory are decommitted.
+  RandomSizeAllocationRemap compact() {
+    // the index is not address ordered, gathering the holes first
+    std::vector<RandomSizeAllocationRemap::Range> holes;
+    holes.reserve(m_freeBlockCount);
+    for (uint32_t fl = 0; fl < FL_COUNT; ++fl) {
+      for (uint32_t sl = 0; sl < SL_COUNT; ++sl) {
+        for (uint32_t block = m_freeLists[fl][sl]; block != NO_BLOCK;
+             block = m_blocks[block].next) {
+          holes.push_back({m_blocks[block].offset, 0, m_blocks[block].size});
+        }
+      }
+    }
+    std::sort(holes.begin(), holes.end(),
+              [](const RandomSizeAllocationRemap::Range &a,
+                 const RandomSizeAllocationRemap::Range &b) { return a.oldOffset < b.oldOffset; });
+
+    RandomSizeAllocationRemap remap;
+    uint32_t write = 0;
+    uint32_t read = 0;
+    const auto top = static_cast<uint32_t>(m_unfragmentedPtr - m_memory);
+    for (const auto &hole : holes) {
+      // the live run between the previous hole and this one
+      const uint32_t liveSize = hole.oldOffset - read;
+      if ((liveSize > 0) & (write != read)) {
+        memmove(m_memory + write, m_memory + read, liveSize);
+        remap.ranges.push_back({read, write, liveSize});
+      }
+      write += liveSize;
+      read = hole.oldOffset + hole.size;
+    }
+    if ((top > read) & (write != read)) {
+      memmove(m_memory + write, m_memory + read, top - read);
+      remap.ranges.push_back({read, write, top - read});
+    }
+    write += top - read;
+
+    for (const auto &hole : holes) {
+      uint32_t block = NO_BLOCK;
+      m_freeByStart.get(hole.oldOffset, block);
+      removeFreeBlock(block);
+    }
+    m_unfragmentedPtr = m_memory + write;
+#if SE_DEBUG
+    set32BitMem(m_unfragmentedPtr, static_cast<int>(top - write), DEBUG_VALUE);
+#endif
+    m_arena.decommit(write);
+    return remap;
   }
   inline void tagMemoryAsFreed(const RandomSizeAllocationHandle handle) {
     char *ptr = getPointer(handle);
@@ -98,8 +241,18 @@ class RandomSizeAllocator final {
     char *ptr = getPointer(handle);
     assert((reinterpret_cast<int *>(ptr)[0] == static_cast<int>(DEBUG_VALUE)));
   }
-  inline int getFreeBlocksCount() const {
-    return static_cast<int>(m_allocations.size());
+  inline int getFreeBlocksCount() const { return static_cast<int>(m_freeBlockCount); }
+  inline uint64_t getFreeBytes() const { return m_freeBytes; }
+  // walks the last non empty list, the biggest block is in there
+  uint32_t getLargestFreeBlock() const {
+    if (m_flBitmap == 0) { return 0; }
+    const uint32_t fl = highestBit(m_flBitmap);
+    const uint32_t sl = highestBit(m_slBitmap[fl]);
+    uint32_t largest = 0;
+    for (uint32_t block = m_freeLists[fl][sl]; block != NO_BLOCK; block = m_blocks[block].next) {
+      largest = m_blocks[block].size > largest ? m_blocks[block].size : largest;
+    }
+    return largest;
   }
 
   inline float getAllocatedAmount() const {
@@ -108,10 +261,185 @@ class RandomSizeAllocator final {
     return static_cast<float>(curr / range);
   }
 
+  // deleted copy constructor and assignment operator
+  RandomSizeAllocator(const RandomSizeAllocator &) = delete;
+  RandomSizeAllocator &operator=(const RandomSizeAllocator &) = delete;
+
+ private:
+  struct FreeBlock {
+    uint32_t offset;
+    uint32_t size;
+    // neighbours in the size list, next also links the recycled entries
+    uint32_t next;
+    uint32_t previous;
+  };
+
+  static constexpr uint32_t NO_BLOCK = 0xFFFFFFFF;
+  static constexpr uint32_t MIN_SPLIT_SIZE = 16;
+  static constexpr uint32_t FREE_MAP_BINS = 64;
+  // blocks looked at in a list for the best fit, lists are 1/16th of a power
+  // of two wide so past a few candidates the gain is not worth the walk
+  static constexpr uint32_t BEST_FIT_CANDIDATES = 8;
+  // see TlsfAllocator, sizes below SMALL_BLOCK_SIZE are split linearly
+  static constexpr uint32_t SL_LOG2 = 4;
+  static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+  static constexpr uint32_t FL_SHIFT = SL_LOG2 + 3;
+  static constexpr uint32_t SMALL_BLOCK_SIZE = 1u << FL_SHIFT;
+  static constexpr uint32_t SMALL_LIST_SIZE = SMALL_BLOCK_SIZE / SL_COUNT;
+  static constexpr uint32_t FL_COUNT = 32 - FL_SHIFT + 1;
+
+  static inline uint32_t lowestBit(const uint32_t mask) {
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+  }
+  static inline uint32_t highestBit(const uint32_t mask) {
+    return 31u - static_cast<uint32_t>(__builtin_clz(mask));
+  }
+
+  static inline void mapping(const uint32_t size, uint32_t &fl, uint32_t &sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+      fl = 0;
+      sl = size / SMALL_LIST_SIZE;
+    } else {
+      const uint32_t bit = highestBit(size);
+      fl = bit - (FL_SHIFT - 1);
+      sl = (size >> (bit - SL_LOG2)) ^ SL_COUNT;
+    }
+  }
+
+  // first size of the next list, every block from that list on fits
+  static inline uint64_t roundUpToList(const uint32_t size) {
+    if (size < SMALL_BLOCK_SIZE) {
+      return (static_cast<uint64_t>(size) + SMALL_LIST_SIZE - 1) & ~(SMALL_LIST_SIZE - 1);
+    }
+    return static_cast<uint64_t>(size) + (1u << (highestBit(size) - SL_LOG2)) - 1;
+  }
+
+  // moves fl/sl to the first non empty list at or after them
+  bool findSuitableList(uint32_t &fl, uint32_t &sl) const {
+    if (fl >= FL_COUNT) { return false; }
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+      const uint32_t flMap = m_flBitmap & (~0u << (fl + 1));
+      if (flMap == 0) { return false; }
+      fl = lowestBit(flMap);
+      slMap = m_slBitmap[fl];
+    }
+    sl = lowestBit(slMap);
+    return true;
+  }
+
+  // walks every free block, only meant for the SE_DEBUG checks
+  bool overlapsFreeBlock(const uint32_t offset, const uint32_t size) const {
+    for (uint32_t fl = 0; fl < FL_COUNT; ++fl) {
+      for (uint32_t sl = 0; sl < SL_COUNT; ++sl) {
+        for (uint32_t block = m_freeLists[fl][sl]; block != NO_BLOCK;
+             block = m_blocks[block].next) {
+          const FreeBlock &entry = m_blocks[block];
+          if ((entry.offset < offset + size) & (offset < entry.offset + entry.size)) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  // smallest block of at least sizeInByte among the first candidates of a list
+  uint32_t bestInList(const uint32_t head, const uint32_t sizeInByte) const {
+    uint32_t best = NO_BLOCK;
+    uint32_t candidates = 0;
+    for (uint32_t block = head; (block != NO_BLOCK) & (candidates < BEST_FIT_CANDIDATES);
+         block = m_blocks[block].next, ++candidates) {
+      const uint32_t size = m_blocks[block].size;
+      if ((size >= sizeInByte) & ((best == NO_BLOCK) || (size < m_blocks[best].size))) {
+        best = block;
+        if (size == sizeInByte) { break; }
+      }
+    }
+    return best;
+  }
+
+  uint32_t findFreeBlock(const uint32_t sizeInByte) const {
+    if (m_flBitmap == 0) { return NO_BLOCK; }
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    // the list of the size itself holds the tightest blocks, not all of them fit
+    mapping(sizeInByte, fl, sl);
+    const uint32_t tight = bestInList(m_freeLists[fl][sl], sizeInByte);
+    if (tight != NO_BLOCK) { return tight; }
+    // otherwise the first non empty list past it, anything in there fits
+    const uint64_t searchSize = roundUpToList(sizeInByte);
+    if (searchSize > UINT32_MAX) { return NO_BLOCK; }
+    mapping(static_cast<uint32_t>(searchSize), fl, sl);
+    if (!findSuitableList(fl, sl)) { return NO_BLOCK; }
+    return bestInList(m_freeLists[fl][sl], sizeInByte);
+  }
+
+  void insertFreeBlock(const uint32_t offset, const uint32_t size) {
+    uint32_t block = m_recycledBlocks;
+    if (block != NO_BLOCK) {
+      m_recycledBlocks = m_blocks[block].next;
+    } else {
+      block = static_cast<uint32_t>(m_blocks.size());
+      m_blocks.emplace_back();
+    }
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(size, fl, sl);
+    const uint32_t head = m_freeLists[fl][sl];
+    m_blocks[block] = {offset, size, head, NO_BLOCK};
+    if (head != NO_BLOCK) { m_blocks[head].previous = block; }
+    m_freeLists[fl][sl] = block;
+    m_flBitmap |= 1u << fl;
+    m_slBitmap[fl] |= 1u << sl;
+
+    m_freeByStart.insert(offset, block);
+    m_freeByEnd.insert(offset + size, block);
+    m_freeBytes += size;
+    ++m_freeBlockCount;
+  }
+
+  void removeFreeBlock(const uint32_t block) {
+    const FreeBlock &entry = m_blocks[block];
+    if (entry.next != NO_BLOCK) { m_blocks[entry.next].previous = entry.previous; }
+    if (entry.previous != NO_BLOCK) {
+      m_blocks[entry.previous].next = entry.next;
+    } else {
+      uint32_t fl = 0;
+      uint32_t sl = 0;
+      mapping(entry.size, fl, sl);
+      assert(m_freeLists[fl][sl] == block);
+      m_freeLists[fl][sl] = entry.next;
+      if (entry.next == NO_BLOCK) {
+        m_slBitmap[fl] &= ~(1u << sl);
+        if (m_slBitmap[fl] == 0) { m_flBitmap &= ~(1u << fl); }
+      }
+    }
+    m_freeByStart.remove(entry.offset);
+    m_freeByEnd.remove(entry.offset + entry.size);
+    m_freeBytes -= entry.size;
+    --m_freeBlockCount;
+
+    m_blocks[block].next = m_recycledBlocks;
+    m_recycledBlocks = block;
+  }
+
  private:
+  VirtualArena m_arena;
   char *m_memory = nullptr;
   char *m_unfragmentedPtr = nullptr;
   char *m_end = nullptr;
-  std::vector<RandomSizeAllocationHandle> m_allocations;
+  // free block descriptions, unused entries are chained from m_recycledBlocks
+  std::vector<FreeBlock> m_blocks;
+  uint32_t m_recycledBlocks = NO_BLOCK;
+  uint32_t m_flBitmap = 0;
+  uint32_t m_slBitmap[FL_COUNT]{};
+  // first block of every size list, NO_BLOCK when empty
+  uint32_t m_freeLists[FL_COUNT][SL_COUNT];
+  // offset where a free block starts or ends to its entry, for the merging
+  HashMap<uint32_t, uint32_t, hashUint32> m_freeByStart;
+  HashMap<uint32_t, uint32_t, hashUint32> m_freeByEnd;
+  uint64_t m_freeBytes = 0;
+  uint32_t m_freeBlockCount = 0;
 };
 }  // namespace SirMetal
@@ -3,6 +3,9 @@
 #include <cstdint>
 #include <cstring>
 
+#include "containerAllocators.h"
+#include "threeSizesPool.h"
+
 namespace SirMetal {
 
 /*
@@ -12,12 +15,15 @@ compilation. You can only use POD data, and or structures in pod data, what
 happens is a shallow copy when resizing or more memory required, if you have
 pointers there those won't be deep copied, which might be the intended
 behaviour, just bewhare!
+Memory comes from the given allocator, the heap if none is given, see
+containerAllocators.h for the allocator interface.
 */
-template <typename T>
+template <typename T, typename ALLOCATOR = ThreeSizesPool>
 class ResizableVector {
 
 public:
-  explicit ResizableVector(const uint32_t reserveSize = 0) {
+  explicit ResizableVector(const uint32_t reserveSize = 0, ALLOCATOR *alloc = nullptr)
+      : m_alloc(alloc) {
     m_size = 0;
     m_reserved = reserveSize;
     // allocate new memory if needed
@@ -104,13 +110,24 @@ public:
 
 private:
   void *allocateMemoryInternal(uint32_t size, uint8_t = 0) {
-      return new T[size];
+    if (m_alloc != nullptr) { return m_alloc->allocate(sizeof(T) * size); }
+    return new T[size];
   }
-  void freeMemoryInternal(void *memory) {
-      delete[] m_memory;
+  void freeMemoryInternal(T *memory) {
+    if (m_alloc != nullptr) {
+      if (memory != nullptr) { m_alloc->free(memory); }
+    } else {
+      delete[] memory;
+    }
   }
 
   void reallocateMemoryInternal(const uint32_t newSize) {
+    if constexpr (canGrowInPlace<ALLOCATOR>::value) {
+      if ((m_alloc != nullptr) && (m_memory != nullptr) &&
+          m_alloc->tryGrowInPlace(m_memory, static_cast<uint64_t>(sizeof(T)) * newSize)) {
+        return;
+      }
+    }
     T *tempMemory = reinterpret_cast<T *>(allocateMemoryInternal(newSize));
     if ((m_size != 0) & (m_memory != nullptr)) {
       memcpy(tempMemory, m_memory, m_size * sizeof(T));
@@ -124,6 +141,7 @@ private:
   }
 
 private:
+  ALLOCATOR *m_alloc = nullptr;
   T *m_memory = nullptr;
   uint32_t m_size;
   uint32_t m_reserved;
@@ -1,6 +1,8 @@
 #pragma once
 #include "threeSizesPool.h"
 
+#include <algorithm>
+
 namespace SirMetal {
 
 template <typename T, int SMALL_SIZE_OPTIMIZATION = 10,
@@ -11,12 +13,8 @@ public:
 
     assert(size > 0);
     m_size = size;
-    // init membuffer
-#ifdef _DEBUG
-    memset(m_internalBuffer, 0xFF, sizeof(T) * SMALL_SIZE_OPTIMIZATION);
-#else
-    memset(m_internalBuffer, 0, sizeof(T) * SMALL_SIZE_OPTIMIZATION);
-#endif
+    // init membuffer, value initialized, T is not always trivial
+    std::fill_n(m_internalBuffer, SMALL_SIZE_OPTIMIZATION, T{});
 
     m_alloc = alloc;
     if (size < SMALL_SIZE_OPTIMIZATION) {
@@ -0,0 +1,118 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+#include "SirMetal/resources/handle.h"
+
+namespace SirMetal {
+
+// Storage for the resources behind a handle. Values live in a flat array
+// indexed straight by the handle index, removed slots go on a free list and
+// get reused by the next insert. Every slot has a generation which is bumped
+// on remove and is encoded in the handle, a lookup with a handle from an older
+// generation fails instead of returning whatever reused the slot.
+// The generation has HANDLE_GENERATION_BITS bits, it wraps after that many
+// reuses of the same slot, stale handle detection is a debugging aid not a
+// guarantee.
+template <typename T, typename HANDLE>
+class SlotMap {
+public:
+  explicit SlotMap(const uint32_t reserveSize = 0) {
+    m_values.reserve(reserveSize);
+    m_slots.reserve(reserveSize);
+  }
+
+  HANDLE insert(const T &value) {
+    T copy = value;
+    return insert(std::move(copy));
+  }
+
+  HANDLE insert(T &&value) {
+    uint32_t index;
+    if (!m_freeList.empty()) {
+      index = m_freeList.back();
+      m_freeList.pop_back();
+      m_values[index] = std::move(value);
+    } else {
+      index = static_cast<uint32_t>(m_values.size());
+      if (index > HANDLE_MAX_INDEX) {
+        printf("[ERROR] Slot map ran out of handle indices, max is %u\n",
+               HANDLE_MAX_INDEX);
+        assert(0 && "slot map is full");
+        return {};
+      }
+      m_values.emplace_back(std::move(value));
+      m_slots.emplace_back(Slot{});
+    }
+    m_slots[index].used = true;
+    ++m_usedSlots;
+    return getHandle<HANDLE>(index, m_slots[index].generation);
+  }
+
+  // returns nullptr if the handle is stale or was never handed out
+  inline T *get(const HANDLE handle) {
+    return isValid(handle) ? &m_values[getIndexFromHandle(handle)] : nullptr;
+  }
+  inline const T *get(const HANDLE handle) const {
+    return isValid(handle) ? &m_values[getIndexFromHandle(handle)] : nullptr;
+  }
+
+  [[nodiscard]] inline bool isValid(const HANDLE handle) const {
+    assert(!handle.isHandleValid() || getTypeFromHandle(handle) == HANDLE::type);
+    const uint32_t index = getIndexFromHandle(handle);
+    if ((!handle.isHandleValid()) | (index >= m_slots.size())) { return false; }
+    const Slot &slot = m_slots[index];
+    return slot.used & (slot.generation == getGenerationFromHandle(handle));
+  }
+
+  bool remove(const HANDLE handle) {
+    if (!isValid(handle)) { return false; }
+    const uint32_t index = getIndexFromHandle(handle);
+    // resetting the value so whatever it holds is released now and not when
+    // the slot is reused
+    m_values[index] = T{};
+    Slot &slot = m_slots[index];
+    slot.used = false;
+    slot.generation = static_cast<uint8_t>((slot.generation + 1) & HANDLE_GENERATION_MASK);
+    m_freeList.push_back(index);
+    --m_usedSlots;
+    return true;
+  }
+
+  // calls fn(HANDLE, T&) for every live value, in slot order
+  template <typename FN>
+  void forEach(FN fn) {
+    const auto count = static_cast<uint32_t>(m_slots.size());
+    for (uint32_t i = 0; i < count; ++i) {
+      if (m_slots[i].used) { fn(getHandle<HANDLE>(i, m_slots[i].generation), m_values[i]); }
+    }
+  }
+
+  // removes everything, outstanding handles become stale
+  void clear() {
+    const auto count = static_cast<uint32_t>(m_slots.size());
+    for (uint32_t i = 0; i < count; ++i) {
+      if (m_slots[i].used) { remove(getHandle<HANDLE>(i, m_slots[i].generation)); }
+    }
+  }
+
+  [[nodiscard]] uint32_t size() const { return m_usedSlots; }
+  [[nodiscard]] uint32_t slotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+
+private:
+  struct Slot {
+    uint8_t generation = 0;
+    bool used = false;
+  };
+
+private:
+  std::vector<T> m_values;
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_freeList;
+  uint32_t m_usedSlots = 0;
+};
+
+} // namespace SirMetal
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <new>
 
 namespace SirMetal {
 
@@ -10,20 +11,21 @@ namespace SirMetal {
 // actual hard guarantees that the memory will actually be contiguous
 
 // the way it works is the following, you have a memory pool, which gets
-// allocated at the beginning. The memory gets initialized by a linked list,
-// which is a fancy term for index of the next available slot.
-// this mean the Nth index array will be initialized from Nth+1,
-// for example starting from zero memory will be set as 1,2,3,4...
-
-// the next empty slots starts at zero, when an allocation is made,
-// the nextAllocation slot is used and the value at which the slot points
-// to will be set as nextAllocation, for example if you do your first allocation
-// the address of memory[0] will be returned and nextAllocation will be 1,
-// because that is the value that memory[0] holds at the beginning.
-
-// deletion works in a similar fashion, once a slot is freed, in the current
-// freed slot we store the current nextAllocation slot, and nextAllocation slot
-// gets set to the newly freed index.
+// allocated at the beginning but not touched. Slots are handed out in two
+// ways, a high water mark tells how many slots have ever been used, anything
+// past it is fresh and handed out sequentially. Freed slots go on a linked
+// list, which is a fancy term for the index of the next freed slot stored in
+// the freed slot itself.
+
+// an allocation first pops the freed list, when it is empty the slot at the
+// high water mark is used and the mark moves up. For example the first
+// allocation returns memory[0] and moves the mark to 1.
+
+// deletion pushes on the freed list, in the current freed slot we store the
+// current nextAllocation slot, and nextAllocation slot gets set to the newly
+// freed index. Clearing the pool is dropping the list and the mark, no slot
+// is visited, and the pages of the pool only get touched once the mark
+// reaches them.
 
 template <typename T>
 class SparseMemoryPool final {
@@ -33,9 +35,10 @@ class SparseMemoryPool final {
     // to store the "linked list" in the same memory.
     assert(sizeof(T) >= 4);
 
-    m_memory = new T[poolSize];
+    // raw memory, slots are constructed when the mark first reaches them
+    m_memory = static_cast<T *>(
+        ::operator new(sizeof(T) * poolSize, std::align_val_t{alignof(T)}));
     m_poolSize = poolSize;
-    setupLinkedList();
 
 #if SE_DEBUG
     m_freedMemory = new char[poolSize];
@@ -44,9 +47,9 @@ class SparseMemoryPool final {
   };
 
   ~SparseMemoryPool() {
-    delete m_memory;
+    ::operator delete(m_memory, std::align_val_t{alignof(T)});
 #if SE_DEBUG
-    delete m_freedMemory;
+    delete[] m_freedMemory;
 #endif
   };
   SparseMemoryPool(const SparseMemoryPool &) = delete;
@@ -56,9 +59,15 @@ class SparseMemoryPool final {
     assert(m_allocationCount < m_poolSize &&
            "requested deallocation is outside pool range");
 
-    index = m_nextAllocation;
-    m_nextAllocation =
-        *(reinterpret_cast<uint32_t *>(&m_memory[m_nextAllocation]));
+    if (m_nextAllocation != NO_FREED_SLOT) {
+      index = m_nextAllocation;
+      m_nextAllocation =
+          *(reinterpret_cast<uint32_t *>(&m_memory[m_nextAllocation]));
+    } else {
+      // nothing freed, taking a fresh slot
+      index = m_highWaterMark++;
+      new (&m_memory[index]) T{};
+    }
     ++m_allocationCount;
 #if SE_DEBUG
     m_memory[index] = T{};
@@ -68,6 +77,7 @@ class SparseMemoryPool final {
     return m_memory[index];
   }
   inline void free(const uint32_t index) {
+    assert(index < m_highWaterMark && "freeing a slot that was never allocated");
 #if SE_DEBUG
     assert(m_freedMemory[index] == 0 && "memory has been already deallocated");
     m_freedMemory[index] = 1;
@@ -93,6 +103,8 @@ class SparseMemoryPool final {
     return m_memory[index];
   }
   inline uint32_t getPoolSize() const { return m_poolSize; }
+  // how many slots have been used since creation or the last clear
+  inline uint32_t getHighWaterMark() const { return m_highWaterMark; }
 
 #if SE_DEBUG
   bool assertEverythingDealloc() const {
@@ -104,32 +116,27 @@ class SparseMemoryPool final {
     return toReturn;
   }
 #endif
-  // TODO can we avoid the setup of linked list somehow?
-  // to note this is not a fast operation, the whole pool is getting
-  // iterate to set the linked list of allocations
+  // constant time, whatever is in the pool is dropped, slots are reused from
+  // the start as if the pool was new
   void clear() {
-    setupLinkedList();
-    m_nextAllocation = 0;
-    m_allocationCount = 0;
 #if SE_DEBUG
-    // clearing the debug memory to zero
-    memset(m_freedMemory, 1, sizeof(char) * m_poolSize);
+    // clearing the debug memory, past the mark it was never touched
+    memset(m_freedMemory, 1, sizeof(char) * m_highWaterMark);
 #endif
+    m_nextAllocation = NO_FREED_SLOT;
+    m_highWaterMark = 0;
+    m_allocationCount = 0;
   }
 
  private:
-  inline void setupLinkedList() {
-    // initializing the "linked list", nextAlloc is already init to 0;
-    for (uint32_t i = 0; i < m_poolSize; ++i) {
-      *(reinterpret_cast<uint32_t *>(&m_memory[i])) = i + 1;
-    }
-  }
+  static constexpr uint32_t NO_FREED_SLOT = 0xFFFFFFFF;
 
- private:
   T *m_memory = nullptr;
   uint32_t m_poolSize;
   uint32_t m_allocationCount = 0;
-  uint32_t m_nextAllocation = 0;
+  // head of the freed slots list
+  uint32_t m_nextAllocation = NO_FREED_SLOT;
+  uint32_t m_highWaterMark = 0;
 #if SE_DEBUG
   char *m_freedMemory = nullptr;
 #endif
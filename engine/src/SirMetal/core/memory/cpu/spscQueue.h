@@ -0,0 +1,121 @@
+#pragma once
+#include <assert.h>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace SirMetal {
+
+// size the producer and consumer sides of the lock free queues are padded to,
+// such that the two threads do not fight over the same cache line
+static constexpr size_t QUEUE_CACHE_LINE_SIZE = 64;
+
+inline uint32_t roundUpToPowerOfTwo(uint32_t value) {
+  assert(value > 0 && value <= (1u << 31));
+  --value;
+  value |= value >> 1;
+  value |= value >> 2;
+  value |= value >> 4;
+  value |= value >> 8;
+  value |= value >> 16;
+  return value + 1;
+}
+
+// Bounded lock free queue for exactly one producer thread and one consumer
+// thread, for example a loader thread handing work to the render thread.
+// Capacity is rounded up to a power of two, head and tail are free running
+// counters and the slot is a mask of them, no modulo. Head is only written by
+// the consumer and tail only by the producer, each on its own cache line. Each
+// side also keeps the last value it read of the other side, the shared line is
+// only read again when the cached value says the queue is full or empty.
+// Batch push and pop publish a whole batch with a single store.
+template <typename T>
+class SpscQueue final {
+public:
+  explicit SpscQueue(const uint32_t capacity) {
+    m_capacity = roundUpToPowerOfTwo(capacity);
+    m_mask = m_capacity - 1;
+    m_buffer = new T[m_capacity];
+  }
+  ~SpscQueue() { delete[] m_buffer; }
+
+  // producer side, false if the queue is full
+  bool push(const T &value) {
+    T copy = value;
+    return push(std::move(copy));
+  }
+  bool push(T &&value) {
+    const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead == m_capacity) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead == m_capacity) { return false; }
+    }
+    m_buffer[tail & m_mask] = std::move(value);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  // pushes as many values as fit, returns how many were pushed
+  uint32_t pushBatch(const T *values, const uint32_t count) {
+    const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t room = m_capacity - (tail - m_cachedHead);
+    if (room < count) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      room = m_capacity - (tail - m_cachedHead);
+    }
+    const uint32_t toPush = count < room ? count : room;
+    for (uint32_t i = 0; i < toPush; ++i) { m_buffer[(tail + i) & m_mask] = values[i]; }
+    m_tail.store(tail + toPush, std::memory_order_release);
+    return toPush;
+  }
+
+  // consumer side, false if the queue is empty
+  bool pop(T &value) {
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail) { return false; }
+    }
+    value = std::move(m_buffer[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+  // pops up to maxCount values, returns how many were popped
+  uint32_t popBatch(T *values, const uint32_t maxCount) {
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t available = m_cachedTail - head;
+    if (available < maxCount) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      available = m_cachedTail - head;
+    }
+    const uint32_t toPop = maxCount < available ? maxCount : available;
+    for (uint32_t i = 0; i < toPop; ++i) { values[i] = std::move(m_buffer[(head + i) & m_mask]); }
+    m_head.store(head + toPop, std::memory_order_release);
+    return toPop;
+  }
+
+  // exact only when called from one of the two sides with the other idle
+  [[nodiscard]] uint32_t sizeApprox() const {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] bool isEmptyApprox() const { return sizeApprox() == 0; }
+  [[nodiscard]] uint32_t capacity() const { return m_capacity; }
+
+  // deleted copy constructor and assignment operator
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+private:
+  // consumer owned
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<uint32_t> m_head{0};
+  uint32_t m_cachedTail = 0;
+  // producer owned
+  alignas(QUEUE_CACHE_LINE_SIZE) std::atomic<uint32_t> m_tail{0};
+  uint32_t m_cachedHead = 0;
+  // read only after construction
+  alignas(QUEUE_CACHE_LINE_SIZE) T *m_buffer = nullptr;
+  uint32_t m_capacity = 0;
+  uint32_t m_mask = 0;
+};
+
+} // namespace SirMetal
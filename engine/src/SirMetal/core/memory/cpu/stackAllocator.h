@@ -1,23 +1,81 @@
 #pragma once
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "SirMetal/core/memory/cpu/virtualArena.h"
 
 // not thread safe
 namespace SirMetal {
 
 class StackAllocator final {
  public:
+  // position of the stack pointer, everything allocated after it can be
+  // released in one go with freeToMarker
+  struct Marker {
+    size_t offset;
+  };
+
+  // rewinds the stack to where it was when the scope was created, scopes can
+  // be nested as long as they go away in reverse order, which C++ scoping
+  // does for us
+  class Scope final {
+   public:
+    explicit Scope(StackAllocator &allocator)
+        : m_allocator(allocator), m_marker(allocator.getMarker()) {}
+    ~Scope() { m_allocator.freeToMarker(m_marker); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    StackAllocator &m_allocator;
+    Marker m_marker;
+  };
+
   StackAllocator() = default;
-  ~StackAllocator() { delete[] m_start; }
+  ~StackAllocator() {
+    if (m_ownsMemory) { delete[] m_start; }
+    delete m_arena;
+  }
 
-  // request n bytes of memory
-  void *allocate(const size_t sizeInByte) {
+  // request n bytes of memory, alignment needs to be a power of two, returns
+  // nullptr if the stack does not have enough memory left
+  void *allocate(const size_t sizeInByte, const size_t alignment = 1) {
     assert(isAllocatorValid());
-    char *basePtr = m_SP;
-    m_SP += sizeInByte;
+    assert((alignment != 0) && ((alignment & (alignment - 1)) == 0) &&
+           "alignment needs to be a power of two");
+    const auto address = reinterpret_cast<uintptr_t>(m_SP);
+    const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+    if ((padding + sizeInByte > static_cast<size_t>(m_end - m_SP)) &&
+        !growVirtual(static_cast<size_t>(m_SP - m_start) + padding + sizeInByte)) {
+      printf("[ERROR] Stack allocator out of memory, requested %zu bytes with "
+             "%zu left\n",
+             sizeInByte, static_cast<size_t>(m_end - m_SP));
+      assert(0 && "stack allocator out of memory");
+      return nullptr;
+    }
+    char *basePtr = m_SP + padding;
+    m_SP = basePtr + sizeInByte;
     assert(isAllocatorValid());
     return basePtr;
   }
 
+  // uninitialized memory for count elements aligned for T
+  template <typename T>
+  T *allocateArray(const size_t count) {
+    return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  Marker getMarker() const { return Marker{static_cast<size_t>(m_SP - m_start)}; }
+  void freeToMarker(const Marker marker) {
+    assert(isAllocatorValid());
+    assert(marker.offset <= static_cast<size_t>(m_SP - m_start) &&
+           "marker is past the stack pointer, scopes rewound out of order?");
+    m_SP = m_start + marker.offset;
+  }
+
   inline void reset() { m_SP = m_start; };
 
   // free bits from the top of the stack
@@ -32,11 +90,41 @@ class StackAllocator final {
     assert(m_start == nullptr);
     assert(m_end == nullptr);
     m_start = new char[sizeInByte];
+    m_ownsMemory = true;
     m_SP = m_start;
     m_end = m_start + sizeInByte;
     assert(isAllocatorValid());
   };
 
+  // reserves the address range of the stack and commits pages as the stack
+  // pointer goes up, the stack can then be sized for the worst case at no cost
+  // and grows without ever moving
+  void initializeVirtual(const size_t reserveSizeInByte,
+                         const uint32_t flags = VIRTUAL_ARENA_FLAG_NONE) {
+    assert(m_start == nullptr);
+    assert(m_end == nullptr);
+    m_arena = new VirtualArena();
+    const bool reserved = m_arena->reserve(reserveSizeInByte, flags);
+    assert(reserved && "could not reserve the stack address range");
+    // committing a first chunk, an empty stack is not a valid one
+    m_arena->commit(1);
+    m_start = m_arena->getBase();
+    m_SP = m_start;
+    m_end = m_start + m_arena->getCommittedSize();
+    assert(isAllocatorValid());
+    (void)reserved;
+  }
+
+  // gives the pages past the stack pointer back to the OS, for a virtual stack
+  // after a big temporary use, like a level load
+  void decommitUnused() {
+    if (m_arena == nullptr) { return; }
+    const size_t used = static_cast<size_t>(m_SP - m_start);
+    m_arena->decommit(used > 0 ? used : 1);
+    m_end = m_start + m_arena->getCommittedSize();
+    assert(isAllocatorValid());
+  }
+
   // this function  won't allocate anything but will get initialized
   // from a start and end and manage that memory, won't own it
   void setMemoryStartEnd(void *start, void *end) {
@@ -62,18 +150,28 @@ class StackAllocator final {
   void *getStartPtr() const { return m_start; }
   void *getStackPtr() const { return m_SP; }
   void *getEndPtr() const { return m_end; }
+  size_t getUsedBytes() const { return static_cast<size_t>(m_SP - m_start); }
+  // committed size for a virtual stack
+  size_t getSizeInByte() const { return static_cast<size_t>(m_end - m_start); }
+  bool isVirtual() const { return m_arena != nullptr; }
 
   // deleted copy constructor and assignment operator
   StackAllocator(StackAllocator const &) = delete;
   StackAllocator &operator=(StackAllocator const &) = delete;
 
  private:
+  bool growVirtual(const size_t requiredSizeInByte) {
+    if ((m_arena == nullptr) || !m_arena->commit(requiredSizeInByte)) { return false; }
+    m_end = m_start + m_arena->getCommittedSize();
+    return true;
+  }
+
   bool isAllocatorValid() const {
     assert(m_start != nullptr);
     assert(m_end != nullptr);
     assert(m_SP != nullptr);
     assert((static_cast<char *>(m_end) > static_cast<char *>(m_start)));
-    assert(m_SP < m_end);
+    assert(m_SP <= m_end);
     assert(m_SP >= m_start);
     return true;
   }
@@ -83,6 +181,8 @@ class StackAllocator final {
   char *m_SP{nullptr};
   char *m_start{nullptr};
   char *m_end{nullptr};
+  bool m_ownsMemory = false;
+  VirtualArena *m_arena = nullptr;
 };
 
 }  // namespace SirMetal
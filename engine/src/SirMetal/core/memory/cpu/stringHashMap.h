@@ -2,106 +2,201 @@
 
 #include <string.h>
 
-#include "SirMetal/core/hashing.h"
+#include "SirMetal/core/hashing/hashing.h"
 #include "SirMetal/core/memory/cpu/hashMap.h"
 #include "stringPool.h"
 
 namespace SirMetal {
 
-template <typename VALUE>
-class HashMap<const char *, VALUE, hashString32> {
+// string specialization of the HashMap, keys are internalized in the global
+// string pool. Same layout and growth policy as the generic version: power of
+// two bins, one control byte per bin probed a group at the time, rehash when the
+// occupied bins go over the max load factor. The full 32 bit hash is stored per
+// bin, a tag match with a different hash is rejected without touching the
+// string and a rehash never hashes the strings again. Every lookup has an
+// overload taking the hash, for callers that already have it at hand.
+template <typename VALUE, typename ALLOCATOR>
+class HashMap<const char *, VALUE, hashString32, ALLOCATOR> {
  public:
-  // TODO add use of engine allocator, not only heap allocations
-  explicit HashMap(const uint32_t bins) : m_bins(bins) {
-    m_keys = new const char *[m_bins];
-    m_values = new VALUE[m_bins];
-    const int count = ((m_bins * BIN_FLAGS_SIZE) / (8 * sizeof(uint32_t))) + 1;
-    m_metadata = new uint32_t[count];
-    // 85 is 01010101 in binary this means we fill 4 bins with the value of 1,
-    // meaning free
-    memset(m_keys, 0, m_bins * sizeof(char *));
-    memset(m_metadata, 85, count * sizeof(uint32_t));
+  // bins is rounded up to the next power of two, the key strings always live
+  // in the global string pool, the allocator is used for the bins
+  explicit HashMap(const uint32_t bins, ALLOCATOR *alloc = nullptr)
+      : m_alloc(alloc) {
+    allocateBins(computeBinCount(bins));
   }
 
   ~HashMap() {
-    delete[] m_keys;
-    delete[] m_values;
-    delete[] m_metadata;
+    for (uint32_t i = 0; i < m_bins; ++i) {
+      if (isBinUsed(i)) {
+        globals::STRING_POOL->free(m_keys[i]);
+      }
+    }
+    freeBins();
   }
   bool insert(const char *key, VALUE value) {
-    const uint32_t computedHash = hashString32(key);
-
-    // modding wit the bin count
-    uint32_t bin = computedHash % m_bins;
-    uint32_t meta = getMetadata(bin);
-    if ((m_keys[bin] != nullptr && strcmp(m_keys[bin], key) == 0) &
-        (meta == static_cast<uint32_t>(BIN_FLAGS::USED))) {
+    return insert(key, hashString32(key), value);
+  }
+  // hash must be hashString32(key)
+  bool insert(const char *key, const uint32_t hash, VALUE value) {
+    assert(hash == hashString32(key));
+    uint32_t bin = 0;
+    if (findBin(key, hash, bin)) {
       // key exists we just override the value
       m_values[bin] = value;
       return true;
     }
 
-    const uint32_t startBin = bin;
-    //this might still fail if you actually store null pointer as a string.
-    bool free = canWriteToBin(meta);
-    while ((!free) && !(m_keys[bin] != nullptr && strcmp(m_keys[bin], key) == 0)) {
-      ++bin;
-      bin = bin % m_bins;  // wrap around the bins count
-      meta = getMetadata(bin);
-      free = canWriteToBin(meta);
-      if (bin == startBin) {
-        return false;
-      }
+    // making sure there is room before picking a bin, this guarantees at least
+    // one free bin so lookups always terminate. Tombstones make every miss probe
+    // further, past a threshold they get purged by an in place rehash, the cost
+    // is amortized over the removes that created them
+    if (isOverPercent(m_deletedBins, MAX_DELETED_PERCENT)) {
+      rehash(m_bins);
+    } else if (isOverPercent(m_usedBins + m_deletedBins + 1,
+                             MAX_LOAD_FACTOR_PERCENT)) {
+      grow();
+    }
+
+    // key is not in the map, first free or deleted bin in the probe sequence
+    bin = findInsertBin(hash);
+    if (m_control[bin] == hashMapControl::DELETED) {
+      --m_deletedBins;
     }
     const char *newKey = globals::STRING_POOL->allocatePersistent(key);
-    writeToBin(bin, newKey, value);
-    setMetadata(bin, BIN_FLAGS::USED);
+    writeToBin(bin, newKey, hash, value);
+    setControl(bin, hashMapControl::tag(hash));
 
     return true;
   }
 
+  // makes sure count elements can be stored without triggering a rehash
+  void reserve(const uint32_t count) {
+    const uint32_t required = computeBinCount(static_cast<uint32_t>(
+        (static_cast<uint64_t>(count) * 100) / MAX_LOAD_FACTOR_PERCENT + 1));
+    if (required > m_bins) {
+      rehash(required);
+    }
+  }
+
   [[nodiscard]] bool containsKey(const char *key) const {
+    return containsKey(key, hashString32(key));
+  }
+  [[nodiscard]] bool containsKey(const char *key, const uint32_t hash) const {
     uint32_t bin = 0;
-    const bool isKeyFound = getBin(key, bin);
-    const uint32_t meta = getMetadata(bin);
-    return isKeyFound &
-           (m_keys[bin] != nullptr &&
-            strcmp(m_keys[bin], key) == 0)  // does the key match?
-           &
-           (meta == static_cast<uint32_t>(
-                        BIN_FLAGS::USED));  // is the bin actually used, we dont
-                                            // delete anything so if they key is
-                                            // deleted key value might still
-                                            // match but metadata is set to free
+    return findBin(key, hash, bin);
   }
 
   inline bool get(const char *key, VALUE &value) const {
+    return get(key, hashString32(key), value);
+  }
+  inline bool get(const char *key, const uint32_t hash, VALUE &value) const {
     uint32_t bin = 0;
-    const bool result = getBin(key, bin);
-    value = m_values[bin];
+    const bool result = findBin(key, hash, bin);
+    if (result) {
+      value = m_values[bin];
+    }
     return result;
   }
 
+  // looks up count keys, found[i] tells whether values[i] was written. All the
+  // keys of a chunk get hashed and their home bins prefetched before probing,
+  // such that the cache misses of the chunk overlap. hashes is optional, when
+  // given it must hold hashString32 of every key
+  void getBatch(const char *const *keys, VALUE *values, bool *found,
+                const uint32_t count, const uint32_t *hashes = nullptr) const {
+    uint32_t chunkHashes[hashMapControl::BATCH_SIZE];
+    for (uint32_t start = 0; start < count;
+         start += hashMapControl::BATCH_SIZE) {
+      const uint32_t left = count - start;
+      const uint32_t chunk = left < hashMapControl::BATCH_SIZE
+                                 ? left
+                                 : hashMapControl::BATCH_SIZE;
+      for (uint32_t i = 0; i < chunk; ++i) {
+        chunkHashes[i] = hashes != nullptr ? hashes[start + i]
+                                           : hashString32(keys[start + i]);
+        const uint32_t home = hashMapControl::home(chunkHashes[i]) & m_mask;
+        hashMapControl::prefetch(m_control + home);
+        hashMapControl::prefetch(m_hashes + home);
+      }
+      for (uint32_t i = 0; i < chunk; ++i) {
+        uint32_t bin = 0;
+        const bool result = findBin(keys[start + i], chunkHashes[i], bin);
+        found[start + i] = result;
+        if (result) {
+          values[start + i] = m_values[bin];
+        }
+      }
+    }
+  }
+
+  // returns a pointer to the value, nullptr if the key is not found. The
+  // pointer is invalidated by the next insert
+  inline VALUE *find(const char *key) { return find(key, hashString32(key)); }
+  inline VALUE *find(const char *key, const uint32_t precomputedHash) {
+    uint32_t bin = 0;
+    return findBin(key, precomputedHash, bin) ? &m_values[bin] : nullptr;
+  }
+  inline const VALUE *find(const char *key) const {
+    return find(key, hashString32(key));
+  }
+  inline const VALUE *find(const char *key,
+                           const uint32_t precomputedHash) const {
+    uint32_t bin = 0;
+    return findBin(key, precomputedHash, bin) ? &m_values[bin] : nullptr;
+  }
+
   inline bool remove(const char *key) {
+    return remove(key, hashString32(key));
+  }
+  inline bool remove(const char *key, const uint32_t hash) {
     uint32_t bin = 0;
-    const bool result = getBin(key, bin);
-    const uint32_t meta = getMetadata(bin);
-    assert(meta == static_cast<uint32_t>(BIN_FLAGS::USED));
+    const bool result = findBin(key, hash, bin);
     if (result) {
-      setMetadata(bin, BIN_FLAGS::DELETED);
       globals::STRING_POOL->free(m_keys[bin]);
       m_keys[bin] = nullptr;
       --m_usedBins;
+      // only leaving a tombstone when a probe sequence might go through the bin
+      if (hashMapControl::canFreeOnRemove(m_control, bin, m_mask)) {
+        setControl(bin, hashMapControl::FREE);
+      } else {
+        setControl(bin, hashMapControl::DELETED);
+        ++m_deletedBins;
+      }
     }
     return result;
   }
 
   [[nodiscard]] uint32_t getUsedBins() const { return m_usedBins; }
+  [[nodiscard]] uint32_t getDeletedBins() const { return m_deletedBins; }
+  HashMapStats getStats() const {
+    HashMapStats stats;
+    stats.binCount = m_bins;
+    stats.usedBins = m_usedBins;
+    stats.deletedBins = m_deletedBins;
+    uint64_t totalProbe = 0;
+    for (uint32_t bin = 0; bin < m_bins; ++bin) {
+      if (!hashMapControl::isUsed(m_control[bin])) {
+        continue;
+      }
+      const uint32_t probe = probeLength(bin);
+      totalProbe += probe;
+      stats.maxProbeLength =
+          probe > stats.maxProbeLength ? probe : stats.maxProbeLength;
+    }
+    stats.averageProbeLength =
+        m_usedBins ? static_cast<float>(totalProbe) / m_usedBins : 0.0f;
+    return stats;
+  }
   inline uint32_t binCount() const { return m_bins; }
   inline bool isBinUsed(const uint32_t bin) const {
     assert(bin < m_bins);
-    uint32_t meta = getMetadata(bin);
-    return meta == static_cast<uint32_t>(BIN_FLAGS::USED);
+    return hashMapControl::isUsed(m_control[bin]);
+  }
+  // distance in bins of the key stored at bin from its home bin
+  inline uint32_t probeLength(const uint32_t bin) const {
+    // no check done whether the bin is used or not, up to you kid
+    assert(bin < m_bins);
+    return (bin - hashMapControl::home(m_hashes[bin])) & m_mask;
   }
 
   const char *getKeyAtBin(const uint32_t bin) const {
@@ -119,77 +214,162 @@ class HashMap<const char *, VALUE, hashString32> {
   HashMap(const HashMap &) = delete;
   HashMap &operator=(const HashMap &) = delete;
 
+  static constexpr uint32_t MAX_LOAD_FACTOR_PERCENT = 75;
+  static constexpr uint32_t MAX_DELETED_PERCENT = 20;
+  static constexpr uint32_t MIN_BINS = hashMapControl::GROUP_WIDTH;
+
  private:
-  enum class BIN_FLAGS { NONE = 0, FREE = 1, DELETED = 2, USED = 3 };
-
-  bool getBin(const char *key, uint32_t &bin) const {
-    const uint32_t computedHash = hashString32(key);
-    bin = computedHash % m_bins;
-    const uint32_t startBin = bin;
-
-    bool go = true;
-    bool status = true;
-    while (go) {
-      const uint32_t meta = getMetadata(bin);
-      const bool isKeyTheSame =
-          m_keys[bin] != nullptr && strcmp(key, m_keys[bin]) == 0;
-      const bool isBinUsed = meta == static_cast<uint32_t>(BIN_FLAGS::USED);
-      if (isKeyTheSame & isBinUsed) {
-        break;
+  static uint32_t computeBinCount(const uint32_t bins) {
+    uint32_t count = MIN_BINS;
+    while (count < bins) {
+      count <<= 1;
+    }
+    return count;
+  }
+
+  inline bool isOverPercent(const uint32_t count,
+                            const uint32_t percent) const {
+    return (static_cast<uint64_t>(count) * 100) >
+           (static_cast<uint64_t>(m_bins) * percent);
+  }
+
+  void allocateBins(const uint32_t bins) {
+    assert((bins & (bins - 1)) == 0 && "bin count needs to be a power of two");
+    assert(bins >= hashMapControl::GROUP_WIDTH);
+    m_bins = bins;
+    m_mask = bins - 1;
+    m_keys = allocateArray<const char *>(m_bins);
+    m_hashes = allocateArray<uint32_t>(m_bins);
+    m_values = allocateArray<VALUE>(m_bins);
+    m_control = allocateArray<uint8_t>(m_bins + hashMapControl::GROUP_WIDTH);
+    memset(m_keys, 0, m_bins * sizeof(char *));
+    memset(m_control, hashMapControl::FREE,
+           m_bins + hashMapControl::GROUP_WIDTH);
+    m_usedBins = 0;
+    m_deletedBins = 0;
+  }
+
+  void freeBins() {
+    freeArray(m_keys);
+    freeArray(m_hashes);
+    freeArray(m_values);
+    freeArray(m_control);
+  }
+
+  template <typename T>
+  T *allocateArray(const uint32_t count) {
+    if (m_alloc != nullptr) {
+      return reinterpret_cast<T *>(m_alloc->allocate(sizeof(T) * count));
+    }
+    return new T[count];
+  }
+  template <typename T>
+  void freeArray(T *memory) {
+    if (m_alloc != nullptr) {
+      m_alloc->free(memory);
+    } else {
+      delete[] memory;
+    }
+  }
+
+  void grow() {
+    // if the live elements would fit comfortably in the current size it means
+    // most of the occupied bins are tombstones, rehashing in place is enough
+    const bool needsMoreBins = isOverPercent((m_usedBins + 1) * 2, MAX_LOAD_FACTOR_PERCENT);
+    rehash(needsMoreBins ? m_bins * 2 : m_bins);
+  }
+
+  void rehash(const uint32_t newBins) {
+    const char **oldKeys = m_keys;
+    uint32_t *oldHashes = m_hashes;
+    VALUE *oldValues = m_values;
+    uint8_t *oldControl = m_control;
+    const uint32_t oldBins = m_bins;
+    allocateBins(newBins);
+
+    for (uint32_t i = 0; i < oldBins; ++i) {
+      if (!hashMapControl::isUsed(oldControl[i])) {
+        continue;
       }
+      // keys are unique and there are no tombstones, first free bin is it.
+      // the key string is already in the pool, we just move the pointer
+      const uint32_t hash = oldHashes[i];
+      const uint32_t bin = findInsertBin(hash);
+      writeToBin(bin, oldKeys[i], hash, oldValues[i]);
+      setControl(bin, hashMapControl::tag(hash));
+    }
+
+    freeArray(oldKeys);
+    freeArray(oldHashes);
+    freeArray(oldValues);
+    freeArray(oldControl);
+  }
 
-      ++bin;
-      bin = bin % m_bins;  // wrap around the bins count
-      if ((bin == startBin) | !isBinUsed) {
-        go = false;
-        status = false;
+  bool findBin(const char *key, const uint32_t hash, uint32_t &bin) const {
+    const uint8_t tag = hashMapControl::tag(hash);
+    uint32_t groupStart = hashMapControl::home(hash) & m_mask;
+    // groups are visited linearly, a group with a free bin ends the probe
+    // sequence, the load factor guarantees there is always one. strcmp only
+    // runs when the full hash matches as well
+    const uint32_t groupCount = m_bins / hashMapControl::GROUP_WIDTH;
+    for (uint32_t g = 0; g <= groupCount; ++g) {
+      const hashMapControl::Group group(m_control + groupStart);
+      uint32_t matches = group.match(tag);
+      while (matches != 0) {
+        const uint32_t candidate =
+            (groupStart + hashMapControl::lowestBit(matches)) & m_mask;
+        if ((m_hashes[candidate] == hash) &&
+            (strcmp(key, m_keys[candidate]) == 0)) {
+          bin = candidate;
+          return true;
+        }
+        matches &= matches - 1;
+      }
+      if (group.matchFree() != 0) {
+        return false;
       }
+      groupStart = (groupStart + hashMapControl::GROUP_WIDTH) & m_mask;
     }
-    return status;
+    return false;
   }
 
-  inline bool canWriteToBin(const uint32_t metadata) {
-    return (metadata == static_cast<uint32_t>(BIN_FLAGS::FREE)) |
-           (metadata == static_cast<uint32_t>(BIN_FLAGS::DELETED));
+  uint32_t findInsertBin(const uint32_t hash) const {
+    uint32_t groupStart = hashMapControl::home(hash) & m_mask;
+    while (true) {
+      const hashMapControl::Group group(m_control + groupStart);
+      const uint32_t available = group.matchFreeOrDeleted();
+      if (available != 0) {
+        return (groupStart + hashMapControl::lowestBit(available)) & m_mask;
+      }
+      groupStart = (groupStart + hashMapControl::GROUP_WIDTH) & m_mask;
+    }
   }
 
-  inline void writeToBin(uint32_t bin, const char *key, VALUE value) {
+  inline void writeToBin(uint32_t bin, const char *key, const uint32_t hash,
+                         VALUE value) {
     m_keys[bin] = key;
+    m_hashes[bin] = hash;
     m_values[bin] = value;
     ++m_usedBins;
   }
 
-  inline void setMetadata(const uint32_t bin, BIN_FLAGS flag) {
-    const uint32_t bit = bin * BIN_FLAGS_SIZE;
-    const uint32_t bit32 = bit / 32;
-    const uint32_t reminder32 = bit % 32;
-    const auto flag32 = static_cast<uint32_t>(flag);
-    // first we want to clear the value
-    const uint32_t mask = (~0) & ~(3 << reminder32);
-    m_metadata[bit32] &= mask;
-    // now set the value
-    m_metadata[bit32] |= flag32 << reminder32;
-  }
-
-  inline uint32_t getMetadata(const uint32_t bin) const {
-    const uint32_t bit = bin * BIN_FLAGS_SIZE;
-    const uint32_t bit32 = bit / 32;
-    const uint32_t reminder32 = bit % 32;
-    const uint32_t mask = 3 << reminder32;
-
-    const uint32_t binMetadata = (m_metadata[bit32] & mask) >> reminder32;
-    return binMetadata;
+  inline void setControl(const uint32_t bin, const uint8_t control) {
+    m_control[bin] = control;
+    // the first group is mirrored past the end of the array
+    if (bin < hashMapControl::GROUP_WIDTH) {
+      m_control[m_bins + bin] = control;
+    }
   }
 
  private:
-  // this is the number of bits required for bin
-  static constexpr uint32_t BIN_FLAGS_SIZE = 2;
-  static constexpr uint32_t BIN_FLAGS_MASK = 3;  // first two bit sets
-
+  ALLOCATOR *m_alloc = nullptr;
   const char **m_keys;
+  uint32_t *m_hashes;
   VALUE *m_values;
-  uint32_t *m_metadata;
+  uint8_t *m_control;
   uint32_t m_bins;
+  uint32_t m_mask;
   uint32_t m_usedBins = 0;
+  uint32_t m_deletedBins = 0;
 };
 }  // namespace SirMetal
@@ -5,6 +5,10 @@
 
 namespace SirMetal {
 
+namespace globals {
+StringPool *STRING_POOL = nullptr;
+}
+
 const char *StringPool::allocatePersistent(const char *string) {
   const auto length = static_cast<uint32_t>(strlen(string) + 1);
   const auto flags = static_cast<uint8_t>(STRING_TYPE::CHAR);
@@ -32,7 +36,7 @@ const char *StringPool::allocateFrame(const char *string) {
 const wchar_t *StringPool::allocateFrame(const wchar_t *string) {
   const uint64_t length = wcslen(string) + 1;
   const auto actualSize = static_cast<uint32_t>(length * sizeof(wchar_t));
-  void *memory = m_stackAllocator.allocate(actualSize);
+  void *memory = m_stackAllocator.allocate(actualSize, alignof(wchar_t));
   memcpy(memory, string, actualSize);
   return reinterpret_cast<wchar_t *>(memory);
 }
@@ -230,7 +234,7 @@ const wchar_t *StringPool::concatenateFrameWide(const wchar_t *first,
 
   // make the allocation
   auto *newChar =
-      reinterpret_cast<wchar_t *>(m_stackAllocator.allocate(totalLen));
+      reinterpret_cast<wchar_t *>(m_stackAllocator.allocate(totalLen, alignof(wchar_t)));
   // do the memcpy
   memcpy(newChar, first, firstLen * sizeof(wchar_t));
   if (joinerLen != 0) {
@@ -308,7 +312,7 @@ const wchar_t *StringPool::convertFrameWide(const char *string) {
 
   // make the allocation
   auto *newChar = reinterpret_cast<wchar_t *>(
-      m_stackAllocator.allocate(sizeof(wchar_t) * (len + 1)));
+      m_stackAllocator.allocate(sizeof(wchar_t) * (len + 1), alignof(wchar_t)));
   // do the conversion
   mbstowcs(newChar, string, (len + 1) * sizeof(wchar_t));
   return newChar;
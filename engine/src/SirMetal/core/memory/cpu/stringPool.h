@@ -2,7 +2,7 @@
 
 #include <type_traits>
 #include "SirMetal/core/memory/cpu/stackAllocator.h"
-#include "SirMetal/core/memory/cpu/threeSizesPool.h"
+#include "SirMetal/core/memory/cpu/threadCachingPool.h"
 
 namespace SirMetal {
 
@@ -13,6 +13,9 @@ enum STRING_MANIPULATION_FLAGS {
   FREE_JOINER_AFTER_OPERATION = 1 << 3
 };
 // NOTE: this class does not handle a string starting with leading spaces
+// Persistent strings and files can be allocated and freed from any thread, they
+// go through a thread caching pool. Frame memory is not thread safe, it is
+// meant for the main thread only.
 class  StringPool final {
  public:
  public:
@@ -219,8 +222,14 @@ class  StringPool final {
   enum class STRING_TYPE { CHAR = 1, WCHAR = 2 };
 
  private:
-  ThreeSizesPool m_pool;
+  ThreadCachingPool m_pool;
   StackAllocator m_stackAllocator;
 };
 
+namespace globals {
+// engine wide string pool, used among others by the string HashMap to
+// internalize its keys, needs to be set before use
+extern StringPool* STRING_POOL;
+}  // namespace globals
+
 }  // namespace SirMetal
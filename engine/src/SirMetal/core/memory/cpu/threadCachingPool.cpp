@@ -0,0 +1,182 @@
+#include "SirMetal/core/memory/cpu/threadCachingPool.h"
+#include <atomic>
+
+namespace SirMetal {
+
+namespace {
+// 0 is never handed out, it is the id of an empty thread local entry
+std::atomic<uint64_t> NEXT_POOL_ID{1};
+
+// fibonacci hashing, the low bits of a page start are all zeros
+uint32_t getPageBin(const uintptr_t address, const uint32_t shift) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+} // namespace
+
+thread_local ThreadCachingPool::RecentThreadCache
+        ThreadCachingPool::t_recentCaches[RECENT_CACHE_COUNT];
+
+ThreadCachingPool::ThreadCachingPool(const uint32_t pageSizeInByte,
+                                     const uint32_t smallSize,
+                                     const uint32_t mediumSize)
+    : m_id(NEXT_POOL_ID.fetch_add(1, std::memory_order_relaxed)),
+      m_central(pageSizeInByte, smallSize, mediumSize) {
+  m_pageTable.store(createPageTable(16, nullptr), std::memory_order_relaxed);
+  syncWithCentral();
+}
+
+ThreadCachingPool::~ThreadCachingPool() {
+  // cached blocks live in the central pool, they go away with it
+  while (m_caches != nullptr) {
+    ThreadCache *next = m_caches->next;
+    delete m_caches;
+    m_caches = next;
+  }
+  PageTable *table = m_pageTable.load(std::memory_order_relaxed);
+  while (table != nullptr) {
+    PageTable *previous = table->previous;
+    delete[] table->bins;
+    delete table;
+    table = previous;
+  }
+}
+
+int ThreadCachingPool::allocationInPool(const void *ptr) const {
+  const auto address = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t pageStart =
+          address & ~static_cast<uintptr_t>(m_central.getPageAlignment() - 1);
+  const uintptr_t delta = address - pageStart;
+  if ((delta > 0) & (delta < m_central.getPageSize()) && isPageStart(pageStart)) { return 1; }
+  // out of the pages only a bypass allocation can be in the pool, those come
+  // and go under the lock
+  if (m_bypassCount.load(std::memory_order_acquire) == 0) { return 0; }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_central.allocationInPool(ptr);
+}
+
+bool ThreadCachingPool::isPageStart(const uintptr_t address) const {
+  const PageTable *table = m_pageTable.load(std::memory_order_acquire);
+  const uint32_t mask = table->capacity - 1;
+  for (uint32_t i = getPageBin(address, table->shift);; i = (i + 1) & mask) {
+    const uintptr_t bin = table->bins[i].load(std::memory_order_acquire);
+    if (bin == address) { return true; }
+    if (bin == 0) { return false; }
+  }
+}
+
+ThreadCachingPool::PageTable *ThreadCachingPool::createPageTable(const uint32_t capacity,
+                                                                 PageTable *previous) {
+  auto *table = new PageTable();
+  table->bins = new std::atomic<uintptr_t>[capacity];
+  for (uint32_t i = 0; i < capacity; ++i) { table->bins[i].store(0, std::memory_order_relaxed); }
+  table->capacity = capacity;
+  table->shift = 64;
+  for (uint32_t c = capacity; c > 1; c >>= 1) { --table->shift; }
+  table->count = 0;
+  table->previous = previous;
+  return table;
+}
+
+void ThreadCachingPool::syncWithCentral() {
+  PageTable *table = m_pageTable.load(std::memory_order_relaxed);
+  for (; m_mirroredPageCount < m_central.getPageCount(); ++m_mirroredPageCount) {
+    // kept at most half full, the new table is filled before being published
+    if ((table->count + 1) * 2 > table->capacity) {
+      PageTable *grown = createPageTable(table->capacity * 2, table);
+      for (uint32_t i = 0; i < table->capacity; ++i) {
+        const uintptr_t bin = table->bins[i].load(std::memory_order_relaxed);
+        if (bin == 0) { continue; }
+        uint32_t j = getPageBin(bin, grown->shift);
+        while (grown->bins[j].load(std::memory_order_relaxed) != 0) {
+          j = (j + 1) & (grown->capacity - 1);
+        }
+        grown->bins[j].store(bin, std::memory_order_relaxed);
+        ++grown->count;
+      }
+      m_pageTable.store(grown, std::memory_order_release);
+      table = grown;
+    }
+    const auto start = reinterpret_cast<uintptr_t>(m_central.getPageStart(m_mirroredPageCount));
+    uint32_t i = getPageBin(start, table->shift);
+    while (table->bins[i].load(std::memory_order_relaxed) != 0) {
+      i = (i + 1) & (table->capacity - 1);
+    }
+    table->bins[i].store(start, std::memory_order_release);
+    ++table->count;
+  }
+  m_bypassCount.store(m_central.getBypassAllocCount(), std::memory_order_release);
+}
+
+void ThreadCachingPool::flushThreadCache() {
+  ThreadCache *cache = getThreadCache();
+  for (Magazine &magazine : cache->magazines) {
+    if (magazine.count != 0) { flush(magazine, magazine.count); }
+  }
+}
+
+uint32_t ThreadCachingPool::getThreadCachedBlockCount() {
+  const ThreadCache *cache = getThreadCache();
+  uint32_t count = 0;
+  for (const Magazine &magazine : cache->magazines) { count += magazine.count; }
+  return count;
+}
+
+ThreadCachingPool::ThreadCache *ThreadCachingPool::findThreadCache() {
+  const std::thread::id self = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ThreadCache *cache = m_caches;
+  // a thread id can be reused once its thread is gone, the new thread simply
+  // adopts the blocks left behind
+  while ((cache != nullptr) && (cache->owner != self)) { cache = cache->next; }
+  if (cache == nullptr) {
+    cache = new ThreadCache();
+    cache->owner = self;
+    cache->next = m_caches;
+    m_caches = cache;
+    ++m_cacheCount;
+  }
+  // most recent first, the oldest entry falls off
+  for (uint32_t i = RECENT_CACHE_COUNT - 1; i > 0; --i) {
+    t_recentCaches[i] = t_recentCaches[i - 1];
+  }
+  t_recentCaches[0].poolId = m_id;
+  t_recentCaches[0].cache = cache;
+  return cache;
+}
+
+void ThreadCachingPool::refill(Magazine &magazine, const uint32_t sizeClass) {
+  assert(magazine.count == 0);
+  const uint32_t size = threadCache::SIZE_CLASSES[sizeClass];
+  FreeBlock *head = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < REFILL_BATCH; ++i) {
+      auto *block = reinterpret_cast<FreeBlock *>(m_central.allocate(size));
+      block->next = head;
+      head = block;
+    }
+    syncWithCentral();
+  }
+  magazine.head = head;
+  magazine.count = REFILL_BATCH;
+}
+
+void ThreadCachingPool::flush(Magazine &magazine, const uint32_t count) {
+  assert(count <= magazine.count);
+  // detaching the chain first, only the frees happen under the lock
+  FreeBlock *chain = magazine.head;
+  FreeBlock *last = chain;
+  for (uint32_t i = 1; i < count; ++i) { last = last->next; }
+  magazine.head = last->next;
+  magazine.count -= count;
+  last->next = nullptr;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  while (chain != nullptr) {
+    FreeBlock *next = chain->next;
+    m_central.free(chain);
+    chain = next;
+  }
+}
+
+} // namespace SirMetal
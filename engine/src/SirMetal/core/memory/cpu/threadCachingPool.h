@@ -0,0 +1,204 @@
+#pragma once
+#include <array>
+#include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+#include "SirMetal/core/memory/cpu/threeSizesPool.h"
+
+namespace SirMetal {
+
+namespace threadCache {
+// sizes a thread cache hands out, a request is rounded up to the next class
+constexpr uint32_t SIZE_CLASSES[] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+constexpr uint32_t SIZE_CLASS_COUNT = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+constexpr uint32_t MAX_CACHED_SIZE = SIZE_CLASSES[SIZE_CLASS_COUNT - 1];
+constexpr uint32_t SIZE_CLASS_GRANULARITY = 16;
+constexpr uint32_t SIZE_CLASS_TABLE_SIZE = MAX_CACHED_SIZE / SIZE_CLASS_GRANULARITY + 1;
+
+// class of every size rounded up to the granularity, such that the lookup is a
+// shift and a load instead of a search
+constexpr std::array<uint8_t, SIZE_CLASS_TABLE_SIZE> buildSizeClassTable() {
+  std::array<uint8_t, SIZE_CLASS_TABLE_SIZE> table{};
+  uint32_t sizeClass = 0;
+  for (uint32_t i = 0; i < SIZE_CLASS_TABLE_SIZE; ++i) {
+    while (SIZE_CLASSES[sizeClass] < i * SIZE_CLASS_GRANULARITY) { ++sizeClass; }
+    table[i] = static_cast<uint8_t>(sizeClass);
+  }
+  return table;
+}
+constexpr std::array<uint8_t, SIZE_CLASS_TABLE_SIZE> SIZE_CLASS_TABLE = buildSizeClassTable();
+
+// smallest class able to hold sizeInByte
+inline uint32_t getSizeClass(const uint32_t sizeInByte) {
+  assert(sizeInByte <= MAX_CACHED_SIZE);
+  return SIZE_CLASS_TABLE[(sizeInByte + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY];
+}
+
+// biggest class fitting in a block of sizeInByte, a block recycled by the
+// central pool can be bigger than the class it was asked for
+inline uint32_t getSizeClassOfBlock(const uint32_t sizeInByte) {
+  assert(sizeInByte >= SIZE_CLASSES[0]);
+  const uint32_t sizeClass = getSizeClass(sizeInByte);
+  return SIZE_CLASSES[sizeClass] > sizeInByte ? sizeClass - 1 : sizeClass;
+}
+} // namespace threadCache
+
+// Thread safe front end of a ThreeSizesPool. Every thread gets its own cache,
+// one magazine of free blocks per size class, allocate and free only touch the
+// magazine of the calling thread and take no lock. A magazine is a list linked
+// through the free blocks themselves, bounded to MAGAZINE_SIZE blocks. An
+// empty magazine is refilled with a batch of blocks from the central pool and
+// a full one hands a batch back, the central pool sits behind a mutex which is
+// taken at most once every REFILL_BATCH operations of a thread. A block can be
+// freed from any thread, it simply ends up in the cache of the freeing thread.
+// Allocations bigger than the biggest size class go to the central pool under
+// the lock. Caches are owned by the pool and released with it, a thread about
+// to exit should call flushThreadCache to give its blocks back.
+// allocationInPool takes no lock for pointers in the central pages, their
+// starts are mirrored in a set readable from any thread.
+class ThreadCachingPool final {
+public:
+  static constexpr uint32_t MAGAZINE_SIZE = 64;
+  static constexpr uint32_t REFILL_BATCH = MAGAZINE_SIZE / 2;
+
+  // arguments are forwarded to the central ThreeSizesPool
+  explicit ThreadCachingPool(uint32_t pageSizeInByte, uint32_t smallSize = 64,
+                             uint32_t mediumSize = 256);
+  ~ThreadCachingPool();
+
+  void *allocate(const uint32_t sizeInByte, const uint8_t flags = 0) {
+    if (sizeInByte > threadCache::MAX_CACHED_SIZE) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      void *memory = m_central.allocate(sizeInByte, flags);
+      syncWithCentral();
+      return memory;
+    }
+    const uint32_t sizeClass = threadCache::getSizeClass(sizeInByte);
+    Magazine &magazine = getThreadCache()->magazines[sizeClass];
+    if (magazine.count == 0) { refill(magazine, sizeClass); }
+    FreeBlock *block = magazine.head;
+    magazine.head = block->next;
+    --magazine.count;
+    getHeader(block)->allocFlags = flags;
+    return block;
+  }
+
+  void free(void *memoryPtr) {
+    const uint32_t size = getAllocSize(memoryPtr);
+    if (size > threadCache::MAX_CACHED_SIZE) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_central.free(memoryPtr);
+      syncWithCentral();
+      return;
+    }
+    Magazine &magazine = getThreadCache()->magazines[threadCache::getSizeClassOfBlock(size)];
+    if (magazine.count == MAGAZINE_SIZE) { flush(magazine, REFILL_BATCH); }
+    auto *block = reinterpret_cast<FreeBlock *>(memoryPtr);
+    block->next = magazine.head;
+    magazine.head = block;
+    ++magazine.count;
+  }
+
+  // gives every block cached by the calling thread back to the central pool
+  void flushThreadCache();
+
+  // any pointer can be passed, the lock is only taken for a pointer out of the
+  // pages while bypass allocations of the central pool are alive
+  int allocationInPool(const void *ptr) const;
+
+  // size of the "user" allocation, it can be bigger than what was asked for,
+  // up to the size class the request was rounded to
+  static uint32_t getAllocSize(void *memoryPtr) {
+    const ThreeSizesPool::AllocHeader *header = getHeader(memoryPtr);
+    return header->size - sizeof(ThreeSizesPool::AllocHeader) - header->padding;
+  }
+  static uint8_t getAllocFlags(void *memoryPtr) {
+    return static_cast<uint8_t>(getHeader(memoryPtr)->allocFlags);
+  }
+
+  uint32_t getThreadCacheCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cacheCount;
+  }
+  // blocks sitting in the cache of the calling thread
+  uint32_t getThreadCachedBlockCount();
+  // the central pool is only safe to inspect while no other thread uses the
+  // pool, blocks sitting in thread caches count as allocated in there
+  const ThreeSizesPool &getCentralPool() const { return m_central; }
+
+  // deleted copy constructors and assignment operator
+  ThreadCachingPool(const ThreadCachingPool &) = delete;
+  ThreadCachingPool &operator=(const ThreadCachingPool &) = delete;
+
+private:
+  // the smallest class is big enough to hold the link
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+  struct Magazine {
+    FreeBlock *head = nullptr;
+    uint32_t count = 0;
+  };
+  struct ThreadCache {
+    Magazine magazines[threadCache::SIZE_CLASS_COUNT];
+    std::thread::id owner;
+    ThreadCache *next = nullptr;
+  };
+  // caches recently used by the thread, pools get a unique id such that an
+  // entry left by a destroyed pool never matches a new one at the same address
+  struct RecentThreadCache {
+    uint64_t poolId = 0;
+    ThreadCache *cache = nullptr;
+  };
+  // a thread commonly works with a few pools, the string pool, a job system
+  // pool, switching between them should not go through the lock
+  static constexpr uint32_t RECENT_CACHE_COUNT = 4;
+
+  // open addressing set of the central page starts, only the thread holding
+  // the lock inserts, any thread reads. Pages live as long as the pool so
+  // nothing is ever removed, an outgrown table is kept until the pool goes
+  // away since another thread could still be probing it
+  struct PageTable {
+    std::atomic<uintptr_t> *bins;
+    uint32_t capacity;
+    uint32_t shift;
+    uint32_t count;
+    PageTable *previous;
+  };
+
+  static ThreeSizesPool::AllocHeader *getHeader(void *memoryPtr) {
+    return reinterpret_cast<ThreeSizesPool::AllocHeader *>(memoryPtr) - 1;
+  }
+
+  inline ThreadCache *getThreadCache() {
+    for (const RecentThreadCache &recent : t_recentCaches) {
+      if (recent.poolId == m_id) { return recent.cache; }
+    }
+    return findThreadCache();
+  }
+  ThreadCache *findThreadCache();
+  void refill(Magazine &magazine, uint32_t sizeClass);
+  void flush(Magazine &magazine, uint32_t count);
+  // called with the lock held after the central pool allocated or freed,
+  // mirrors its new pages and its bypass count
+  void syncWithCentral();
+  bool isPageStart(uintptr_t address) const;
+  static PageTable *createPageTable(uint32_t capacity, PageTable *previous);
+
+private:
+  static thread_local RecentThreadCache t_recentCaches[RECENT_CACHE_COUNT];
+
+  const uint64_t m_id;
+  mutable std::mutex m_mutex;
+  ThreeSizesPool m_central;
+  ThreadCache *m_caches = nullptr;
+  uint32_t m_cacheCount = 0;
+  std::atomic<PageTable *> m_pageTable{nullptr};
+  uint32_t m_mirroredPageCount = 0;
+  std::atomic<uint32_t> m_bypassCount{0};
+};
+
+} // namespace SirMetal
@@ -1,40 +1,163 @@
 #pragma once
 #include <assert.h>
+#include <new>
+#include <stdint.h>
 #include <string.h>
 
 namespace SirMetal {
 
+// occupancy of a single page of a ThreeSizesPool, used to size pools from data
+struct ThreeSizesPoolPageStats {
+  uint32_t sizeInByte = 0;
+  // bytes ever handed out by the page stack pointer
+  uint32_t highWaterMark = 0;
+  // bytes taken by the live allocations of the page, headers included
+  uint32_t usedBytes = 0;
+  uint32_t allocCount = 0;
+};
+
 // This is memory pool, which allows any kind of size allocation.
 // Main feature is that allocations are bucketed based on 3 sizes, small ,medium
 // large. Three different linked lists keeps track of freed allocation, when a
 // new allocation is made a check in the linked list of the right bucket is
 // made, if there is any allocation to be recycled it will be used, otherwise
-// normal allocation will be made by increasing the stack pointer, to note stack
-// pointer can never be decreased.
+// normal allocation will be made by increasing the stack pointer of the current
+// page, to note stack pointer can never be decreased. When the page is full a
+// new page of the same size is chained, the pool grows on demand.
+// Allocations bigger than the large allocation threshold bypass the pages and
+// go straight to the heap, such that a big file does not eat a page and does
+// not end up in the large free list where only few allocations could use it.
+// Pages are aligned to their size rounded to a power of two, the page of any
+// pointer is found with a mask, allocationInPool is a set lookup whatever the
+// number of pages or bypass allocations.
 class  ThreeSizesPool final {
+public:
+  // this is an allocation description, is always going to be present, so if we
+  // ask to allocate a some memory we will always allocate that memory + the
+  // header. It is public because some tools, like string pool can benefit from
+  // this
+
+  // This class defines a memory allocation, the data will live before the
+  // actual reserved memory for the user. It is 8 bytes and block sizes are
+  // multiple of 8, so user memory is 8 bytes aligned
+  struct AllocHeader {
+    uint32_t size;           // size in byte of the allocation, header included
+    uint32_t allocFlags : 8; // user defined flags for the allocation, mostly
+                             // useful for tools
+    uint32_t type : 3;   // type of allocation, either SMALL , MEDIUM, LARGE
+                         // or BYPASS depending of the size
+    uint32_t isNode : 1; // for internal use, whether the memory is a linked
+                         // list node or not, mostly used for assertions
+    uint32_t padding : 3;    // bytes added to the user size to align the block
+    uint32_t pageIndex : 17; // page the allocation lives in
+  };
+
 private:
-// flags used to mark the headers and allocations
-#define SMALL_ALLOC_TAG 1;
-#define MEDIUM_ALLOC_TAG 2;
-#define LARGE_ALLOC_TAG 4;
-
-  // This struct is the node of the linked list, enough information are
-  // stored to keep track of the current memory block and the next,
-  // the smallest allocation possible is the same size of the NextAlloc
-  // otherwise we would not be able to store the node in the pool
+  // small, medium and large are 0, 1 and 2
+  static constexpr uint32_t BYPASS_ALLOC_TYPE = 3;
+  static constexpr uint32_t ALIGNMENT = 8;
+  static constexpr uint32_t MAX_PAGES = 1u << 17;
+
+  // This struct is the node of the linked list, it overlaps the header of the
+  // freed allocation, the smallest allocation possible is the same size of the
+  // NextAlloc otherwise we would not be able to store the node in the pool
   struct NextAlloc {
-    uint32_t offset : 32; // offset from the start of the pool in byte
-    uint32_t nextOffset;  // offset from the start of the pool in byte for the
-    uint32_t previousOffset; // offset from the start of the pool in byte for
-                             // the previous node in the linked list, 0 if null
-    bool isNode : 1;    // a bit flag setting whether the data here refers to a
-                        // node or an alloc, mostly debugging purpose
-    uint32_t size : 28; // size of the allocation in byte
-    uint32_t allocType : 3; // type of allocation
+    AllocHeader header;
+    NextAlloc *next;
+    NextAlloc *previous;
+  };
+
+  // bypass allocations are kept in a list so they can be released with the pool
+  struct BypassHeader {
+    BypassHeader *next;
+    BypassHeader *previous;
+  };
+
+  struct Page {
+    char *memory;
+    uint32_t stackPointerOffset;
+    uint32_t usedBytes;
+    uint32_t allocCount;
+  };
+
+  // open addressing set of addresses, linear probing with backward shift on
+  // erase so there are no tombstones, 0 marks an empty bin. Kept at most half
+  // full, a lookup is a bin or two
+  class AddressSet {
+  public:
+    AddressSet() = default;
+    ~AddressSet() { delete[] m_bins; }
+
+    bool contains(const uintptr_t address) const {
+      if (m_bins == nullptr) { return false; }
+      for (uint32_t i = getBin(address);; i = (i + 1) & m_mask) {
+        if (m_bins[i] == address) { return true; }
+        if (m_bins[i] == 0) { return false; }
+      }
+    }
+
+    void insert(const uintptr_t address) {
+      assert(address != 0);
+      if ((m_count + 1) * 2 > m_capacity) { grow(); }
+      uint32_t i = getBin(address);
+      while (m_bins[i] != 0) { i = (i + 1) & m_mask; }
+      m_bins[i] = address;
+      ++m_count;
+    }
+
+    void erase(const uintptr_t address) {
+      uint32_t hole = getBin(address);
+      while (m_bins[hole] != address) {
+        assert(m_bins[hole] != 0 && "address not in the set");
+        hole = (hole + 1) & m_mask;
+      }
+      // moving back the rest of the run, an entry can fill the hole if the
+      // hole sits between its home bin and its current bin
+      for (uint32_t i = (hole + 1) & m_mask; m_bins[i] != 0; i = (i + 1) & m_mask) {
+        const uint32_t home = getBin(m_bins[i]);
+        if (((i - home) & m_mask) >= ((i - hole) & m_mask)) {
+          m_bins[hole] = m_bins[i];
+          hole = i;
+        }
+      }
+      m_bins[hole] = 0;
+      --m_count;
+    }
+
+    // deleted copy constructors and assignment operator
+    AddressSet(const AddressSet &) = delete;
+    AddressSet &operator=(const AddressSet &) = delete;
+
+  private:
+    uint32_t getBin(const uintptr_t address) const {
+      // fibonacci hashing, the low bits of an address are mostly zeros
+      return static_cast<uint32_t>((static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15ull) >>
+                                   m_shift);
+    }
+
+    void grow() {
+      uintptr_t *oldBins = m_bins;
+      const uint32_t oldCapacity = m_capacity;
+      m_capacity = m_capacity == 0 ? 16 : m_capacity * 2;
+      m_shift = m_capacity == 16 ? 60 : m_shift - 1;
+      m_mask = m_capacity - 1;
+      m_bins = new uintptr_t[m_capacity]();
+      m_count = 0;
+      for (uint32_t i = 0; i < oldCapacity; ++i) {
+        if (oldBins[i] != 0) { insert(oldBins[i]); }
+      }
+      delete[] oldBins;
+    }
+
+    uintptr_t *m_bins = nullptr;
+    uint32_t m_capacity = 0;
+    uint32_t m_count = 0;
+    uint32_t m_mask = 0;
+    uint32_t m_shift = 64;
   };
 
   // helpers
-  uint32_t getAllocationTypeFromSize(const uint32_t sizeInByte) {
+  uint32_t getAllocationTypeFromSize(const uint32_t sizeInByte) const {
     const int isInMediumRange =
         (sizeInByte < m_mediumSize) & (sizeInByte >= m_smallSize);
     const int isInLargeRange = sizeInByte >= m_mediumSize;
@@ -42,33 +165,128 @@ private:
     return isInMediumRange + isInLargeRange * 2;
   }
 
+  static inline uint32_t alignSize(const uint32_t sizeInByte) {
+    return (sizeInByte + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  }
+
+  void addPage() {
+    assert(m_pageCount < MAX_PAGES && "too many pages in the pool");
+    if (m_pageCount == m_pageCapacity) {
+      const uint32_t newCapacity = m_pageCapacity == 0 ? 4 : m_pageCapacity * 2;
+      Page *pages = new Page[newCapacity];
+      if (m_pages != nullptr) {
+        memcpy(pages, m_pages, sizeof(Page) * m_pageCount);
+        delete[] m_pages;
+      }
+      m_pages = pages;
+      m_pageCapacity = newCapacity;
+    }
+    Page &page = m_pages[m_pageCount++];
+    page.memory = static_cast<char *>(
+            ::operator new(m_pageSizeInByte, std::align_val_t(m_pageAlignment)));
+    m_pageStarts.insert(reinterpret_cast<uintptr_t>(page.memory));
+    page.stackPointerOffset = 0;
+    page.usedBytes = 0;
+    page.allocCount = 0;
+  }
+
   void *allocateNew(const uint32_t sizeInByte, uint8_t flags) {
-    uint32_t totalAllocSize = sizeInByte + sizeof(AllocHeader);
-    totalAllocSize =
-        totalAllocSize < MIN_ALLOC_SIZE ? MIN_ALLOC_SIZE : totalAllocSize;
+    const uint32_t alignedSize = alignSize(sizeInByte + sizeof(AllocHeader));
+    const uint32_t totalAllocSize =
+        alignedSize < MIN_ALLOC_SIZE ? MIN_ALLOC_SIZE : alignedSize;
+
+    Page *page = &m_pages[m_pageCount - 1];
+    if (page->stackPointerOffset + totalAllocSize > m_pageSizeInByte) {
+      // the tail of the full page is recycled through the free lists
+      const uint32_t tail = m_pageSizeInByte - page->stackPointerOffset;
+      if (tail >= MIN_ALLOC_SIZE) {
+        auto *header = reinterpret_cast<AllocHeader *>(page->memory + page->stackPointerOffset);
+        header->size = tail;
+        header->pageIndex = m_pageCount - 1;
+        page->stackPointerOffset = m_pageSizeInByte;
+        pushFreeNode(header, getAllocationTypeFromSize(tail - sizeof(AllocHeader)));
+      }
+      addPage();
+      page = &m_pages[m_pageCount - 1];
+    }
 
     auto *header =
-        reinterpret_cast<AllocHeader *>(m_memory + m_stackPointerOffset);
+        reinterpret_cast<AllocHeader *>(page->memory + page->stackPointerOffset);
     header->size = totalAllocSize;
     header->isNode = false;
     header->type = getAllocationTypeFromSize(sizeInByte);
     header->allocFlags = flags;
+    // bumping to the min size is reported as usable memory, like a recycled
+    // bigger block, only the alignment is hidden from the user size
+    header->padding = alignedSize < MIN_ALLOC_SIZE ? 0 : alignedSize - sizeInByte - sizeof(AllocHeader);
+    header->pageIndex = m_pageCount - 1;
 
     ++m_allocCount[header->type];
-    m_stackPointerOffset += totalAllocSize;
+    page->stackPointerOffset += totalAllocSize;
+    page->usedBytes += totalAllocSize;
+    ++page->allocCount;
 
     return reinterpret_cast<char *>(header) + sizeof(AllocHeader);
   }
 
+  void *allocateBypass(const uint32_t sizeInByte, uint8_t flags) {
+    const uint64_t totalSize =
+        sizeof(BypassHeader) + sizeof(AllocHeader) + static_cast<uint64_t>(sizeInByte);
+    auto *bypass = reinterpret_cast<BypassHeader *>(
+        new uint64_t[(totalSize + sizeof(uint64_t) - 1) / sizeof(uint64_t)]);
+    bypass->previous = nullptr;
+    bypass->next = m_bypassList;
+    if (m_bypassList != nullptr) { m_bypassList->previous = bypass; }
+    m_bypassList = bypass;
+
+    auto *header = reinterpret_cast<AllocHeader *>(bypass + 1);
+    header->size = sizeInByte + sizeof(AllocHeader);
+    header->isNode = false;
+    header->type = BYPASS_ALLOC_TYPE;
+    header->allocFlags = flags;
+    header->padding = 0;
+    header->pageIndex = 0;
+    ++m_bypassCount;
+    m_bypassBytes += header->size;
+    char *user = reinterpret_cast<char *>(header) + sizeof(AllocHeader);
+    m_bypassAllocations.insert(reinterpret_cast<uintptr_t>(user));
+    return user;
+  }
+
+  void freeBypass(AllocHeader *header) {
+    auto *bypass = reinterpret_cast<BypassHeader *>(header) - 1;
+    if (bypass->previous != nullptr) { bypass->previous->next = bypass->next; }
+    if (bypass->next != nullptr) { bypass->next->previous = bypass->previous; }
+    if (m_bypassList == bypass) { m_bypassList = bypass->next; }
+    m_bypassAllocations.erase(reinterpret_cast<uintptr_t>(header) + sizeof(AllocHeader));
+    --m_bypassCount;
+    m_bypassBytes -= header->size;
+    delete[] reinterpret_cast<uint64_t *>(bypass);
+  }
+
+  // turns the block into a node and puts it at the head of the bucket list
+  void pushFreeNode(AllocHeader *header, const uint32_t allocType) {
+    auto *node = reinterpret_cast<NextAlloc *>(header);
+    node->header.isNode = true;
+    node->header.type = allocType;
+    node->header.padding = 0;
+    node->previous = nullptr;
+    node->next = m_nextAlloc[allocType];
+    if (m_nextAlloc[allocType] != nullptr) {
+      m_nextAlloc[allocType]->previous = node;
+    }
+    m_nextAlloc[allocType] = node;
+  }
+
   NextAlloc *findNextFreeAllocForSize(NextAlloc *start,
                                       uint32_t totalAllocSize) {
-    if (totalAllocSize <= start->size) {
+    if (totalAllocSize <= start->header.size) {
       return start;
     }
     NextAlloc *current = start;
-    while (current->nextOffset != 0) {
-      current = reinterpret_cast<NextAlloc *>(m_memory + current->nextOffset);
-      if (totalAllocSize < current->size) {
+    while (current->next != nullptr) {
+      current = current->next;
+      if (totalAllocSize < current->header.size) {
         return current;
       }
     }
@@ -76,81 +294,129 @@ private:
   }
 
 public:
-  // this is an allocation description, is always going to be present, so if we
-  // ask to allocate a some memory we will always allocate that memory + the
-  // header. It is public because some tools, like string pool can benefit from
-  // this
-
-  // This class defines a memory allocation, the data will live before the
-  // actual reserved memory for the user
-  struct AllocHeader {
-    uint32_t size : 20;      // size in byte of the allocation
-    uint32_t allocFlags : 8; // user defined flags for the allocation, mostly
-                             // useful for tools
-    uint32_t type : 3;   // type of allocation, either SMALL , MEDIUM or LARGE
-                         // depending of the bit set
-    uint32_t isNode : 1; // for internal use, whether the memory is a linked
-                         // list node or not, mostly used for assertions
-  };
-
+  // poolSizeInByte is the size of a page, allocations bigger than
+  // largeAllocationThreshold (a quarter of a page when 0) bypass the pages
   explicit ThreeSizesPool(const uint32_t poolSizeInByte,
                           const uint32_t smallSize = 64,
-                          const uint32_t mediumSize = 256) {
-    m_poolSizeInByte = poolSizeInByte;
+                          const uint32_t mediumSize = 256,
+                          const uint32_t largeAllocationThreshold = 0) {
+    m_pageSizeInByte = alignSize(poolSizeInByte);
+    assert(m_pageSizeInByte >= MIN_ALLOC_SIZE * 4);
+    assert(m_pageSizeInByte <= (1u << 31));
+    m_pageAlignment = 1;
+    while (m_pageAlignment < m_pageSizeInByte) { m_pageAlignment <<= 1; }
     m_smallSize = smallSize;
     m_mediumSize = mediumSize;
-    m_memory = new char[m_poolSizeInByte];
+    const uint32_t maxThreshold = m_pageSizeInByte / 2;
+    m_largeAllocationThreshold =
+        (largeAllocationThreshold == 0) | (largeAllocationThreshold > maxThreshold)
+            ? m_pageSizeInByte / 4
+            : largeAllocationThreshold;
 
     m_nextAlloc[0] = nullptr;
     m_nextAlloc[1] = nullptr;
     m_nextAlloc[2] = nullptr;
+    addPage();
   };
 
-  ~ThreeSizesPool() { delete m_memory; }
+  ~ThreeSizesPool() {
+    for (uint32_t i = 0; i < m_pageCount; ++i) {
+      ::operator delete(m_pages[i].memory, std::align_val_t(m_pageAlignment));
+    }
+    delete[] m_pages;
+    while (m_bypassList != nullptr) {
+      BypassHeader *next = m_bypassList->next;
+      delete[] reinterpret_cast<uint64_t *>(m_bypassList);
+      m_bypassList = next;
+    }
+  }
 
   // public interface
 
   // helpers
+
+  // any pointer can be passed, only the addresses are compared, the memory
+  // in front of ptr is never read
   int allocationInPool(const void *ptr) const {
-    const int64_t delta = reinterpret_cast<const char *>(ptr) - m_memory;
-    return (delta > 0) & (delta < m_poolSizeInByte);
+    const auto address = reinterpret_cast<uintptr_t>(ptr);
+    const uintptr_t pageStart = address & ~static_cast<uintptr_t>(m_pageAlignment - 1);
+    const uintptr_t delta = address - pageStart;
+    if ((delta > 0) & (delta < m_pageSizeInByte) && m_pageStarts.contains(pageStart)) {
+      return 1;
+    }
+    return m_bypassAllocations.contains(address);
   }
 
+#ifndef NDEBUG
+  // walks every page and bypass allocation, validates allocationInPool
+  int allocationInPoolByWalking(const void *ptr) const {
+    for (uint32_t i = 0; i < m_pageCount; ++i) {
+      const int64_t delta = reinterpret_cast<const char *>(ptr) - m_pages[i].memory;
+      if ((delta > 0) & (delta < m_pageSizeInByte)) { return 1; }
+    }
+    for (const BypassHeader *bypass = m_bypassList; bypass != nullptr;
+         bypass = bypass->next) {
+      const char *user = reinterpret_cast<const char *>(bypass + 1) + sizeof(AllocHeader);
+      if (user == ptr) { return 1; }
+    }
+    return 0;
+  }
+#endif
+
   // getters
 
   // returns the size of the "user" allocation ,meaning without the AllocHeader
   uint32_t getAllocSize(void *memoryPtr) const {
-    return getRawAllocSize(memoryPtr) - sizeof(AllocHeader);
+    const AllocHeader *header = getHeader(memoryPtr);
+    return header->size - sizeof(AllocHeader) - header->padding;
   }
 
   // returns the full raw allocation size, meaning user size + AllocHeader
-  uint32_t getRawAllocSize(void *memoryPtr) const {
-    char *bytePtr = reinterpret_cast<char *>(memoryPtr);
-    assert(allocationInPool(bytePtr) && "allocation not in pool");
-
-    const AllocHeader *header =
-        reinterpret_cast<AllocHeader *>(bytePtr - sizeof(AllocHeader));
-    assert(header->isNode == 0 &&
-           "allocation is a linked list node not an allocation");
-    return header->size;
-  }
+  uint32_t getRawAllocSize(void *memoryPtr) const { return getHeader(memoryPtr)->size; }
 
   uint32_t getSmallAllocCount() const { return m_allocCount[0]; }
   uint32_t getMediumAllocCount() const { return m_allocCount[1]; }
   uint32_t getLargeAllocCount() const { return m_allocCount[2]; }
+  // allocations over the threshold, not living in the pages
+  uint32_t getBypassAllocCount() const { return m_bypassCount; }
+  uint64_t getBypassBytes() const { return m_bypassBytes; }
+  uint32_t getLargeAllocationThreshold() const { return m_largeAllocationThreshold; }
 
   static uint32_t getMinAllocSize() { return MIN_ALLOC_SIZE; }
 
+  uint32_t getPageCount() const { return m_pageCount; }
+  uint32_t getPageSize() const { return m_pageSizeInByte; }
+  // pages start at a multiple of it, a power of two
+  uint32_t getPageAlignment() const { return m_pageAlignment; }
+  const char *getPageStart(const uint32_t pageIndex) const {
+    assert(pageIndex < m_pageCount);
+    return m_pages[pageIndex].memory;
+  }
+  ThreeSizesPoolPageStats getPageStats(const uint32_t pageIndex) const {
+    assert(pageIndex < m_pageCount);
+    const Page &page = m_pages[pageIndex];
+    ThreeSizesPoolPageStats stats;
+    stats.sizeInByte = m_pageSizeInByte;
+    stats.highWaterMark = page.stackPointerOffset;
+    stats.usedBytes = page.usedBytes;
+    stats.allocCount = page.allocCount;
+    return stats;
+  }
+  // bytes of the pages ever handed out, the stack pointers never go back so
+  // this only grows, freed memory is only reused by the free lists
+  uint64_t getHighWaterMark() const {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < m_pageCount; ++i) { total += m_pages[i].stackPointerOffset; }
+    return total;
+  }
+
   // methods
   void free(void *memoryPtr) {
-    char *bytePtr = reinterpret_cast<char *>(memoryPtr);
-    assert(allocationInPool(bytePtr));
-
-    auto *header =
-        reinterpret_cast<AllocHeader *>(bytePtr - sizeof(AllocHeader));
-
-    const uint32_t allocSize = header->size;
-    assert(header->isNode == 0);
+    AllocHeader *header = getHeader(memoryPtr);
+    if (header->type == BYPASS_ALLOC_TYPE) {
+      freeBypass(header);
+      return;
+    }
 
 /* TODO need to have a generic debug flag
 #if _DEBUG
@@ -159,36 +425,21 @@ public:
 #endif
 */
 
-    int allocType =
-        getAllocationTypeFromSize(header->size - sizeof(AllocHeader));
-    // lets create the node to dealloc
-    NextAlloc alloc{};
-    alloc.size = header->size;
-    alloc.isNode = true;
-    alloc.allocType = 1 << allocType;
-    alloc.nextOffset = 0;
-    alloc.previousOffset = 0;
-    alloc.offset = reinterpret_cast<char *>(header) - m_memory;
-
     // reducing alloc count
-    --m_allocCount[allocType];
-
-    // lets add to the linked list
-    if (m_nextAlloc[allocType] != nullptr) {
-      // patching offset of the next, and for the next patching offset
-      // of this to keep a doubled linked list
-      alloc.nextOffset = m_nextAlloc[allocType]->offset;
-      m_nextAlloc[allocType]->previousOffset = alloc.offset;
-    }
-
-    // now that the whole header is setup we commit it to memory
-    memcpy(header, &alloc, sizeof(NextAlloc));
-
-    m_nextAlloc[allocType] = reinterpret_cast<NextAlloc *>(header);
+    --m_allocCount[header->type];
+    Page &page = m_pages[header->pageIndex];
+    page.usedBytes -= header->size;
+    --page.allocCount;
+
+    // lets add to the linked list, the block goes back to the bucket it was
+    // requested from, the alignment could move its size to the next one
+    pushFreeNode(header, header->type);
   };
 
   void *allocate(const uint32_t sizeInByte, uint8_t flags = 0) {
-    assert((m_stackPointerOffset + sizeInByte) < m_poolSizeInByte);
+    if (sizeInByte > m_largeAllocationThreshold) {
+      return allocateBypass(sizeInByte, flags);
+    }
     // first lets find out what kind of allocation has been requested
     uint32_t allocType = getAllocationTypeFromSize(sizeInByte);
 
@@ -207,43 +458,31 @@ public:
         return allocateNew(sizeInByte, flags);
       }
 
-      assert(found->isNode == true);
+      assert(found->header.isNode == true);
 
       // patching linked list
-      NextAlloc *nextInList =
-          found->nextOffset != 0
-              ? reinterpret_cast<NextAlloc *>(m_memory + found->nextOffset)
-              : nullptr;
-      NextAlloc *previousInList =
-          found->previousOffset != 0
-              ? reinterpret_cast<NextAlloc *>(m_memory + found->previousOffset)
-              : nullptr;
-
-      if (previousInList != nullptr) {
-        // if we have a previous node we need to update the offsets
-        previousInList->nextOffset =
-            nextInList != nullptr ? nextInList->offset : 0;
+      if (found->previous != nullptr) {
+        found->previous->next = found->next;
       }
-
-      if (nextInList != nullptr) {
-        nextInList->previousOffset =
-            previousInList != nullptr ? previousInList->offset : 0;
+      if (found->next != nullptr) {
+        found->next->previous = found->previous;
       }
-
       // finally we set the head of the linked list
       if (m_nextAlloc[allocType] == found) {
-        m_nextAlloc[allocType] = nextInList;
+        m_nextAlloc[allocType] = found->next;
       }
 
       ++m_allocCount[allocType];
 
-      // lets now build the header
-      AllocHeader header{};
-      header.size = found->size;
+      // lets now build the header, size and page are kept from the node
+      AllocHeader &header = found->header;
       header.isNode = false;
       header.type = allocType;
       header.allocFlags = flags;
-      memcpy(found, &header, sizeof(header));
+      header.padding = 0;
+      Page &page = m_pages[header.pageIndex];
+      page.usedBytes += header.size;
+      ++page.allocCount;
 
       return reinterpret_cast<char *>(found) + sizeof(AllocHeader);
     }
@@ -256,14 +495,32 @@ public:
   ThreeSizesPool(const ThreeSizesPool &) = delete;
   ThreeSizesPool &operator=(const ThreeSizesPool &) = delete;
 
+private:
+  AllocHeader *getHeader(void *memoryPtr) const {
+    char *bytePtr = reinterpret_cast<char *>(memoryPtr);
+    assert(allocationInPool(bytePtr) && "allocation not in pool");
+    auto *header = reinterpret_cast<AllocHeader *>(bytePtr - sizeof(AllocHeader));
+    assert(header->isNode == 0 &&
+           "allocation is a linked list node not an allocation");
+    return header;
+  }
+
 private:
   static constexpr uint32_t MIN_ALLOC_SIZE = sizeof(NextAlloc);
-  char *m_memory = nullptr;
-  uint32_t m_poolSizeInByte;
-  uint32_t m_stackPointerOffset = 0;
+  Page *m_pages = nullptr;
+  uint32_t m_pageCount = 0;
+  uint32_t m_pageCapacity = 0;
+  uint32_t m_pageSizeInByte;
+  uint32_t m_pageAlignment;
+  uint32_t m_largeAllocationThreshold;
+  AddressSet m_pageStarts;
+  AddressSet m_bypassAllocations;
 
   NextAlloc *m_nextAlloc[3];
   uint32_t m_allocCount[3]{};
+  BypassHeader *m_bypassList = nullptr;
+  uint32_t m_bypassCount = 0;
+  uint64_t m_bypassBytes = 0;
   uint32_t m_smallSize;
   uint32_t m_mediumSize;
 };
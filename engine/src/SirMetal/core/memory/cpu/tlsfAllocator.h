@@ -0,0 +1,299 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace SirMetal {
+
+// Two level segregated fit allocator over a fixed pool. Free blocks are kept in
+// a two dimensional array of free lists, the first level splits sizes by power
+// of two and the second level splits every power of two in SL_COUNT linear
+// ranges. A bitmap per level tells which lists are not empty, such that finding
+// a fitting block is a couple of bit scans, allocate and free are O(1) no
+// matter how fragmented the pool is. Freed blocks are merged right away with
+// their free physical neighbours so the pool does not fragment over time like
+// the ThreeSizesPool, which never merges.
+// Allocations are 8 bytes aligned and pay an 8 bytes header. Allocate returns
+// nullptr when no free block is big enough.
+class TlsfAllocator final {
+public:
+  explicit TlsfAllocator(const uint32_t poolSizeInByte) {
+    assert(poolSizeInByte >= MIN_BLOCK_SIZE + HEADER_SIZE);
+    // the last header of the pool is a used sentinel such that the block
+    // after any block always exists
+    m_poolSizeInByte = poolSizeInByte & ~(ALIGNMENT - 1);
+    m_memory = reinterpret_cast<char *>(new uint64_t[m_poolSizeInByte / sizeof(uint64_t)]);
+    memset(m_freeLists, 0xFF, sizeof(m_freeLists));
+
+    const uint32_t sentinel = m_poolSizeInByte - HEADER_SIZE;
+    BlockHeader *first = getBlock(0);
+    first->prevPhysical = NO_BLOCK;
+    first->sizeAndBits = sentinel;
+    BlockHeader *last = getBlock(sentinel);
+    last->prevPhysical = 0;
+    last->sizeAndBits = USED_BIT | PREV_FREE_BIT;
+    insertFreeBlock(0, sentinel);
+  }
+
+  ~TlsfAllocator() { delete[] reinterpret_cast<uint64_t *>(m_memory); }
+
+  void *allocate(const uint32_t sizeInByte) {
+    const uint32_t blockSize = computeBlockSize(sizeInByte);
+    if (blockSize == 0) { return nullptr; }
+
+    const uint32_t offset = findFreeBlock(blockSize);
+    if (offset == NO_BLOCK) { return nullptr; }
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(getSize(getBlock(offset)), fl, sl);
+    removeFreeBlock(offset, fl, sl);
+    BlockHeader *block = getBlock(offset);
+    const uint32_t available = getSize(block);
+    assert(available >= blockSize);
+
+    // splitting the tail off when it can hold a block on its own. The block
+    // was free so the one before it is used, no free bit to carry over
+    uint32_t usedSize = available;
+    if (available - blockSize >= MIN_BLOCK_SIZE) {
+      usedSize = blockSize;
+      const uint32_t tailOffset = offset + blockSize;
+      BlockHeader *tail = getBlock(tailOffset);
+      tail->prevPhysical = offset;
+      tail->sizeAndBits = available - blockSize;
+      getBlock(tailOffset + getSize(tail))->prevPhysical = tailOffset;
+      insertFreeBlock(tailOffset, getSize(tail));
+    } else {
+      getNext(offset)->sizeAndBits &= ~PREV_FREE_BIT;
+    }
+    block->sizeAndBits = usedSize | USED_BIT;
+
+    m_usedBytes += usedSize;
+    ++m_allocCount;
+    return m_memory + offset + HEADER_SIZE;
+  }
+
+  void free(void *memoryPtr) {
+    if (memoryPtr == nullptr) { return; }
+    assert(allocationInPool(memoryPtr));
+    uint32_t offset =
+            static_cast<uint32_t>(reinterpret_cast<char *>(memoryPtr) - m_memory) - HEADER_SIZE;
+    BlockHeader *block = getBlock(offset);
+    assert((block->sizeAndBits & USED_BIT) && "double free or not an allocation");
+    uint32_t size = getSize(block);
+    m_usedBytes -= size;
+    --m_allocCount;
+
+    // merging with the next block if free
+    BlockHeader *next = getBlock(offset + size);
+    if (!(next->sizeAndBits & USED_BIT)) {
+      removeFreeBlock(offset + size);
+      size += getSize(next);
+    }
+    // merging with the previous block if free
+    if (block->sizeAndBits & PREV_FREE_BIT) {
+      const uint32_t prevOffset = block->prevPhysical;
+      removeFreeBlock(prevOffset);
+      size += offset - prevOffset;
+      offset = prevOffset;
+      block = getBlock(offset);
+    }
+    // the block before a free block is always used, merges guarantee it
+    block->sizeAndBits = size;
+    BlockHeader *after = getBlock(offset + size);
+    after->prevPhysical = offset;
+    after->sizeAndBits |= PREV_FREE_BIT;
+    insertFreeBlock(offset, size);
+  }
+
+  int allocationInPool(const void *ptr) const {
+    const int64_t delta = reinterpret_cast<const char *>(ptr) - m_memory;
+    return (delta >= HEADER_SIZE) & (delta < m_poolSizeInByte);
+  }
+
+  // usable size of the allocation, can be bigger than what was requested
+  uint32_t getAllocSize(void *memoryPtr) const {
+    assert(allocationInPool(memoryPtr));
+    const BlockHeader *block = reinterpret_cast<const BlockHeader *>(
+            reinterpret_cast<char *>(memoryPtr) - HEADER_SIZE);
+    return getSize(block) - HEADER_SIZE;
+  }
+
+  uint32_t getAllocCount() const { return m_allocCount; }
+  uint32_t getPoolSize() const { return m_poolSizeInByte; }
+  // bytes taken by live allocations, headers included
+  uint32_t getUsedBytes() const { return m_usedBytes; }
+  uint32_t getFreeBytes() const { return m_poolSizeInByte - HEADER_SIZE - m_usedBytes; }
+  // user size of the biggest free block, walks the free lists of the highest
+  // non empty first level
+  uint32_t getLargestFreeBlock() const {
+    if (m_flBitmap == 0) { return 0; }
+    const uint32_t fl = highestBit(m_flBitmap);
+    uint32_t largest = 0;
+    for (uint32_t sl = 0; sl < SL_COUNT; ++sl) {
+      for (uint32_t offset = m_freeLists[fl][sl]; offset != NO_BLOCK;
+           offset = getFreeLinks(offset)->next) {
+        const uint32_t size = getSize(getBlock(offset));
+        largest = size > largest ? size : largest;
+      }
+    }
+    return largest - HEADER_SIZE;
+  }
+
+  static constexpr uint32_t getMinAllocSize() { return MIN_BLOCK_SIZE - HEADER_SIZE; }
+
+  // deleted copy constructors and assignment operator
+  TlsfAllocator(const TlsfAllocator &) = delete;
+  TlsfAllocator &operator=(const TlsfAllocator &) = delete;
+
+private:
+  // every block starts with this, size is the whole block, header included,
+  // and is a multiple of the alignment which leaves the low bits for flags
+  struct BlockHeader {
+    uint32_t prevPhysical; // offset of the block before, valid when it is free
+    uint32_t sizeAndBits;
+  };
+  // free blocks keep the links of their free list right after the header
+  struct FreeLinks {
+    uint32_t next;
+    uint32_t previous;
+  };
+
+  static constexpr uint32_t USED_BIT = 1;
+  static constexpr uint32_t PREV_FREE_BIT = 2;
+  static constexpr uint32_t ALIGNMENT = 8;
+  static constexpr uint32_t HEADER_SIZE = sizeof(BlockHeader);
+  static constexpr uint32_t MIN_BLOCK_SIZE = HEADER_SIZE + sizeof(FreeLinks);
+  static constexpr uint32_t NO_BLOCK = 0xFFFFFFFF;
+  // second level has 1 << SL_LOG2 lists per power of two, sizes below
+  // SMALL_BLOCK_SIZE all go in the first list of the first level, split linearly
+  static constexpr uint32_t SL_LOG2 = 4;
+  static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+  static constexpr uint32_t FL_SHIFT = SL_LOG2 + 3;
+  static constexpr uint32_t SMALL_BLOCK_SIZE = 1u << FL_SHIFT;
+  static constexpr uint32_t FL_COUNT = 32 - FL_SHIFT + 1;
+
+  static inline uint32_t lowestBit(const uint32_t mask) {
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+  }
+  static inline uint32_t highestBit(const uint32_t mask) {
+    return 31u - static_cast<uint32_t>(__builtin_clz(mask));
+  }
+
+  inline BlockHeader *getBlock(const uint32_t offset) const {
+    return reinterpret_cast<BlockHeader *>(m_memory + offset);
+  }
+  inline BlockHeader *getNext(const uint32_t offset) const {
+    return getBlock(offset + getSize(getBlock(offset)));
+  }
+  inline FreeLinks *getFreeLinks(const uint32_t offset) const {
+    return reinterpret_cast<FreeLinks *>(m_memory + offset + HEADER_SIZE);
+  }
+  static inline uint32_t getSize(const BlockHeader *block) {
+    return block->sizeAndBits & ~(ALIGNMENT - 1);
+  }
+
+  // header plus the user size, aligned, returns 0 if it can never fit
+  uint32_t computeBlockSize(const uint32_t sizeInByte) const {
+    const uint64_t size = (static_cast<uint64_t>(sizeInByte) + HEADER_SIZE + ALIGNMENT - 1) &
+                          ~static_cast<uint64_t>(ALIGNMENT - 1);
+    if (size >= m_poolSizeInByte) { return 0; }
+    return size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : static_cast<uint32_t>(size);
+  }
+
+  static inline void mapping(const uint32_t size, uint32_t &fl, uint32_t &sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+      fl = 0;
+      sl = size / (SMALL_BLOCK_SIZE / SL_COUNT);
+    } else {
+      const uint32_t bit = highestBit(size);
+      fl = bit - (FL_SHIFT - 1);
+      sl = (size >> (bit - SL_LOG2)) ^ SL_COUNT;
+    }
+  }
+
+  static inline uint64_t roundUpToList(const uint32_t size) {
+    if (size < SMALL_BLOCK_SIZE) { return size; }
+    return static_cast<uint64_t>(size) + (1u << (highestBit(size) - SL_LOG2)) - 1;
+  }
+
+  // returns the offset of a free block of at least blockSize, or NO_BLOCK
+  uint32_t findFreeBlock(const uint32_t blockSize) const {
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    // rounding up to the next list, any block in it is big enough
+    const uint64_t searchSize = roundUpToList(blockSize);
+    if (searchSize <= UINT32_MAX) {
+      mapping(static_cast<uint32_t>(searchSize), fl, sl);
+      if (findSuitableList(fl, sl)) { return m_freeLists[fl][sl]; }
+    }
+    // the blocks in the list of the size itself might still fit, without this
+    // a pool with a single free block could not serve a request close to its
+    // size. Only the head is checked to stay O(1)
+    mapping(blockSize, fl, sl);
+    const uint32_t head = m_freeLists[fl][sl];
+    if ((head != NO_BLOCK) && (getSize(getBlock(head)) >= blockSize)) { return head; }
+    return NO_BLOCK;
+  }
+
+  // moves fl/sl to the first non empty list at or after them
+  bool findSuitableList(uint32_t &fl, uint32_t &sl) const {
+    if (fl >= FL_COUNT) { return false; }
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+      const uint32_t flMap = m_flBitmap & (~0u << (fl + 1));
+      if (flMap == 0) { return false; }
+      fl = lowestBit(flMap);
+      slMap = m_slBitmap[fl];
+    }
+    sl = lowestBit(slMap);
+    return true;
+  }
+
+  void insertFreeBlock(const uint32_t offset, const uint32_t size) {
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(size, fl, sl);
+    FreeLinks *links = getFreeLinks(offset);
+    const uint32_t head = m_freeLists[fl][sl];
+    links->next = head;
+    links->previous = NO_BLOCK;
+    if (head != NO_BLOCK) { getFreeLinks(head)->previous = offset; }
+    m_freeLists[fl][sl] = offset;
+    m_flBitmap |= 1u << fl;
+    m_slBitmap[fl] |= 1u << sl;
+  }
+
+  void removeFreeBlock(const uint32_t offset) {
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(getSize(getBlock(offset)), fl, sl);
+    removeFreeBlock(offset, fl, sl);
+  }
+
+  void removeFreeBlock(const uint32_t offset, const uint32_t fl, const uint32_t sl) {
+    const FreeLinks *links = getFreeLinks(offset);
+    if (links->next != NO_BLOCK) { getFreeLinks(links->next)->previous = links->previous; }
+    if (links->previous != NO_BLOCK) {
+      getFreeLinks(links->previous)->next = links->next;
+    } else {
+      assert(m_freeLists[fl][sl] == offset);
+      m_freeLists[fl][sl] = links->next;
+      if (links->next == NO_BLOCK) {
+        m_slBitmap[fl] &= ~(1u << sl);
+        if (m_slBitmap[fl] == 0) { m_flBitmap &= ~(1u << fl); }
+      }
+    }
+  }
+
+private:
+  char *m_memory = nullptr;
+  uint32_t m_poolSizeInByte = 0;
+  uint32_t m_usedBytes = 0;
+  uint32_t m_allocCount = 0;
+  uint32_t m_flBitmap = 0;
+  uint32_t m_slBitmap[FL_COUNT]{};
+  // offset of the first block of every free list, NO_BLOCK when empty
+  uint32_t m_freeLists[FL_COUNT][SL_COUNT];
+};
+
+} // namespace SirMetal
@@ -0,0 +1,137 @@
+#include "SirMetal/core/memory/cpu/virtualArena.h"
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace SirMetal {
+
+namespace {
+uint64_t roundUp(const uint64_t value, const uint64_t granularity) {
+  return (value + granularity - 1) / granularity * granularity;
+}
+} // namespace
+
+uint64_t VirtualArena::getPageSize() {
+  static const auto PAGE_SIZE = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  return PAGE_SIZE;
+}
+
+bool VirtualArena::reserve(const uint64_t reserveSizeInByte, const uint32_t flags) {
+  assert(m_base == nullptr && "arena already reserved");
+  assert(reserveSizeInByte > 0);
+  const bool hugePages = (flags & VIRTUAL_ARENA_FLAG_HUGE_PAGES) != 0;
+  m_commitGranularity = hugePages ? HUGE_PAGE_SIZE : MIN_COMMIT_GRANULARITY;
+  if (m_commitGranularity < getPageSize()) { m_commitGranularity = getPageSize(); }
+  m_reserved = roundUp(reserveSizeInByte, m_commitGranularity);
+
+  // huge pages need the range aligned to the huge page size, we map one extra
+  // and only use the aligned part
+  m_mappingSize = hugePages ? m_reserved + HUGE_PAGE_SIZE : m_reserved;
+  int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+  mapFlags |= MAP_NORESERVE;
+#endif
+  void *mapping = mmap(nullptr, m_mappingSize, PROT_NONE, mapFlags, -1, 0);
+  if (mapping == MAP_FAILED) {
+    printf("[ERROR] Could not reserve %llu bytes of address space\n",
+           static_cast<unsigned long long>(m_reserved));
+    m_reserved = 0;
+    m_mappingSize = 0;
+    return false;
+  }
+  m_mapping = static_cast<char *>(mapping);
+  m_base = m_mapping;
+  if (hugePages) {
+    const auto address = reinterpret_cast<uintptr_t>(m_mapping);
+    m_base = m_mapping + (roundUp(address, HUGE_PAGE_SIZE) - address);
+#ifdef MADV_HUGEPAGE
+    madvise(m_base, m_reserved, MADV_HUGEPAGE);
+#endif
+  }
+  m_committed = 0;
+  reset();
+  return true;
+}
+
+void VirtualArena::release() {
+  if (m_mapping == nullptr) { return; }
+  munmap(m_mapping, m_mappingSize);
+  m_mapping = nullptr;
+  m_base = nullptr;
+  m_mappingSize = 0;
+  m_reserved = 0;
+  m_committed = 0;
+  reset();
+}
+
+bool VirtualArena::commit(const uint64_t sizeInByte) {
+  assert(m_base != nullptr);
+  if (sizeInByte <= m_committed) { return true; }
+  if (sizeInByte > m_reserved) { return false; }
+  uint64_t newCommitted = roundUp(sizeInByte, m_commitGranularity);
+  newCommitted = newCommitted > m_reserved ? m_reserved : newCommitted;
+  if (mprotect(m_base + m_committed, newCommitted - m_committed, PROT_READ | PROT_WRITE) != 0) {
+    printf("[ERROR] Could not commit %llu bytes of the arena\n",
+           static_cast<unsigned long long>(newCommitted - m_committed));
+    return false;
+  }
+  m_committed = newCommitted;
+  return true;
+}
+
+void VirtualArena::decommit(const uint64_t keepSizeInByte) {
+  assert(m_base != nullptr);
+  assert(keepSizeInByte >= m_top && "decommitting memory still in use");
+  const uint64_t keep = roundUp(keepSizeInByte, m_commitGranularity);
+  if (keep >= m_committed) { return; }
+  char *start = m_base + keep;
+  const uint64_t size = m_committed - keep;
+  // dropping the physical pages first, protecting alone would keep them around
+#ifdef __APPLE__
+  madvise(start, size, MADV_FREE);
+#else
+  madvise(start, size, MADV_DONTNEED);
+#endif
+  mprotect(start, size, PROT_NONE);
+  m_committed = keep;
+}
+
+void *VirtualArena::allocate(const uint64_t sizeInByte, const uint64_t alignment) {
+  assert(m_base != nullptr);
+  assert((alignment != 0) && ((alignment & (alignment - 1)) == 0) &&
+         "alignment needs to be a power of two");
+  const uint64_t offset = roundUp(m_top, alignment);
+  if ((offset > m_reserved) || (sizeInByte > m_reserved - offset)) {
+    printf("[ERROR] Virtual arena out of reserved memory, requested %llu bytes\n",
+           static_cast<unsigned long long>(sizeInByte));
+    return nullptr;
+  }
+  if (!commit(offset + sizeInByte)) { return nullptr; }
+  m_lastAllocation = offset;
+  m_top = offset + sizeInByte;
+  return m_base + offset;
+}
+
+void VirtualArena::free(void *memory) {
+  if (memory == nullptr) { return; }
+  assert(contains(memory) && "memory not in the arena");
+  if ((m_lastAllocation != NO_ALLOCATION) &&
+      (static_cast<char *>(memory) == m_base + m_lastAllocation)) {
+    m_top = m_lastAllocation;
+    m_lastAllocation = NO_ALLOCATION;
+  }
+}
+
+bool VirtualArena::tryGrowInPlace(void *memory, const uint64_t newSizeInByte) {
+  if ((memory == nullptr) || (m_lastAllocation == NO_ALLOCATION) ||
+      (static_cast<char *>(memory) != m_base + m_lastAllocation)) {
+    return false;
+  }
+  if (newSizeInByte > m_reserved - m_lastAllocation) { return false; }
+  const uint64_t newTop = m_lastAllocation + newSizeInByte;
+  if (!commit(newTop)) { return false; }
+  m_top = newTop > m_top ? newTop : m_top;
+  return true;
+}
+
+} // namespace SirMetal
@@ -0,0 +1,92 @@
+#pragma once
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// not thread safe
+namespace SirMetal {
+
+enum VIRTUAL_ARENA_FLAGS {
+  VIRTUAL_ARENA_FLAG_NONE = 0,
+  // hint to back the arena with huge pages, transparent huge pages on linux,
+  // ignored where the OS does not support it
+  VIRTUAL_ARENA_FLAG_HUGE_PAGES = 1,
+};
+
+// Address range reserved up front and backed by physical memory only as it
+// gets used. A reserve costs address space, not memory, so it can be sized for
+// the worst case, pages are committed on demand as the top of the arena moves
+// up. Memory never moves, growing is committing the next pages, a pointer in
+// the arena stays valid until the arena is released or its pages decommitted.
+// On top of the range it is a bump allocator exposing the container allocator
+// interface, the last allocation can grow in place, see containerAllocators.h.
+class VirtualArena final {
+public:
+  static constexpr uint64_t DEFAULT_ALIGNMENT = 16;
+  static constexpr uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  VirtualArena() = default;
+  ~VirtualArena() { release(); }
+
+  // reserves the range, nothing is committed yet, returns false if the address
+  // space could not be reserved
+  bool reserve(uint64_t reserveSizeInByte, uint32_t flags = VIRTUAL_ARENA_FLAG_NONE);
+  // gives back the whole range, committed or not
+  void release();
+
+  // makes sure the first sizeInByte bytes of the range are usable, commits are
+  // rounded up to the commit granularity to keep the system calls rare
+  bool commit(uint64_t sizeInByte);
+  // gives the pages past keepSizeInByte back to the OS, used after a level
+  // unload to shrink. Their content is lost, the range stays reserved and
+  // is committed again on demand. Memory below the top of the arena is live,
+  // it can't be decommitted, reset the arena first
+  void decommit(uint64_t keepSizeInByte);
+  void shrinkToFit() { decommit(m_top); }
+
+  // bump allocation, commits as needed, nullptr when the reserve is exhausted
+  void *allocate(uint64_t sizeInByte, uint64_t alignment = DEFAULT_ALIGNMENT);
+  // only the last allocation actually goes back to the arena, anything below
+  // it is released in bulk with reset
+  void free(void *memory);
+  // grows the last allocation without moving it, false if memory is not the
+  // last allocation or the reserve is exhausted
+  bool tryGrowInPlace(void *memory, uint64_t newSizeInByte);
+  void reset() {
+    m_top = 0;
+    m_lastAllocation = NO_ALLOCATION;
+  }
+
+  [[nodiscard]] bool isReserved() const { return m_base != nullptr; }
+  [[nodiscard]] char *getBase() const { return m_base; }
+  [[nodiscard]] uint64_t getReservedSize() const { return m_reserved; }
+  [[nodiscard]] uint64_t getCommittedSize() const { return m_committed; }
+  [[nodiscard]] uint64_t getUsedBytes() const { return m_top; }
+  [[nodiscard]] uint64_t getCommitGranularity() const { return m_commitGranularity; }
+  [[nodiscard]] bool contains(const void *memory) const {
+    const char *ptr = static_cast<const char *>(memory);
+    return (ptr >= m_base) & (ptr < m_base + m_reserved);
+  }
+  static uint64_t getPageSize();
+
+  // deleted copy constructor and assignment operator
+  VirtualArena(const VirtualArena &) = delete;
+  VirtualArena &operator=(const VirtualArena &) = delete;
+
+private:
+  static constexpr uint64_t NO_ALLOCATION = ~0ull;
+  // smallest commit, a few pages at the time instead of one
+  static constexpr uint64_t MIN_COMMIT_GRANULARITY = 64 * 1024;
+
+  char *m_base = nullptr;
+  // the mapping, with huge pages it is bigger than the range to align it
+  char *m_mapping = nullptr;
+  uint64_t m_mappingSize = 0;
+  uint64_t m_reserved = 0;
+  uint64_t m_committed = 0;
+  uint64_t m_top = 0;
+  uint64_t m_lastAllocation = NO_ALLOCATION;
+  uint64_t m_commitGranularity = MIN_COMMIT_GRANULARITY;
+};
+
+} // namespace SirMetal
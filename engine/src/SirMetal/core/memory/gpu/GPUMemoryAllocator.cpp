@@ -85,10 +85,8 @@ BufferHandle GPUMemoryAllocator::allocate(const uint32_t sizeInBytes,
   bufferData.allocationSize = allocatedSize;
   bufferData.flags = flags;
 
-  uint32_t index = versionCounter++;
-  m_bufferStorage[index] = bufferData;
   // creating a handle
-  return getHandle<BufferHandle>(index);
+  return m_bufferStorage.insert(bufferData);
 }
 
 void GPUMemoryAllocator::cleanup() {}
@@ -96,15 +94,14 @@ void GPUMemoryAllocator::cleanup() {}
 void GPUMemoryAllocator::update(BufferHandle handle, void *data,
                                 uint32_t offset, uint32_t size) const {
   assert(getTypeFromHandle(handle) == HANDLE_TYPE::BUFFER);
-  uint32_t index = getIndexFromHandle(handle);
-  auto found = m_bufferStorage.find(index);
-  if (found == m_bufferStorage.end()) {
+  const Buffer *found = m_bufferStorage.get(handle);
+  if (found == nullptr) {
     printf("[ERROR] Tried to update buffer %i, but buffer could not be found",
-           index);
+           getIndexFromHandle(handle));
     return;
   }
 
-  const Buffer &bufferData = found->second;
+  const Buffer &bufferData = *found;
   bool isGPUOnly = (bufferData.flags & BUFFER_FLAG_GPU_ONLY) > 0;
   if (isGPUOnly) {
     assert(0 && "not supported yet");
@@ -116,14 +113,13 @@ void GPUMemoryAllocator::update(BufferHandle handle, void *data,
 
 id GPUMemoryAllocator::getBuffer(BufferHandle handle) const {
   assert(getTypeFromHandle(handle) == HANDLE_TYPE::BUFFER);
-  uint32_t index = getIndexFromHandle(handle);
-  auto found = m_bufferStorage.find(index);
-  if (found == m_bufferStorage.end()) {
+  const Buffer *found = m_bufferStorage.get(handle);
+  if (found == nullptr) {
     printf("[ERROR] Tried to get metal buffer from handle %i, but buffer could "
            "not be found",
-           index);
+           getIndexFromHandle(handle));
     return nil;
   }
-  return found->second.buffer;
+  return found->buffer;
 }
 } // namespace SirMetal
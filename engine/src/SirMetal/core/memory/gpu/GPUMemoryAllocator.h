@@ -2,8 +2,8 @@
 
 #import <objc/objc.h>
 #import <stdint.h>
-#import <unordered_map>
 
+#import "SirMetal/core/memory/cpu/slotMap.h"
 #import "SirMetal/resources/handle.h"
 
 namespace SirMetal {
@@ -62,8 +62,7 @@ private:
   };
 
 private:
-  std::unordered_map<uint32_t, Buffer> m_bufferStorage;
-  uint32_t versionCounter = 1;
+  SlotMap<Buffer, BufferHandle> m_bufferStorage;
   id m_device;
   id m_queue;
 };
@@ -0,0 +1,13 @@
+#pragma once
+#include <filesystem>
+
+namespace SirMetal {
+// libc++ (Apple clang) keeps the implementation in std::__fs::filesystem, which
+// is what the engine has been using so far, everything else goes through the
+// standard name
+#if defined(_LIBCPP_VERSION)
+namespace fs = std::__fs::filesystem;
+#else
+namespace fs = std::filesystem;
+#endif
+}// namespace SirMetal
@@ -0,0 +1,33 @@
+#pragma once
+
+// Thin shim over the Apple simd headers. The portable core (resource types, mesh
+// pipeline) only needs the type definitions, so on non Apple platforms we define
+// layout compatible vector types and nothing else, no math functions.
+#if defined(__APPLE__)
+#include <simd/simd.h>
+#else
+
+#if defined(__clang__)
+typedef float simd_float2 __attribute__((ext_vector_type(2)));
+typedef float simd_float3 __attribute__((ext_vector_type(3)));
+typedef float simd_float4 __attribute__((ext_vector_type(4)));
+#else
+// gcc vectors need a power of two size, float3 is 16 bytes on Apple as well
+typedef float simd_float2 __attribute__((vector_size(8)));
+typedef float simd_float3 __attribute__((vector_size(16)));
+typedef float simd_float4 __attribute__((vector_size(16)));
+#endif
+
+typedef struct {
+  simd_float4 columns[4];
+} simd_float4x4;
+
+typedef struct {
+  simd_float4 vector;
+} simd_quatf;
+
+typedef simd_float2 vector_float2;
+typedef simd_float3 vector_float3;
+typedef simd_float4 vector_float4;
+typedef simd_float4x4 matrix_float4x4;
+#endif
@@ -3,12 +3,17 @@
 #include "nlohmann/json.hpp"
 #include <unordered_map>
 
+#include "SirMetal/core/hashing/stringId.h"
 #include "SirMetal/core/input.h"
+#include "SirMetal/core/jobs/jobSystem.h"
+#include "SirMetal/core/memory/cpu/frameAllocator.h"
+#include "SirMetal/core/memory/cpu/stringPool.h"
 #include "SirMetal/graphics/constantBufferManager.h"
 #include "SirMetal/graphics/renderingContext.h"
 #include "SirMetal/graphics/debug/debugRenderer.h"
 #include "SirMetal/io/fileUtils.h"
 #include "SirMetal/io/json.h"
+#include "SirMetal/resources/asyncLoader.h"
 #include "SirMetal/resources/meshes/meshManager.h"
 #include "SirMetal/resources/shaderManager.h"
 #include "SirMetal/resources/textureManager.h"
@@ -79,6 +84,12 @@ EngineContext *engineStartUp(const EngineConfig &config, SDL_Window *window) {
 
   auto *context = new EngineContext{};
   context->m_config = config;
+  globals::STRING_POOL = new StringPool(4 * MB_TO_BYTE);
+  context->m_frameAllocator = new FrameAllocator();
+  context->m_frameAllocator->initialize(4 * MB_TO_BYTE, context->inFlightFrames);
+  context->m_jobSystem = new JobSystem();
+  context->m_jobSystem->initialize();
+  globals::JOB_SYSTEM = context->m_jobSystem;
   context->m_inputManager = new Input();
   context->m_inputManager->initialize();
   context->m_renderingContext = new graphics::RenderingContext();
@@ -93,6 +104,8 @@ EngineContext *engineStartUp(const EngineConfig &config, SDL_Window *window) {
   context->m_meshManager->initialize(device, queue);
   context->m_textureManager = new TextureManager();
   context->m_textureManager->initialize(device,queue);
+  context->m_asyncLoader = new AsyncLoader();
+  context->m_asyncLoader->initialize(context->m_jobSystem);
   context->m_debugRenderer = new graphics::DebugRenderer();
   context->m_debugRenderer->initialize(context);
   /*
@@ -109,6 +122,9 @@ void Timing::newFrame() {
   m_timeSinceStartInSeconds = m_clock.getDeltaFromOrigin() * NS_TO_SECONDS;
 }
 void engineShutdown(EngineContext *context) {
+  // loads still cooking write in the managers once uploaded, they go first
+  context->m_asyncLoader->cleanup();
+  delete context->m_asyncLoader;
   context->m_debugRenderer->cleanup(context);
   delete context->m_debugRenderer;
   context->m_textureManager->cleanup();
@@ -123,5 +139,12 @@ void engineShutdown(EngineContext *context) {
   delete context->m_renderingContext;
   context->m_inputManager->cleanup();
   delete context->m_inputManager;
+  delete context->m_frameAllocator;
+  globals::JOB_SYSTEM = nullptr;
+  context->m_jobSystem->cleanup();
+  delete context->m_jobSystem;
+  clearStringIdNames();
+  delete globals::STRING_POOL;
+  globals::STRING_POOL = nullptr;
 }
 } // namespace SirMetal
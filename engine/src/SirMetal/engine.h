@@ -13,6 +13,9 @@ class ShaderManager;
 class ConstantBufferManager;
 class MeshManager;
 class TextureManager;
+class AsyncLoader;
+class FrameAllocator;
+class JobSystem;
 
 namespace graphics {
 class DebugRenderer;
@@ -52,12 +55,18 @@ struct EngineContext {
   Window *m_window;
   Timing m_timings;
   uint32_t inFlightFrames = 3;
+  // per frame temporaries, buffered over the in flight frames
+  FrameAllocator *m_frameAllocator{};
+  // workers plus the main thread, which helps while it waits
+  JobSystem *m_jobSystem{};
   // Graphics
   graphics::RenderingContext *m_renderingContext{};
   ShaderManager *m_shaderManager{};
   ConstantBufferManager *m_constantBufferManager{};
   MeshManager *m_meshManager{};
   TextureManager *m_textureManager{};
+  // background loads, uploaded within a byte budget every frame
+  AsyncLoader *m_asyncLoader{};
   graphics::DebugRenderer *m_debugRenderer{};
   // Input
   Input *m_inputManager{};
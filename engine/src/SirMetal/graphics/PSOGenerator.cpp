@@ -43,7 +43,7 @@ std::size_t computePSOHash(const SirMetal::graphics::DrawTracker &tracker,
     hash_combine(toReturn, material.blendingState.destinationAlphaBlendFactor);
   }
 
-  hash_combine(toReturn, material.shaderName);
+  hash_combine(toReturn, material.shaderName.getHash());
   return toReturn;
 }
 
@@ -58,7 +58,7 @@ PSOCache getPSO(EngineContext *context,
     return found->second;
   }
   SirMetal::ShaderManager *sManager = context->m_shaderManager;
-  SirMetal::LibraryHandle lh = sManager->getHandleFromName(material.shaderName);
+  SirMetal::LibraryHandle lh = sManager->getHandleFromId(material.shaderName);
 
   MTLRenderPipelineDescriptor *pipelineDescriptor =
       [MTLRenderPipelineDescriptor new];
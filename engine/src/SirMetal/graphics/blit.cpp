@@ -14,7 +14,7 @@ void doBlit(EngineContext *context, id<MTLRenderCommandEncoder> encoder,
   tracker.depthTarget = {};
 
   SirMetal::PSOCache cache =
-          getPSO(context, tracker, SirMetal::Material{"fullscreen", false});
+          getPSO(context, tracker, SirMetal::Material{"fullscreen"_sid, false});
 
   id<MTLTexture> colorTexture =
           context->m_textureManager->getNativeFromHandle(request.srcTexture);
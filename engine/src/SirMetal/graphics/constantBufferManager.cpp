@@ -15,18 +15,17 @@ namespace SirMetal {
         uint32_t requestedSize = isBuffered ? toMultipleOfAlignment(size) * context->inFlightFrames : size;
         uint32_t allocIndex = findAllocator(requestedSize);
         PoolTracker &allocator = m_bufferPools[allocIndex];
-        BufferRangeHandle rangeHandle = allocator.linearManager->allocate(requestedSize, bufferAlignment);
-        BufferRange range = allocator.linearManager->getBufferRange(rangeHandle);
+        BufferRangeHandle rangeHandle = allocator.rangeAllocator->allocate(requestedSize, bufferAlignment);
+        BufferRange range = allocator.rangeAllocator->getBufferRange(rangeHandle);
 
-        uint32_t index = static_cast<uint32_t>(m_constBuffers.size());
-        m_constBuffers.emplace_back(ConstantBufferData{range, allocIndex, size, flags});
-        return getHandle<ConstantBufferHandle>(index);
+        return m_constBuffers.insert(ConstantBufferData{range, allocIndex, size, flags});
     }
 
     void ConstantBufferManager::update(EngineContext* context,ConstantBufferHandle handle, void *data) {
         assert(getTypeFromHandle(handle) == HANDLE_TYPE::CONSTANT_BUFFER);
-        int dataIndex = getIndexFromHandle(handle);
-        ConstantBufferData &constantData = m_constBuffers[dataIndex];
+        ConstantBufferData *found = m_constBuffers.get(handle);
+        assert(found != nullptr);
+        ConstantBufferData &constantData = *found;
         bool isBuffered = (constantData.flags & CONSTANT_BUFFER_FLAG_BUFFERED) > 0;
         uint32_t currentFrame = context->m_timings.m_totalNumberOfFrames% context->inFlightFrames;
         uint32_t perFrameOffset = toMultipleOfAlignment(constantData.userRequestedSize) * currentFrame;
@@ -50,14 +49,14 @@ namespace SirMetal {
         sprintf(printBuffer, "constantBufferPool%d", index);
         BufferHandle buffer = m_allocator.allocate(m_poolSize, printBuffer,
                 BUFFER_FLAG_NONE);
-        LinearBufferManager *tracker = new LinearBufferManager(m_poolSize);
+        OffsetAllocator *tracker = new OffsetAllocator(m_poolSize);
         m_bufferPools.emplace_back(PoolTracker{buffer, tracker});
     }
 
     uint32_t ConstantBufferManager::findAllocator(uint32_t size) {
         size_t count = m_bufferPools.size();
         for (size_t i = 0; i < count; ++i) {
-            if (m_bufferPools[i].linearManager->canAllocate(size)) {
+            if (m_bufferPools[i].rangeAllocator->canAllocate(size, bufferAlignment)) {
                 return static_cast<uint32_t>(i);
             }
         }
@@ -69,8 +68,9 @@ namespace SirMetal {
     BindInfo ConstantBufferManager::getBindInfo(EngineContext* context, const ConstantBufferHandle handle) {
 
         assert(getTypeFromHandle(handle) == HANDLE_TYPE::CONSTANT_BUFFER);
-        int dataIndex = getIndexFromHandle(handle);
-        ConstantBufferData &constantData = m_constBuffers[dataIndex];
+        ConstantBufferData *found = m_constBuffers.get(handle);
+        assert(found != nullptr);
+        ConstantBufferData &constantData = *found;
         bool isBuffered = (constantData.flags & CONSTANT_BUFFER_FLAG_BUFFERED) > 0;
         auto bufferHandle = m_bufferPools[constantData.allocIndex].bufferHandle;
 
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "SirMetal/core/memory/cpu/linearBufferManager.h"
+#include "SirMetal/core/memory/cpu/offsetAllocator.h"
+#include "SirMetal/core/memory/cpu/slotMap.h"
 #include "SirMetal/core/memory/gpu/GPUMemoryAllocator.h"
 #include "SirMetal/resources/handle.h"
 #include "SirMetal/engine.h"
@@ -36,7 +37,7 @@ namespace SirMetal {
         struct PoolTracker
         {
             BufferHandle bufferHandle;
-            LinearBufferManager* linearManager;
+            OffsetAllocator* rangeAllocator;
         };
 
         struct ConstantBufferData
@@ -54,7 +55,7 @@ namespace SirMetal {
         GPUMemoryAllocator m_allocator;
         uint32_t m_poolSize;
         std::vector<PoolTracker> m_bufferPools;
-        std::vector<ConstantBufferData> m_constBuffers;
+        SlotMap<ConstantBufferData, ConstantBufferHandle> m_constBuffers;
 
     };
 }
\ No newline at end of file
@@ -130,12 +130,13 @@ int drawSquareBetweenFourPoints(float *data, const vector_float3 &bottomLeft,
 }
 
 void DebugRenderer::initialize(EngineContext *context) {
-  m_allocator.initialize(SIZE_IN_BYTES);
+  m_allocator.initialize(SIZE_IN_BYTES, context->inFlightFrames);
   m_scratch.initialize(SCRATCH_SIZE_IN_BYTES);
 
   m_gpuAllocator.initialize(context->m_renderingContext->getDevice(),
                             context->m_renderingContext->getQueue());
-  m_bufferHandle = m_gpuAllocator.allocate(SIZE_IN_BYTES, "DebugLinesBuffer",
+  m_bufferHandle = m_gpuAllocator.allocate(SIZE_IN_BYTES * context->inFlightFrames,
+                                           "DebugLinesBuffer",
                                            BUFFER_FLAG_NONE, nullptr);
   ShaderManager *shaderManager = context->m_shaderManager;
   const std::string base = context->m_config.m_dataSourcePath;
@@ -160,8 +161,10 @@ void DebugRenderer::render(EngineContext *context,
   if (m_linesCount == 0)
     return;
   auto *renderingCtx = context->m_renderingContext;
-  m_gpuAllocator.update(m_bufferHandle, m_allocator.getStartPtr(), 0,
-                        m_linesCount * sizeof(float) * 8);
+  const auto frameOffset =
+      static_cast<uint32_t>(m_allocator.getFrameIndex() * SIZE_IN_BYTES);
+  m_gpuAllocator.update(m_bufferHandle, m_allocator.getCurrent().getStartPtr(),
+                        frameOffset, m_linesCount * sizeof(float) * 8);
   /*
   ID3D11DeviceContext *deviceContext = renderingCtx->getDeviceContext();
   context->m_shaderManager->bindShader(deviceContext, m_linesVS);
@@ -177,7 +180,7 @@ void DebugRenderer::render(EngineContext *context,
 
   id<MTLRenderCommandEncoder> encoder = commandEncoder;
   auto cache =
-      SirMetal::getPSO(context, tracker, SirMetal::Material{"solidColor", false});
+      SirMetal::getPSO(context, tracker, SirMetal::Material{"solidColor"_sid, false});
   [encoder setRenderPipelineState:cache.color];
   if(cache.depth != nil){
     [encoder setDepthStencilState:cache.depth];
@@ -189,7 +192,7 @@ void DebugRenderer::render(EngineContext *context,
       context->m_constantBufferManager->getBindInfo(context, cameraBuffer);
   [encoder setVertexBuffer:info.buffer offset:info.offset atIndex:4];
   id<MTLBuffer> buffer = m_gpuAllocator.getBuffer(m_bufferHandle);
-  [encoder setVertexBuffer:buffer offset:0 atIndex:0];
+  [encoder setVertexBuffer:buffer offset:frameOffset atIndex:0];
   [encoder drawPrimitives:MTLPrimitiveTypeLine vertexStart:0 vertexCount: m_linesCount];
 
   [encoder setVertexBuffer:buffer
@@ -247,7 +250,7 @@ void DebugRenderer::drawLines(const float *data, const uint32_t sizeInByte,
   // optimized to float3 but needs to be careful
   // https://giordi91.github.io/post/spirvvec3/
   uint32_t finalSize = count * 2 * sizeof(float) * 4;
-  auto *paddedData = static_cast<float *>(m_allocator.allocate(finalSize));
+  auto *paddedData = m_allocator.allocateArray<float>(finalSize / sizeof(float));
 
   for (uint32_t i = 0; i < count; ++i) {
     paddedData[i * 8 + 0] = data[i * 3 + 0];
@@ -263,8 +266,8 @@ void DebugRenderer::drawLines(const float *data, const uint32_t sizeInByte,
   m_linesCount += count;
 }
 
-void DebugRenderer::newFrame() {
-  m_allocator.reset();
+void DebugRenderer::newFrame(const EngineContext *context) {
+  m_allocator.newFrame(context->m_timings.m_totalNumberOfFrames);
   m_scratch.reset();
   m_linesCount = 0;
 }
@@ -3,6 +3,7 @@
 #include <simd/matrix_types.h>
 
 #include "SirMetal/core/core.h"
+#include "SirMetal/core/memory/cpu/frameAllocator.h"
 #include "SirMetal/core/memory/cpu/stackAllocator.h"
 #include <SirMetal/core/memory/gpu/GPUMemoryAllocator.h>
 #include "SirMetal/graphics/graphicsDefines.h"
@@ -38,11 +39,12 @@ public:
               uint32_t renderWidth, uint32_t renderHeight) const;
   void drawAABBs3D(const BoundingBox *data, int count, vector_float4 color);
   void drawLines(const float *data, uint32_t sizeInByte, vector_float4 color);
-  void newFrame();
+  void newFrame(const EngineContext *context);
 
 private:
   GPUMemoryAllocator m_gpuAllocator;
-  StackAllocator m_allocator;
+  // lines of the frames in flight, the GPU buffer is split the same way
+  FrameAllocator m_allocator;
   StackAllocator m_scratch;
   BufferHandle m_bufferHandle{};
   static constexpr uint64_t SIZE_IN_BYTES = 20 * MB_TO_BYTE;
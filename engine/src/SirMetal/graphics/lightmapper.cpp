@@ -217,7 +217,7 @@ void LightMapper::doGBufferPass(EngineContext *context,
 
   //we start by clearning the gbuffers to the values we want
   PSOCache cache =
-          SirMetal::getPSO(context, tracker, SirMetal::Material{"gbuffClear", false});
+          SirMetal::getPSO(context, tracker, SirMetal::Material{"gbuffClear"_sid, false});
 
   [commandEncoder setRenderPipelineState:cache.color];
   [commandEncoder setFrontFacingWinding:MTLWindingCounterClockwise];
@@ -232,7 +232,7 @@ void LightMapper::doGBufferPass(EngineContext *context,
   [commandEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:3];
 
   //now we can perform the actual gbuffer pass
-  cache = SirMetal::getPSO(context, tracker, SirMetal::Material{"gbuff", false});
+  cache = SirMetal::getPSO(context, tracker, SirMetal::Material{"gbuff"_sid, false});
   [commandEncoder setRenderPipelineState:cache.color];
 
 
@@ -1,7 +1,7 @@
 #pragma once
 
 #import <Metal/Metal.h>
-#include <string>
+#include "SirMetal/core/hashing/stringId.h"
 namespace SirMetal {
 
     struct AlphaBlendingState
@@ -16,7 +16,7 @@ namespace SirMetal {
     };
     struct Material
     {
-        std::string shaderName;
+        StringId shaderName;
         AlphaBlendingState blendingState;
     };
 }
\ No newline at end of file
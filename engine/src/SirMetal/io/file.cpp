@@ -1,4 +1,4 @@
-#import <unordered_map>
+#include <unordered_map>
 
 #include "SirMetal/io/file.h"
 
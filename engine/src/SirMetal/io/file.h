@@ -1,6 +1,8 @@
 #pragma once
 
-#include <filesystem>
+#include <string>
+
+#include "SirMetal/core/platform/filesystem.h"
 
 namespace SirMetal {
 
@@ -11,37 +13,37 @@ namespace SirMetal {
     };
 
     inline std::string getFileName(const std::string &path) {
-        const auto expPath = std::__fs::filesystem::path(path);
+        const auto expPath = fs::path(path);
         return expPath.stem().string();
     }
 
     inline std::string getFileExtension(const std::string &path) {
-        const auto expPath = std::__fs::filesystem::path(path);
+        const auto expPath = fs::path(path);
         return expPath.extension().string();
     }
 
     inline std::string getPathName(const std::string &path) {
-        const auto expPath = std::__fs::filesystem::path(path);
+        const auto expPath = fs::path(path);
         return expPath.parent_path().string();
     }
 
     inline bool fileExists(const std::string &name) {
-        return std::__fs::filesystem::exists(name);
+        return fs::exists(name);
     }
 
     inline bool filePathExists(const std::string &name) {
-        const std::__fs::filesystem::path path(name);
-        const std::__fs::filesystem::path parent = path.parent_path();
-        return std::__fs::filesystem::exists(parent);
+        const fs::path path(name);
+        const fs::path parent = path.parent_path();
+        return fs::exists(parent);
     }
 
     inline bool isPathDirectory(const std::string &name) {
-        return std::__fs::filesystem::is_directory(name);
+        return fs::is_directory(name);
     }
 
     inline void ensureDirectory(const std::string &path) {
-        if (!std::__fs::filesystem::is_directory(path) || !std::__fs::filesystem::exists(path)) { // Check if src folder exists
-            std::__fs::filesystem::create_directory(path); // create src folder
+        if (!fs::is_directory(path) || !fs::exists(path)) { // Check if src folder exists
+            fs::create_directory(path); // create src folder
         }
     }
     FILE_EXT getFileExtFromStr(const std::string &ext);
@@ -0,0 +1,66 @@
+#include "SirMetal/io/mappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SirMetal {
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data(other.m_data), m_size(other.m_size), m_isOpen(other.m_isOpen) {
+  other.m_data = nullptr;
+  other.m_size = 0;
+  other.m_isOpen = false;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    close();
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_isOpen = other.m_isOpen;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_isOpen = false;
+  }
+  return *this;
+}
+
+bool MappedFile::open(const char *path) {
+  close();
+  const int fd = ::open(path, O_RDONLY);
+  if (fd < 0) { return false; }
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+  m_size = static_cast<uint64_t>(info.st_size);
+  if (m_size != 0) {
+    void *mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      m_size = 0;
+      return false;
+    }
+    // the readers go through the file front to back, let the OS read ahead
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, m_size, MADV_SEQUENTIAL);
+#endif
+    m_data = static_cast<const char *>(mapping);
+  }
+  // the mapping holds its own reference to the file
+  ::close(fd);
+  m_isOpen = true;
+  return true;
+}
+
+void MappedFile::close() {
+  if (m_data != nullptr) { munmap(const_cast<char *>(m_data), m_size); }
+  m_data = nullptr;
+  m_size = 0;
+  m_isOpen = false;
+}
+
+} // namespace SirMetal
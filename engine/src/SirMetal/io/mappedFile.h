@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+
+namespace SirMetal {
+
+// Read only view of a whole file through mmap. Pages are read by the OS on
+// first touch and stay in the page cache between runs, opening a file seen
+// recently costs no read at all. The view is valid until close, the file can
+// be replaced on disk meanwhile, the mapping keeps the old content.
+// not thread safe
+class MappedFile final {
+public:
+  MappedFile() = default;
+  ~MappedFile() { close(); }
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  // false if the file does not exist or can't be mapped, an empty file opens
+  // with a null data pointer
+  bool open(const char *path);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return m_isOpen; }
+  [[nodiscard]] const char *getData() const { return m_data; }
+  [[nodiscard]] uint64_t getSize() const { return m_size; }
+
+  // deleted copy constructor and assignment operator
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+private:
+  const char *m_data = nullptr;
+  uint64_t m_size = 0;
+  bool m_isOpen = false;
+};
+
+} // namespace SirMetal
@@ -0,0 +1,120 @@
+#include "SirMetal/resources/asyncLoader.h"
+
+#include <stdio.h>
+
+namespace SirMetal {
+
+AsyncLoader::AsyncLoader()
+    : m_loads(MAX_LOADS_IN_FLIGHT), m_cooked(MAX_LOADS_IN_FLIGHT),
+      m_uploadQueue(MAX_LOADS_IN_FLIGHT) {}
+
+AsyncLoader::~AsyncLoader() { cleanup(); }
+
+void AsyncLoader::initialize(JobSystem *jobSystem, const uint64_t uploadBudgetInBytes) {
+  assert(uploadBudgetInBytes > 0);
+  m_jobSystem = jobSystem;
+  m_uploadBudgetInBytes = uploadBudgetInBytes;
+}
+
+void AsyncLoader::cleanup() {
+  if (m_jobSystem != nullptr) { m_jobSystem->wait(m_cookGroup); }
+  CookedLoad cooked;
+  while (m_cooked.pop(cooked)) {}
+  while (!m_uploadQueue.isEmpty()) { m_uploadQueue.pop(); }
+  m_loads.clear();
+  m_cookingCount = 0;
+  m_jobSystem = nullptr;
+}
+
+AsyncLoadHandle AsyncLoader::request(std::unique_ptr<AsyncLoadTask> task) {
+  assert(task != nullptr);
+  // bounds the cooked queue, it can then never be full
+  if ((getInFlightCount() == MAX_LOADS_IN_FLIGHT) | (m_loads.size() == m_loads.getPoolSize())) {
+    printf("[ERROR] Too many async loads, %u in flight and %u not released\n", getInFlightCount(),
+           m_loads.size());
+    assert(0 && "too many async loads");
+    return {};
+  }
+  AsyncLoadTask *taskPtr = task.get();
+  const AsyncLoadHandle handle = m_loads.insert(LoadSlot{std::move(task), ASYNC_LOAD_STATE::COOKING});
+  ++m_cookingCount;
+  // without workers jobs only run inside wait, nothing would cook the task
+  // before the next flush, cooking right away instead
+  if ((m_jobSystem != nullptr) && (m_jobSystem->getWorkerCount() > 0)) {
+    m_jobSystem->run(m_cookGroup, [this, handle, taskPtr] { cook(handle, taskPtr); });
+  } else {
+    cook(handle, taskPtr);
+  }
+  return handle;
+}
+
+void AsyncLoader::cook(const AsyncLoadHandle handle, AsyncLoadTask *task) {
+  const bool succeeded = task->cook();
+  const bool pushed = m_cooked.push(CookedLoad{handle, succeeded});
+  assert(pushed && "cooked queue can not be full, in flight loads are bounded");
+  (void)pushed;
+}
+
+void AsyncLoader::collectCooked() {
+  CookedLoad cooked;
+  while (m_cooked.pop(cooked)) {
+    LoadSlot *slot = m_loads.get(cooked.handle);
+    assert(slot != nullptr && slot->state == ASYNC_LOAD_STATE::COOKING);
+    --m_cookingCount;
+    if (!cooked.succeeded) {
+      slot->state = ASYNC_LOAD_STATE::FAILED;
+      continue;
+    }
+    slot->state = ASYNC_LOAD_STATE::UPLOADING;
+    m_uploadQueue.push(cooked.handle);
+  }
+}
+
+uint64_t AsyncLoader::processUploads() {
+  collectCooked();
+  uint64_t uploadedBytes = 0;
+  while (!m_uploadQueue.isEmpty() && (uploadedBytes < m_uploadBudgetInBytes)) {
+    LoadSlot *slot = m_loads.get(m_uploadQueue.front());
+    uploadedBytes += slot->task->upload(m_uploadBudgetInBytes - uploadedBytes);
+    if (!slot->task->isUploaded()) { break; }
+    slot->state = ASYNC_LOAD_STATE::DONE;
+    m_uploadQueue.pop();
+  }
+  return uploadedBytes;
+}
+
+void AsyncLoader::flush() {
+  if (m_jobSystem != nullptr) { m_jobSystem->wait(m_cookGroup); }
+  collectCooked();
+  while (!m_uploadQueue.isEmpty()) {
+    LoadSlot *slot = m_loads.get(m_uploadQueue.pop());
+    while (!slot->task->isUploaded()) { slot->task->upload(UINT64_MAX); }
+    slot->state = ASYNC_LOAD_STATE::DONE;
+  }
+}
+
+ASYNC_LOAD_STATE AsyncLoader::getState(const AsyncLoadHandle handle) const {
+  const LoadSlot *slot = m_loads.get(handle);
+  return slot != nullptr ? slot->state : ASYNC_LOAD_STATE::INVALID;
+}
+
+AsyncLoadTask *AsyncLoader::getTask(const AsyncLoadHandle handle) {
+  LoadSlot *slot = m_loads.get(handle);
+  return (slot != nullptr) && (slot->state == ASYNC_LOAD_STATE::DONE) ? slot->task.get() : nullptr;
+}
+
+bool AsyncLoader::release(const AsyncLoadHandle handle) {
+  const LoadSlot *slot = m_loads.get(handle);
+  if ((slot == nullptr) || (slot->state == ASYNC_LOAD_STATE::COOKING)) { return false; }
+  if (slot->state == ASYNC_LOAD_STATE::UPLOADING) {
+    // pulled out of the upload queue, the order of the others is kept
+    const int count = m_uploadQueue.usedElementCount();
+    for (int i = 0; i < count; ++i) {
+      const AsyncLoadHandle queued = m_uploadQueue.pop();
+      if (queued.index != handle.index) { m_uploadQueue.push(queued); }
+    }
+  }
+  return m_loads.remove(handle);
+}
+
+} // namespace SirMetal
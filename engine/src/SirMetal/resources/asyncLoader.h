@@ -0,0 +1,113 @@
+#pragma once
+#include <assert.h>
+#include <memory>
+#include <stdint.h>
+
+#include "SirMetal/core/core.h"
+#include "SirMetal/core/jobs/jobSystem.h"
+#include "SirMetal/core/memory/cpu/densePool.h"
+#include "SirMetal/core/memory/cpu/mpmcQueue.h"
+#include "SirMetal/core/memory/cpu/ringBuffer.h"
+
+namespace SirMetal {
+
+enum class ASYNC_LOAD_STATE { INVALID = 0, COOKING, UPLOADING, DONE, FAILED };
+
+using AsyncLoadHandle = DensePoolHandle;
+
+// A load split in two stages. cook runs on a worker, it reads and decodes the
+// file and builds all the GPU is going to need in CPU memory. upload runs on
+// the main thread in AsyncLoader::processUploads and creates the GPU
+// resources a piece at a time, such that a big asset is spread over frames.
+class AsyncLoadTask {
+public:
+  virtual ~AsyncLoadTask() = default;
+  // worker thread, false if the load failed, upload is never called then
+  virtual bool cook() = 0;
+  // main thread, uploads pieces until budgetInBytes is spent and at least one
+  // piece, returns the bytes uploaded
+  virtual uint64_t upload(uint64_t budgetInBytes) = 0;
+  [[nodiscard]] virtual bool isUploaded() const = 0;
+};
+
+// Loads assets in the background. A request returns a pending handle right
+// away and cooks the task on the job system. Cooked tasks are handed back to
+// the main thread through a MpmcQueue, processUploads, called once per frame,
+// uploads them in order until the bytes per frame budget is spent, the rest
+// waits for the next frame. A frame always uploads at least one piece, a
+// piece bigger than the budget does not stall the queue.
+// Everything but cook happens on the main thread.
+class AsyncLoader final {
+public:
+  static constexpr uint32_t MAX_LOADS_IN_FLIGHT = 1024;
+  static constexpr uint64_t DEFAULT_UPLOAD_BUDGET_IN_BYTES = 16 * MB_TO_BYTE;
+
+public:
+  AsyncLoader();
+  ~AsyncLoader();
+
+  // without a job system, or one with no workers, tasks are cooked right away
+  // in request
+  void initialize(JobSystem *jobSystem,
+                  uint64_t uploadBudgetInBytes = DEFAULT_UPLOAD_BUDGET_IN_BYTES);
+  // waits for the tasks being cooked, then drops every load
+  void cleanup();
+
+  // takes the task over, the handle is pending until the task is uploaded
+  AsyncLoadHandle request(std::unique_ptr<AsyncLoadTask> task);
+  // main thread, once per frame, returns the bytes uploaded
+  uint64_t processUploads();
+  // cooks and uploads everything in flight ignoring the budget, for loading
+  // screens
+  void flush();
+
+  [[nodiscard]] ASYNC_LOAD_STATE getState(AsyncLoadHandle handle) const;
+  [[nodiscard]] bool isDone(const AsyncLoadHandle handle) const {
+    return getState(handle) == ASYNC_LOAD_STATE::DONE;
+  }
+  // nullptr unless the load is done
+  [[nodiscard]] AsyncLoadTask *getTask(AsyncLoadHandle handle);
+  // drops the task and frees the handle, false while the task is cooking
+  bool release(AsyncLoadHandle handle);
+
+  // getters
+  // cooking and waiting for upload
+  [[nodiscard]] uint32_t getInFlightCount() const {
+    return m_cookingCount + static_cast<uint32_t>(m_uploadQueue.usedElementCount());
+  }
+  [[nodiscard]] uint64_t getUploadBudgetInBytes() const { return m_uploadBudgetInBytes; }
+  void setUploadBudgetInBytes(const uint64_t budgetInBytes) {
+    assert(budgetInBytes > 0);
+    m_uploadBudgetInBytes = budgetInBytes;
+  }
+
+  // deleted copy constructor and assignment operator
+  AsyncLoader(const AsyncLoader &) = delete;
+  AsyncLoader &operator=(const AsyncLoader &) = delete;
+
+private:
+  struct LoadSlot {
+    std::unique_ptr<AsyncLoadTask> task;
+    ASYNC_LOAD_STATE state = ASYNC_LOAD_STATE::INVALID;
+  };
+  struct CookedLoad {
+    AsyncLoadHandle handle;
+    bool succeeded = false;
+  };
+
+  // worker side, only touches the task and the cooked queue
+  void cook(AsyncLoadHandle handle, AsyncLoadTask *task);
+  // moves the cooked loads in the upload queue
+  void collectCooked();
+
+private:
+  JobSystem *m_jobSystem = nullptr;
+  TaskGroup m_cookGroup;
+  DensePool<LoadSlot> m_loads;
+  MpmcQueue<CookedLoad> m_cooked;
+  RingBuffer<AsyncLoadHandle> m_uploadQueue;
+  uint64_t m_uploadBudgetInBytes = DEFAULT_UPLOAD_BUDGET_IN_BYTES;
+  uint32_t m_cookingCount = 0;
+};
+
+} // namespace SirMetal
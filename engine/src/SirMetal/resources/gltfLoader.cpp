@@ -1,9 +1,14 @@
 #include "SirMetal/resources/gltfLoader.h"
+#include "SirMetal/core/jobs/jobSystem.h"
 #include "SirMetal/engine.h"
 #include "SirMetal/io/fileUtils.h"
+#include "SirMetal/resources/meshes/gltfMesh.h"
+#include "SirMetal/resources/meshes/meshCache.h"
 #include "SirMetal/resources/meshes/meshManager.h"
+#include "SirMetal/resources/textures/gltfTexture.h"
 #include "SirMetal/resources/textureManager.h"
 #include <SirMetal/core/mathUtils.h>
+#include <atomic>
 #include <simd/simd.h>
 
 #define CGLTF_IMPLEMENTATION
@@ -43,95 +48,292 @@ simd_float4x4 getMatrix(const cgltf_node &node) {
   return getMatrixFromComponents(t, r, s);
 }
 
-GLTFMaterial loadMaterial(EngineContext *context,
-                          const cgltf_material *material) {
+GLTFMaterial loadMaterialFactors(const cgltf_material *material) {
   GLTFMaterial outMaterial;
   outMaterial.name = material->name;
   outMaterial.doubleSided = true;
-  const auto &pbr = material->pbr_metallic_roughness;
-  auto colorFactor = pbr.base_color_factor;
+  auto colorFactor = material->pbr_metallic_roughness.base_color_factor;
   outMaterial.colorFactors = simd_float4{colorFactor[0], colorFactor[1],
                                          colorFactor[2], colorFactor[3]};
-  outMaterial.colorTexture = pbr.base_color_texture.texture
-                                     ? context->m_textureManager->loadFromMemory(
-                                               context->m_renderingContext->getDevice(),
-                                               context->m_renderingContext->getQueue(),
-                                               pbr.base_color_texture.texture,
-                                               LOAD_TEXTURE_TYPE::GLTF_TEXTURE, true)
-                                     : context->m_textureManager->getWhiteTexture();
-
   return outMaterial;
 }
 
-void loadNode(EngineContext *context, const cgltf_node *node,
-              GLTFAsset &outAsset, const GLTFLoadOptions& loadOptions,
-              simd_float4x4 parentMatrix) {
-  Model model{};
+// parses the file and loads its buffers, nullptr on failure
+cgltf_data *openGLTF(const char *path) {
+  cgltf_options options = {};
+  cgltf_data *data = nullptr;
+  cgltf_result result = cgltf_parse_file(&options, path, &data);
+  if (result != cgltf_result_success) {
+    printf("[Error] Error loading gltf file from %s\n", path);
+    return nullptr;
+  }
+
+  result = cgltf_load_buffers(&options, data, path);
+  if (result != cgltf_result_success) {
+    cgltf_free(data);
+    printf("[Error] Error loading gltf buffers from %s\n", path);
+    return nullptr;
+  }
+  return data;
+}
+
+// model of the file once cooked, meshes and textures are indices in the
+// unique meshes and textures of the file, they only get handles when uploaded
+struct CookedModel {
+  simd_float4x4 matrix;
+  int meshIndex = -1;
+  int textureIndex = -1;
+  bool hasMaterial = false;
   GLTFMaterial material{};
+};
+
+// every cgltf_mesh and cgltf_texture used by the scene, once, nodes sharing a
+// mesh share its index. cgltf keeps them in arrays, the position in the array
+// is the key of the remap, no hashing
+struct GLTFSceneImport {
+  std::vector<CookedModel> models;
+  std::vector<const cgltf_mesh *> meshes;
+  std::vector<const cgltf_texture *> textures;
+  std::vector<int> meshRemap;
+  std::vector<int> textureRemap;
+};
+
+int addUniqueMesh(GLTFSceneImport &import, const cgltf_data *data, const cgltf_mesh *mesh) {
+  int &index = import.meshRemap[mesh - data->meshes];
+  if (index == -1) {
+    index = static_cast<int>(import.meshes.size());
+    import.meshes.push_back(mesh);
+  }
+  return index;
+}
+
+int addUniqueTexture(GLTFSceneImport &import, const cgltf_data *data,
+                     const cgltf_texture *texture) {
+  int &index = import.textureRemap[texture - data->textures];
+  if (index == -1) {
+    index = static_cast<int>(import.textures.size());
+    import.textures.push_back(texture);
+  }
+  return index;
+}
+
+// walks the hierarchy, no decoding, only what is used where
+void collectNode(const cgltf_data *data, const cgltf_node *node,
+                 const GLTFLoadOptions &loadOptions, simd_float4x4 parentMatrix,
+                 GLTFSceneImport &import) {
+  CookedModel model{};
   if (node->mesh != nullptr) {
-    printf("loading mesh for node %s\n", node->name);
     assert(node->mesh->primitives_count == 1 &&
            "gltf loader does not support multiple primitives per mesh yet");
-    model.mesh = context->m_meshManager->loadFromMemory(
-            node->mesh, LOAD_MESH_TYPE::GLTF_MESH, &loadOptions);
+    model.meshIndex = addUniqueMesh(import, data, node->mesh);
 
-    assert(node->mesh->primitives_count == 1);
-
-    if (node->mesh->primitives[0].material != nullptr) {
-      material =
-              loadMaterial(context, node->mesh->primitives[0].material);
+    const cgltf_material *material = node->mesh->primitives[0].material;
+    if (material != nullptr) {
+      model.hasMaterial = true;
+      model.material = loadMaterialFactors(material);
+      const cgltf_texture *texture = material->pbr_metallic_roughness.base_color_texture.texture;
+      if (texture != nullptr) { model.textureIndex = addUniqueTexture(import, data, texture); }
     }
   }
 
-  simd_float4x4 matrix = getMatrix(*node);
-  model.matrix = simd_mul(parentMatrix, matrix);
+  model.matrix = simd_mul(parentMatrix, getMatrix(*node));
 
   bool flatten = (loadOptions.flags & GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY) > 0;
   bool isEmpty = node->mesh == nullptr;
   if (!(flatten & isEmpty)) {
-    outAsset.models.push_back(model);
-    outAsset.materials.push_back(material);
+    import.models.push_back(model);
   }
 
   for (int c = 0; c < node->children_count; ++c) {
-    const auto *child = node->children[c];
-    loadNode(context, child, outAsset, loadOptions, model.matrix);
+    collectNode(data, node->children[c], loadOptions, model.matrix, import);
   }
 }
 
-bool loadGLTF(EngineContext *context, const char *path, GLTFAsset &outAsset,
-              const GLTFLoadOptions& loadOptions) {
-  assert(((loadOptions.flags & GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY) > 0) &&
-         "only flatten hierarchy supported for now");
-  assert(fileExists(path));
-  cgltf_options options = {};
-  cgltf_data *data = nullptr;
-  cgltf_result result = cgltf_parse_file(&options, path, &data);
-  if (result != cgltf_result_success) {
-    printf("[Error] Error loading gltf file from %s\n", path);
-    return false;
-  }
+// Cook parses the file, collects the unique meshes and textures and decodes
+// them, one job each, on the job system when there is one. Every unique
+// texture and mesh is then a piece of the upload, textures go first, the
+// materials point at them. The CPU copy of a piece is dropped once uploaded.
+// With the mesh cache a mesh found in a .smesh file is mapped instead of
+// cooked and uploaded straight from the mapping, a cooked one is written out.
+class GLTFLoadTask final : public AsyncLoadTask {
+  public:
+  GLTFLoadTask(EngineContext *context, const char *path, const GLTFLoadOptions &options)
+      : m_context(context), m_path(path), m_options(options) {}
+
+  bool cook() override {
+    if (!fileExists(m_path)) {
+      printf("[Error] Could not find gltf file %s\n", m_path.c_str());
+      return false;
+    }
+    cgltf_data *data = openGLTF(m_path.c_str());
+    if (data == nullptr) { return false; }
+    printf("Loading gltf file %s\n", m_path.c_str());
+
+    GLTFSceneImport import;
+    import.meshRemap.resize(data->meshes_count, -1);
+    import.textureRemap.resize(data->textures_count, -1);
+    cgltf_scene *scene = data->scene;
+    for (int i = 0; i < scene->nodes_count; ++i) {
+      collectNode(data, scene->nodes[i], m_options, getIdentity(), import);
+    }
+    m_models = std::move(import.models);
+
+    // meshes and textures in a single range, the slow ones (xatlas, big
+    // PNGs) get balanced by stealing
+    const auto meshCount = static_cast<uint32_t>(import.meshes.size());
+    const auto textureCount = static_cast<uint32_t>(import.textures.size());
+    m_meshes.resize(meshCount);
+    m_cachedMeshes.resize(meshCount);
+    m_textures.resize(textureCount);
+    const bool useMeshCache = (m_options.flags & GLTF_LOAD_FLAGS_MESH_CACHE) > 0;
+    const std::string fileFolder = getPathName(m_path);
+    const std::string cacheFolder = !m_options.meshCacheFolder.empty()
+                                            ? m_options.meshCacheFolder
+                                            : (fileFolder.empty() ? "." : fileFolder) + "/.smesh";
+    std::atomic<uint32_t> cacheHits{0};
+    auto decode = [&](const uint32_t begin, const uint32_t end) {
+      for (uint32_t i = begin; i < end; ++i) {
+        if ((i < meshCount) & useMeshCache) {
+          const uint64_t key = computeGltfMeshCacheKey(import.meshes[i], &m_options);
+          const std::string cachePath = getMeshCachePath(cacheFolder, key);
+          if (m_cachedMeshes[i].open(cachePath.c_str(), key)) {
+            cacheHits.fetch_add(1, std::memory_order_relaxed);
+          } else if (loadGltfMesh(m_meshes[i], import.meshes[i], &m_options)) {
+            writeMeshCache(cachePath.c_str(), key, m_meshes[i]);
+          }
+        } else if (i < meshCount) {
+          loadGltfMesh(m_meshes[i], import.meshes[i], &m_options);
+        } else {
+          loadGltfTexture(m_textures[i - meshCount],
+                          const_cast<cgltf_texture *>(import.textures[i - meshCount]), true);
+        }
+      }
+    };
+    if (globals::JOB_SYSTEM != nullptr) {
+      globals::JOB_SYSTEM->parallelFor(meshCount + textureCount, 1, decode);
+    } else {
+      decode(0, meshCount + textureCount);
+    }
+    printf("Cooked %u models, %u unique meshes (%u from the mesh cache) and %u unique "
+           "textures\n",
+           static_cast<uint32_t>(m_models.size()), meshCount, cacheHits.load(), textureCount);
 
-  result = cgltf_load_buffers(&options, data, path);
-  if (result != cgltf_result_success) {
     cgltf_free(data);
-    printf("[Error] Error loading gltf buffers from %s\n", path);
-    return false;
+    return true;
+  }
+
+  uint64_t upload(uint64_t budgetInBytes) override {
+    uint64_t uploaded = 0;
+    while (!isUploaded()) {
+      const uint64_t pieceSize = getNextPieceSize();
+      if ((uploaded != 0) & (uploaded + pieceSize > budgetInBytes)) { break; }
+      uploadNextPiece();
+      uploaded += pieceSize;
+    }
+    if (isUploaded() & (m_asset.models.size() != m_models.size())) { buildAsset(); }
+    return uploaded;
+  }
+
+  bool isUploaded() const override {
+    return (m_textureHandles.size() == m_textures.size()) &
+           (m_meshHandles.size() == m_meshes.size());
+  }
+
+  const GLTFAsset &getAsset() const { return m_asset; }
+
+  private:
+  uint64_t getNextPieceSize() const {
+    if (m_textureHandles.size() < m_textures.size()) {
+      return m_textures[m_textureHandles.size()].data.size();
+    }
+    const CachedMesh &cached = m_cachedMeshes[m_meshHandles.size()];
+    if (cached.isOpen()) {
+      return cached.getVertexSizeInBytes() + cached.getIndexCount() * sizeof(uint32_t);
+    }
+    const MeshLoadResult &mesh = m_meshes[m_meshHandles.size()];
+    return mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(uint32_t);
   }
 
-  printf("Loading gltf file %s\n", path);
+  void uploadNextPiece() {
+    if (m_textureHandles.size() < m_textures.size()) {
+      TextureLoadResult &texture = m_textures[m_textureHandles.size()];
+      m_textureHandles.push_back(m_context->m_textureManager->loadFromLoadResult(
+              m_context->m_renderingContext->getDevice(),
+              m_context->m_renderingContext->getQueue(), texture));
+      std::vector<unsigned char>().swap(texture.data);
+      return;
+    }
+    CachedMesh &cached = m_cachedMeshes[m_meshHandles.size()];
+    if (cached.isOpen()) {
+      m_meshHandles.push_back(m_context->m_meshManager->loadFromCachedMesh(cached));
+      cached.close();
+      return;
+    }
+    MeshLoadResult &mesh = m_meshes[m_meshHandles.size()];
+    m_meshHandles.push_back(m_context->m_meshManager->loadFromLoadResult(mesh));
+    std::vector<float>().swap(mesh.vertices);
+    std::vector<uint32_t>().swap(mesh.indices);
+  }
 
-  cgltf_scene *scene = data->scene;
-  // iterate the the scene
-  int nodesCount = scene->nodes_count;
-  for (int i = 0; i < nodesCount; ++i) {
-    auto *node = scene->nodes[i];
-    printf("Node -> %s\n", node->name);
-    loadNode(context, node, outAsset, loadOptions, getIdentity());
+  // models sharing a mesh or a texture get the same handle
+  void buildAsset() {
+    for (const CookedModel &cooked : m_models) {
+      Model model{};
+      model.matrix = cooked.matrix;
+      if (cooked.meshIndex >= 0) { model.mesh = m_meshHandles[cooked.meshIndex]; }
+      GLTFMaterial material = cooked.material;
+      if (cooked.hasMaterial) {
+        material.colorTexture = cooked.textureIndex >= 0
+                                        ? m_textureHandles[cooked.textureIndex]
+                                        : m_context->m_textureManager->getWhiteTexture();
+      }
+      m_asset.models.push_back(model);
+      m_asset.materials.push_back(material);
+    }
   }
 
-  cgltf_free(data);
+  private:
+  EngineContext *m_context;
+  std::string m_path;
+  GLTFLoadOptions m_options;
+  std::vector<CookedModel> m_models;
+  std::vector<MeshLoadResult> m_meshes;
+  // open when the mesh was found in the cache, m_meshes is empty then
+  std::vector<CachedMesh> m_cachedMeshes;
+  std::vector<TextureLoadResult> m_textures;
+  std::vector<MeshHandle> m_meshHandles;
+  std::vector<TextureHandle> m_textureHandles;
+  GLTFAsset m_asset;
+};
+
+bool loadGLTF(EngineContext *context, const char *path, GLTFAsset &outAsset,
+              const GLTFLoadOptions& loadOptions) {
+  assert(((loadOptions.flags & GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY) > 0) &&
+         "only flatten hierarchy supported for now");
+  assert(fileExists(path));
+  // same path as the async load, cooked on the job system, uploaded at once
+  GLTFLoadTask task(context, path, loadOptions);
+  if (!task.cook()) { return false; }
+  // at least one call, an empty file still builds its asset
+  do { task.upload(UINT64_MAX); } while (!task.isUploaded());
+  const GLTFAsset &asset = task.getAsset();
+  outAsset.models.insert(outAsset.models.end(), asset.models.begin(), asset.models.end());
+  outAsset.materials.insert(outAsset.materials.end(), asset.materials.begin(),
+                            asset.materials.end());
   return true;
 }
 
+AsyncLoadHandle loadGLTFAsync(EngineContext *context, const char *path,
+                              const GLTFLoadOptions &options) {
+  assert(((options.flags & GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY) > 0) &&
+         "only flatten hierarchy supported for now");
+  return context->m_asyncLoader->request(
+          std::make_unique<GLTFLoadTask>(context, path, options));
+}
+
+const GLTFAsset *getGLTFAsset(EngineContext *context, AsyncLoadHandle handle) {
+  const auto *task = static_cast<const GLTFLoadTask *>(context->m_asyncLoader->getTask(handle));
+  return task != nullptr ? &task->getAsset() : nullptr;
+}
+
 }// namespace SirMetal
\ No newline at end of file
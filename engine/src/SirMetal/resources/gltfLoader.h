@@ -1,4 +1,5 @@
 #pragma once
+#include "SirMetal/resources/asyncLoader.h"
 #include "SirMetal/resources/handle.h"
 #include "SirMetal/resources/resourceTypes.h"
 #include <string>
@@ -23,6 +24,9 @@ enum GLTFLoadFlags : uint32_t {
   GLTF_LOAD_FLAGS_NONE = 0,
   GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY = 1,
   GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS = 2,
+  // cooked meshes are written to and mapped back from .smesh files, a warm
+  // start skips the mesh optimization and the light map uvs generation
+  GLTF_LOAD_FLAGS_MESH_CACHE = 4,
 };
 
 
@@ -30,8 +34,18 @@ struct GLTFLoadOptions
 {
   uint32_t flags = GLTF_LOAD_FLAGS_NONE; //GLTFLoadFlags
   uint32_t lightMapSize = 2048;
+  // where the .smesh files go, empty is a .smesh folder next to the gltf file
+  std::string meshCacheFolder;
 };
 bool loadGLTF(EngineContext *context, const char *path, GLTFAsset &outAsset,
               const GLTFLoadOptions& options);
 
+// Same as loadGLTF but returns right away. The file is parsed and its meshes
+// and textures are decoded on the job system, the GPU resources are created by
+// the engine AsyncLoader over the next frames, within the upload budget.
+AsyncLoadHandle loadGLTFAsync(EngineContext *context, const char *path,
+                              const GLTFLoadOptions &options);
+// the asset of a handle returned by loadGLTFAsync, nullptr until it is done
+const GLTFAsset *getGLTFAsset(EngineContext *context, AsyncLoadHandle handle);
+
 }// namespace SirMetal
\ No newline at end of file
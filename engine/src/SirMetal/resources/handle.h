@@ -10,26 +10,42 @@ namespace SirMetal {
         TEXTURE = 1,
         SHADER_LIBRARY = 2,
         MESH = 3,
-        CONSTANT_BUFFER= 4,
-        BUFFER= 4,
+        CONSTANT_BUFFER = 4,
+        BUFFER = 5,
     };
 
+    // A handle packs, from the high bits down, 8 bits of type, 8 bits of
+    // generation and a 16 bits index. The generation is bumped every time a
+    // slot is freed, such that a handle outliving its resource is detected
+    // instead of silently aliasing whatever reused the slot, see slotMap.h.
+    // The type is never NONE for a valid handle, so 0 stays the invalid handle.
+    static constexpr uint32_t HANDLE_INDEX_BITS = 16;
+    static constexpr uint32_t HANDLE_GENERATION_BITS = 8;
+    static constexpr uint32_t HANDLE_TYPE_SHIFT = HANDLE_INDEX_BITS + HANDLE_GENERATION_BITS;
+    static constexpr uint32_t HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+    static constexpr uint32_t HANDLE_GENERATION_MASK = (1u << HANDLE_GENERATION_BITS) - 1;
+    static constexpr uint32_t HANDLE_MAX_INDEX = HANDLE_INDEX_MASK;
+
     template<typename T>
-    inline T getHandle(const uint32_t index) {
-        return {(static_cast<uint32_t>(T::type) << 24)| index};
+    inline T getHandle(const uint32_t index, const uint32_t generation = 0) {
+        return {(static_cast<uint32_t>(T::type) << HANDLE_TYPE_SHIFT) |
+                ((generation & HANDLE_GENERATION_MASK) << HANDLE_INDEX_BITS) |
+                (index & HANDLE_INDEX_MASK)};
     }
 
     template<typename T>
     inline uint32_t getIndexFromHandle(const T h) {
-        constexpr uint32_t standardIndexMask = (1 << 24) - 1;
-        return h.handle & standardIndexMask;
+        return h.handle & HANDLE_INDEX_MASK;
+    }
+
+    template<typename T>
+    inline uint32_t getGenerationFromHandle(const T h) {
+        return (h.handle >> HANDLE_INDEX_BITS) & HANDLE_GENERATION_MASK;
     }
 
     template<typename T>
     inline HANDLE_TYPE getTypeFromHandle(const T h) {
-        constexpr uint32_t standardIndexMask = (1 << 8) - 1;
-        const uint32_t standardMagicNumberMask = ~standardIndexMask;
-        return static_cast<HANDLE_TYPE>((h.handle & standardMagicNumberMask) >> 24);
+        return static_cast<HANDLE_TYPE>(h.handle >> HANDLE_TYPE_SHIFT);
     }
 
     struct TextureHandle final {
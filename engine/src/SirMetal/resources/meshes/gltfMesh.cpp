@@ -1,11 +1,16 @@
 #include "SirMetal/resources/meshes/gltfMesh.h"
+#include "SirMetal/core/hashing/hashing.h"
 #include "SirMetal/resources/gltfLoader.h"
+#include "SirMetal/resources/meshes/meshCache.h"
 #include "SirMetal/resources/meshes/meshOptimize.h"
+#include "SirMetal/resources/meshes/vertexStreams.h"
 
 #include <cgltf/cgltf.h>
 #include <xatlas/xatlas.h>
 
 #include <chrono>
+#include <cstdio>
+#include <cstring>
 
 namespace SirMetal {
 static cgltf_size component_size(cgltf_component_type component_type) {
@@ -46,6 +51,65 @@ static cgltf_size component_count(cgltf_type type) {
   }
 }
 
+// start of the accessor data, the accessor offset is relative to the view
+static const void *getAccessorData(const cgltf_accessor *accessor) {
+  const cgltf_buffer_view *view = accessor->buffer_view;
+  return static_cast<const char *>(view->buffer->data) + view->offset + accessor->offset;
+}
+
+// byte distance between two elements, a view shared by interleaved attributes
+// has an explicit stride, otherwise elements are packed
+static uint32_t getAccessorStride(const cgltf_accessor *accessor) {
+  const cgltf_buffer_view *view = accessor->buffer_view;
+  if (view->stride != 0) { return static_cast<uint32_t>(view->stride); }
+  return static_cast<uint32_t>(component_size(accessor->component_type) *
+                               component_count(accessor->type));
+}
+
+static const cgltf_accessor *findAttributeAccessor(const cgltf_primitive &prim,
+                                                   const char *attribute) {
+  for (int a = 0; a < prim.attributes_count; ++a) {
+    if (strcmp(prim.attributes[a].name, attribute) == 0) { return prim.attributes[a].data; }
+  }
+  return nullptr;
+}
+
+// layout and bytes of the accessor, chained on the seed
+static uint64_t hashAccessor(const cgltf_accessor *accessor, const uint64_t seed) {
+  if ((accessor == nullptr) || (accessor->buffer_view == nullptr)) {
+    return hashUint64(seed) ^ seed;
+  }
+  const uint64_t layout[4] = {accessor->count, getAccessorStride(accessor),
+                              static_cast<uint64_t>(accessor->component_type),
+                              static_cast<uint64_t>(accessor->type)};
+  uint64_t hash = util::Hash64WithSeed(reinterpret_cast<const char *>(layout), sizeof(layout), seed);
+  if (accessor->count == 0) { return hash; }
+  const uint64_t elementSize =
+          component_size(accessor->component_type) * component_count(accessor->type);
+  const uint64_t sizeInBytes = (accessor->count - 1) * getAccessorStride(accessor) + elementSize;
+  return util::Hash64WithSeed(static_cast<const char *>(getAccessorData(accessor)), sizeInBytes,
+                              hash);
+}
+
+uint64_t computeGltfMeshCacheKey(const void *gltfMesh, const void *options) {
+  const auto *mesh = reinterpret_cast<const cgltf_mesh *>(gltfMesh);
+  const auto *typedOptions = static_cast<const GLTFLoadOptions *>(options);
+  assert(mesh->primitives_count == 1);
+  const cgltf_primitive &prim = mesh->primitives[0];
+
+  // only the options changing the cooked mesh are part of the key
+  const bool generateLightUVs = (typedOptions->flags & GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS) > 0;
+  const uint32_t settings[3] = {MESH_CACHE_VERSION, generateLightUVs ? 1u : 0u,
+                                generateLightUVs ? typedOptions->lightMapSize : 0u};
+  uint64_t key = util::Hash64(reinterpret_cast<const char *>(settings), sizeof(settings));
+  // the name ends up in the file, it is part of the result
+  if (mesh->name != nullptr) { key = util::Hash64WithSeed(mesh->name, strlen(mesh->name), key); }
+  for (int attrIdx = 0; attrIdx < MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP; ++attrIdx) {
+    key = hashAccessor(findAttributeAccessor(prim, MESH_ATTRIBUTES[attrIdx]), key);
+  }
+  return hashAccessor(prim.indices, key);
+}
+
 bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* options) {
   const auto *mesh = reinterpret_cast<const cgltf_mesh *>(gltfMesh);
 
@@ -53,190 +117,117 @@ bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* opt
   auto gltfFlags = static_cast<GLTFLoadFlags>(typedOptions->flags);
   // assuming primitive count 1
   assert(mesh->primitives_count == 1);
-  cgltf_primitive &prim = mesh->primitives[0];
-
-  int uniqueVerticesCount = -1;
-  // we can't simply throw memory into a buffer and hope it works. we are going
-  // to create views for the same buffer, each view will point to a different
-  // part of the buffer, for example a view will only refer to the position of
-  // the mesh and so on.As such the data needs to be correctly aligned for
-  // example normals appear after positions, the start of the normals data needs
-  // to be aligned to the requested boundary if this is not the case we will add
-  // some padding.
-  constexpr uint32_t aligmentInFloats = 64;
-
-  // here we accumulate all the extra data we added due to alignment
-  int aligmentOffsets = 0;
+  const cgltf_primitive &prim = mesh->primitives[0];
+  outMesh.name = mesh->name != nullptr ? mesh->name : "";
 
   // for our mesh to be normalized to what the engine expects we require 4
   // attributes pos,normals, uvs and tangents, we look for such attributes in
-  // the Gltf
-  bool found = false;
-  int foundIdx = 0;
-
-  std::vector<float> fullMeshData[MESH_ATTRIBUTE_TYPE_COUNT];
-  float strides[MESH_ATTRIBUTE_TYPE_COUNT] = {};
-
-  for (int attrIdx = 0; attrIdx < MESH_ATTRIBUTE_TYPE_COUNT; ++attrIdx) {
-    const char *attribute = MESH_ATTRIBUTES[attrIdx];
-    for (int a = 0; a < prim.attributes_count; ++a) {
-      const cgltf_attribute &primAttr = prim.attributes[a];
-      found = strcmp(primAttr.name, attribute) == 0;
-      if (found) {
-        foundIdx = a;
-        break;
-      }
-    }
-
-    // if attribute is not found we patch in dummy data
-    if (!found) {
-      bool required = MESH_ATTRIBUTE_REQUIRED[attrIdx];
-
-      // we just make sure we know how many unique vertices we have
-      // this should never trigger because if we don't have position is useless
-      // data
-      if (strcmp(attribute, MESH_ATTRIBUTES[MESH_ATTRIBUTE_TYPE_POSITION]) == 0) {
-        printf("[ERROR] Position mesh attribute is empty, cannot be filled "
-               "with zeroes");
-        return {};
-      }
+  // the Gltf, the light map uvs are generated, never read
+  static constexpr int FILE_ATTRIBUTES_COUNT = MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP;
+  const cgltf_accessor *accessors[FILE_ATTRIBUTES_COUNT] = {};
+  for (int attrIdx = 0; attrIdx < FILE_ATTRIBUTES_COUNT; ++attrIdx) {
+    accessors[attrIdx] = findAttributeAccessor(prim, MESH_ATTRIBUTES[attrIdx]);
+  }
 
-      //if the attribute is required we fill it with zero and print a warning
-      //if not we simply continue
-      if (required) {
-        printf("[ERROR] Could not find %s attribute in gltf file, and is a required one"
-               "... filling with zeroes\n",
-               MESH_ATTRIBUTES[attrIdx]);
-        assert(uniqueVerticesCount != -1);
-        uint32_t sizeInFloats = MESH_ATTRIBUTE_SIZE_IN_BYTES[attrIdx] / sizeof(float);
-        fullMeshData[attrIdx].resize(uniqueVerticesCount * sizeInFloats);
-        memset(fullMeshData[attrIdx].data(), 0,
-               fullMeshData[attrIdx].size() * sizeof(float));
-      }
+  // position defines how many unique vertices we have, without it the rest
+  // is useless data
+  if (accessors[MESH_ATTRIBUTE_TYPE_POSITION] == nullptr) {
+    printf("[ERROR] Position mesh attribute is empty, cannot be filled "
+           "with zeroes\n");
+    return false;
+  }
+  const auto vertexCount = static_cast<uint32_t>(accessors[MESH_ATTRIBUTE_TYPE_POSITION]->count);
+
+  for (int attrIdx = 0; attrIdx < FILE_ATTRIBUTES_COUNT; ++attrIdx) {
+    const cgltf_accessor *accessor = accessors[attrIdx];
+    if (accessor == nullptr) {
+      // the blob is zero initialized, nothing else to do
+      printf("[ERROR] Could not find %s attribute in gltf file, and is a required one"
+             "... filling with zeroes\n",
+             MESH_ATTRIBUTES[attrIdx]);
       continue;
     }
-
-    assert(foundIdx < 4);
-    auto &meshData = fullMeshData[attrIdx];
-
-    // gltf maps a vertex attribute to an accessor, an accessor contains data
-    // telling us how to read/access the data to make sense of it.
-    const cgltf_accessor *accessor = mesh->primitives->attributes[foundIdx].data;
-    // the buffer view will tell us which region of the buffer contains the data
-    // we need
-    const cgltf_buffer_view *view = accessor->buffer_view;
-
-    // making sure all the vertex attributes have
-    int accessorCount = static_cast<int>(accessor->count);
-    uniqueVerticesCount = uniqueVerticesCount == -1 ? accessorCount : uniqueVerticesCount;
-    if (uniqueVerticesCount != accessorCount) {
+    if (accessor->count != vertexCount) {
       printf("[ERROR] Mismatched mesh attribute count for index %i. Required "
-             "%i but got %i\n",
-             attrIdx, uniqueVerticesCount, accessorCount);
-      return {};
+             "%u but got %lu\n",
+             attrIdx, vertexCount, accessor->count);
+      return false;
+    }
+    if (accessor->buffer_view == nullptr) {
+      printf("[ERROR] Vertex attribute with index %i has no buffer view, sparse "
+             "accessors are not supported\n",
+             attrIdx);
+      return false;
     }
-
-    const float *dataToCopy =
-            reinterpret_cast<float *>((char *) view->buffer->data + view->offset);
-
     // this tell us the component size in bytes, so if we have a vec3, it means
     // we have 3 components, each component will have size 4bytes
-    int datatypeSize = component_size(accessor->component_type);
-    if (datatypeSize != 4) {
-      printf("Vertex attribute with index %i has unexpected component width. "
-             "Expected 4, got %i\n",
-             attrIdx, datatypeSize);
-      return {};
-    }
-    int componentCount = component_count(accessor->type);
-    strides[attrIdx] = MESH_ATTRIBUTE_SIZE_IN_BYTES[attrIdx] / 4;
-
-    // we are normalizing the data to float4 or float2, this means we will need
-    // to fill a value if we get a vec3, we use a different filler per attribute
-    float filler = attrIdx == 0 ? 1.0f : 0.0f;
-
-    for (int idx = 0; idx < uniqueVerticesCount; ++idx) {
-      meshData.push_back(dataToCopy[idx * componentCount + 0]);
-      meshData.push_back(dataToCopy[idx * componentCount + 1]);
-      if (attrIdx != MESH_ATTRIBUTE_TYPE_UV) {
-        // if is not a UV (float2) we push in the 3rd parameter plus filler
-        meshData.push_back(dataToCopy[idx * componentCount + 2]);
-        meshData.push_back(filler);
-      }
+    cgltf_size datatypeSize = component_size(accessor->component_type);
+    cgltf_size requiredComponents = attrIdx == MESH_ATTRIBUTE_TYPE_UV ? 2 : 3;
+    if ((datatypeSize != 4) | (component_count(accessor->type) < requiredComponents)) {
+      printf("Vertex attribute with index %i has unexpected component width or count. "
+             "Expected 4 bytes and %lu components, got %lu\n",
+             attrIdx, requiredComponents, datatypeSize);
+      return false;
     }
+  }
 
-    size_t end = static_cast<uint32_t>(meshData.size());
-
-    if (attrIdx == MESH_ATTRIBUTE_TYPE_POSITION) {
-      // generate bounding boxes for the positions
-      float minX = std::numeric_limits<float>::max();
-      float minY = minX;
-      float minZ = minY;
-      float maxX = std::numeric_limits<float>::min();
-      float maxY = maxX;
-      float maxZ = maxX;
-      const float *posData = meshData.data();
-      for (size_t p = 0; p < end; p += 4) {
-        const float *vtx = posData + p;
-
-        // lets us compute bounding box
-        minX = vtx[0] < minX ? vtx[0] : minX;
-        minY = vtx[1] < minY ? vtx[1] : minY;
-        minZ = vtx[2] < minZ ? vtx[2] : minZ;
-
-        maxX = vtx[0] > maxX ? vtx[0] : maxX;
-        maxY = vtx[1] > maxY ? vtx[1] : maxY;
-        maxZ = vtx[2] > maxZ ? vtx[2] : maxZ;
-      }
-      outMesh.m_boundingBox[0] = minX;
-      outMesh.m_boundingBox[1] = minY;
-      outMesh.m_boundingBox[2] = minZ;
-      outMesh.m_boundingBox[3] = maxX;
-      outMesh.m_boundingBox[4] = maxY;
-      outMesh.m_boundingBox[5] = maxZ;
+  bool generateLightUVs = (gltfFlags & GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS) > 0;
+  //if we have the uv maps we have an extra attributes. this is good enough until we have skinning, then it will be trickier
+  uint32_t attributesCount = 4 + (generateLightUVs ? 1 : 0);
+
+  // the attributes are written straight from the gltf buffers into the final
+  // de-interleaved, 256 bytes aligned, vertex blob. Vec3 are normalized to
+  // float4 with a filler per attribute, the bounding box comes out of the same
+  // pass over the positions
+  outMesh.vertices.resize(computeVertexBlobLayout(vertexCount, attributesCount, outMesh.ranges));
+  float *blob = outMesh.vertices.data();
+  for (int attrIdx = 0; attrIdx < FILE_ATTRIBUTES_COUNT; ++attrIdx) {
+    const cgltf_accessor *accessor = accessors[attrIdx];
+    if (accessor == nullptr) { continue; }
+    float *out = blob + outMesh.ranges[attrIdx].m_offset / sizeof(float);
+    if (attrIdx == MESH_ATTRIBUTE_TYPE_UV) {
+      extractFloat2(getAccessorData(accessor), getAccessorStride(accessor), vertexCount, out);
+      continue;
     }
+    float filler = attrIdx == MESH_ATTRIBUTE_TYPE_POSITION ? 1.0f : 0.0f;
+    float *boundingBox =
+            attrIdx == MESH_ATTRIBUTE_TYPE_POSITION ? outMesh.m_boundingBox : nullptr;
+    extractFloat3ToFloat4(getAccessorData(accessor), getAccessorStride(accessor), vertexCount,
+                          filler, out, boundingBox);
   }
 
   // processing the index buffer
-  const cgltf_accessor *accessor = prim.indices;
-  const cgltf_buffer_view *view = accessor->buffer_view;
-  cgltf_size componentSize = component_size(accessor->component_type);
-
-  if (componentSize == 4) {
-    const auto *source = reinterpret_cast<uint32_t const *>((char *) view->buffer->data +
-                                                            view->offset);
-    for (size_t idx = 0; idx < accessor->count; ++idx) {
-      outMesh.indices.push_back(source[idx]);
-    }
-  } else {
-    if (componentSize != 2) {
-      printf("Mesh index buffer needs to be either 4 or 2 bytes, got %lu\n",
-             componentSize);
-      return {};
-    }
-    const auto *source = reinterpret_cast<uint16_t const *>((char *) view->buffer->data +
-                                                            view->offset);
-    for (size_t idx = 0; idx < accessor->count; ++idx) {
-      outMesh.indices.push_back(source[idx]);
-    }
+  const cgltf_accessor *indexAccessor = prim.indices;
+  if ((indexAccessor == nullptr) || (indexAccessor->buffer_view == nullptr)) {
+    printf("[ERROR] Mesh %s has no index buffer\n", outMesh.name.c_str());
+    return false;
+  }
+  outMesh.indices.resize(indexAccessor->count);
+  cgltf_size componentSize = component_size(indexAccessor->component_type);
+  if (!extractIndices(getAccessorData(indexAccessor), static_cast<uint32_t>(componentSize),
+                      getAccessorStride(indexAccessor),
+                      static_cast<uint32_t>(indexAccessor->count), outMesh.indices.data())) {
+    printf("Mesh index buffer needs to be either 4, 2 or 1 bytes, got %lu\n", componentSize);
+    return false;
   }
 
-  bool generateLightUVs = (gltfFlags & GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS) > 0;
+  uint32_t uniqueVerticesCount = vertexCount;
   if (generateLightUVs) {
     auto t1 = std::chrono::high_resolution_clock::now();
 
     //let us generate the uvs for lightmapping
     //Atlas_Dim dim;
     xatlas::Atlas *atlas = xatlas::Create();
-    // Prepare mesh to be processed by xatlas:
+    // Prepare mesh to be processed by xatlas, it reads the ranges of the blob
+    // with their stride, no copy
     {
       xatlas::MeshDecl meshDcl;
-      meshDcl.vertexCount = static_cast<uint32_t>(fullMeshData[0].size()) / 4;
-      meshDcl.vertexPositionData = fullMeshData[0].data();
+      meshDcl.vertexCount = vertexCount;
+      meshDcl.vertexPositionData = blob + outMesh.ranges[MESH_ATTRIBUTE_TYPE_POSITION].m_offset / 4;
       meshDcl.vertexPositionStride = sizeof(float) * 4;
-      meshDcl.vertexNormalData = fullMeshData[1].data();
+      meshDcl.vertexNormalData = blob + outMesh.ranges[MESH_ATTRIBUTE_TYPE_NORMAL].m_offset / 4;
       meshDcl.vertexNormalStride = sizeof(float) * 4;
-      meshDcl.vertexUvData = fullMeshData[2].data();
+      meshDcl.vertexUvData = blob + outMesh.ranges[MESH_ATTRIBUTE_TYPE_UV].m_offset / 4;
       meshDcl.vertexUvStride = sizeof(float) * 2;
       meshDcl.indexCount = outMesh.indices.size();
       meshDcl.indexData = outMesh.indices.data();
@@ -244,6 +235,7 @@ bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* opt
       xatlas::AddMeshError::Enum error = xatlas::AddMesh(atlas, meshDcl);
       if (error != xatlas::AddMeshError::Success) {
         printf("error adding atlas");
+        xatlas::Destroy(atlas);
         return false;
       }
     }
@@ -258,61 +250,36 @@ bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* opt
       packoptions.blockAlign = true;
 
       xatlas::Generate(atlas, chartoptions, packoptions);
-      int aw = atlas->width;
-      int ah = atlas->height;
-
-
-      xatlas::Mesh &atlasMesh = atlas->meshes[0];
-
-      outMesh.indices.clear();
-      outMesh.indices.resize(atlasMesh.indexCount);
-      std::vector<float> apos(atlasMesh.vertexCount * 4);
-      std::vector<float> anorm(atlasMesh.vertexCount * 4);
-      std::vector<float> auv(atlasMesh.vertexCount * 2);
-      std::vector<float> atan(atlasMesh.vertexCount * 4);
-      fullMeshData[MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP].resize(atlasMesh.vertexCount * 2);
-
-
-      for (uint32_t j = 0; j < atlasMesh.indexCount; ++j) {
-        const uint32_t ind = atlasMesh.indexArray[j];
-        const xatlas::Vertex &v = atlasMesh.vertexArray[ind];
-        assert(j < outMesh.indices.size());
-        outMesh.indices[j] = ind;
-        uint32_t vid = ind * 4u;
-        uint32_t vidSrc = v.xref * 4u;
-        assert(vid < apos.size());
-        assert(vidSrc < fullMeshData[0].size());
-        apos[vid + 0] = fullMeshData[0][vidSrc + 0];
-        apos[vid + 1] = fullMeshData[0][vidSrc + 1];
-        apos[vid + 2] = fullMeshData[0][vidSrc + 2];
-        apos[vid + 3] = fullMeshData[0][vidSrc + 3];
-
-        anorm[vid + 0] = fullMeshData[1][vidSrc + 0];
-        anorm[vid + 1] = fullMeshData[1][vidSrc + 1];
-        anorm[vid + 2] = fullMeshData[1][vidSrc + 2];
-        anorm[vid + 3] = fullMeshData[1][vidSrc + 3];
-
-        assert((ind * 2) < apos.size());
-        assert((v.xref * 2) < fullMeshData[2].size());
-        auv[ind * 2 + 0] = fullMeshData[2][v.xref * 2 + 0];
-        auv[ind * 2 + 1] = fullMeshData[2][v.xref * 2 + 1];
-
-        atan[vid + 0] = fullMeshData[3][vidSrc + 0];
-        atan[vid + 1] = fullMeshData[3][vidSrc + 1];
-        atan[vid + 2] = fullMeshData[3][vidSrc + 2];
-        atan[vid + 3] = fullMeshData[3][vidSrc + 3];
-
-        fullMeshData[4][ind * 2 + 0] = v.uv[0] / float(aw);
-        fullMeshData[4][ind * 2 + 1] = v.uv[1] / float(ah);
+      float aw = static_cast<float>(atlas->width);
+      float ah = static_cast<float>(atlas->height);
+
+      const xatlas::Mesh &atlasMesh = atlas->meshes[0];
+
+      // the atlas splits vertices on seams, the blob is rebuilt with the new
+      // vertex count, each vertex gathered from the one it comes from
+      MemoryRange sourceRanges[MESH_ATTRIBUTE_TYPE_COUNT];
+      memcpy(sourceRanges, outMesh.ranges, sizeof(sourceRanges));
+      std::vector<float> remapped(
+              computeVertexBlobLayout(atlasMesh.vertexCount, attributesCount, outMesh.ranges));
+      const char *source = reinterpret_cast<const char *>(blob);
+      char *destination = reinterpret_cast<char *>(remapped.data());
+      float *lightMapUVs =
+              remapped.data() + outMesh.ranges[MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP].m_offset / 4;
+      for (uint32_t v = 0; v < atlasMesh.vertexCount; ++v) {
+        const xatlas::Vertex &vertex = atlasMesh.vertexArray[v];
+        assert(vertex.xref < vertexCount);
+        for (int attrIdx = 0; attrIdx < FILE_ATTRIBUTES_COUNT; ++attrIdx) {
+          const uint32_t size = MESH_ATTRIBUTE_SIZE_IN_BYTES[attrIdx];
+          memcpy(destination + outMesh.ranges[attrIdx].m_offset + v * size,
+                 source + sourceRanges[attrIdx].m_offset + vertex.xref * size, size);
+        }
+        lightMapUVs[v * 2 + 0] = vertex.uv[0] / aw;
+        lightMapUVs[v * 2 + 1] = vertex.uv[1] / ah;
       }
-      fullMeshData[MESH_ATTRIBUTE_TYPE_POSITION] = apos;
-      fullMeshData[MESH_ATTRIBUTE_TYPE_NORMAL] = anorm;
-      fullMeshData[MESH_ATTRIBUTE_TYPE_UV] = auv;
-      fullMeshData[MESH_ATTRIBUTE_TYPE_TANGENT] = atan;
-
-      //setting the stride for the uvs
-      strides[MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP] = static_cast<float>(
-              MESH_ATTRIBUTE_SIZE_IN_BYTES[MESH_ATTRIBUTE_TYPE_UV_LIGHTMAP] / 4u);
+      outMesh.indices.assign(atlasMesh.indexArray, atlasMesh.indexArray + atlasMesh.indexCount);
+      outMesh.vertices.swap(remapped);
+      uniqueVerticesCount = atlasMesh.vertexCount;
+      xatlas::Destroy(atlas);
 
       auto t2 = std::chrono::high_resolution_clock::now();
       auto secs = std::chrono::duration_cast<std::chrono::seconds>(t2 - t1);
@@ -321,21 +288,11 @@ bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* opt
     }
   }
 
-
   std::vector<uint32_t> inIndices = outMesh.indices;
   SirMetal::optimizeVertexCache(outMesh.indices, inIndices, outMesh.indices.size(),
-                                fullMeshData[0].size());
-
-  // merge the buffer into a single one
-  int attributesCount = 4;
-  //if we have the uv maps we have an extra attributes. this is good enough until we have skinning, then it will be trickier
-  attributesCount += generateLightUVs ? 1 : 0;
-  SirMetal::mergeRawMeshBuffers(fullMeshData, strides, attributesCount, outMesh.vertices,
-                                outMesh.ranges);
-
-  outMesh.name = mesh->name;
+                                uniqueVerticesCount);
 
   return true;
 }
 
-}// namespace SirMetal
\ No newline at end of file
+}// namespace SirMetal
@@ -4,4 +4,7 @@
 
 namespace SirMetal {
 bool loadGltfMesh(MeshLoadResult &outMesh, const void *gltfMesh, const void* options);
+// key of the mesh in the .smesh cache, a hash of the bytes of the accessors
+// loadGltfMesh reads and of the options changing its result, see meshCache.h
+uint64_t computeGltfMeshCacheKey(const void *gltfMesh, const void *options);
 }
\ No newline at end of file
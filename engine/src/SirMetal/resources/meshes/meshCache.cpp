@@ -0,0 +1,103 @@
+#include "SirMetal/resources/meshes/meshCache.h"
+#include "SirMetal/resources/meshes/vertexStreams.h"
+
+#include <atomic>
+#include <filesystem>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace SirMetal {
+
+namespace {
+uint64_t alignUp(const uint64_t value, const uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+std::string getMeshCachePath(const std::string &folder, const uint64_t key) {
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64, key);
+  return folder + "/" + name + MESH_CACHE_EXTENSION;
+}
+
+bool writeMeshCache(const char *path, const uint64_t key, const MeshLoadResult &mesh) {
+  MeshCacheHeader header{};
+  header.magic = MESH_CACHE_MAGIC;
+  header.version = MESH_CACHE_VERSION;
+  header.key = key;
+  header.nameLength = static_cast<uint32_t>(mesh.name.size());
+  header.vertexOffset =
+          alignUp(sizeof(MeshCacheHeader) + header.nameLength, VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES);
+  header.vertexSizeInBytes = mesh.vertices.size() * sizeof(float);
+  header.indexOffset = header.vertexOffset + header.vertexSizeInBytes;
+  header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  memcpy(header.ranges, mesh.ranges, sizeof(header.ranges));
+  memcpy(header.boundingBox, mesh.m_boundingBox, sizeof(header.boundingBox));
+
+  std::error_code error;
+  const std::filesystem::path folder = std::filesystem::path(path).parent_path();
+  if (!folder.empty()) { std::filesystem::create_directories(folder, error); }
+
+  // unique per process and per call, two cooks of the same mesh don't write
+  // in the same temporary file
+  static std::atomic<uint32_t> s_writeCount{0};
+  const std::string temporaryPath = std::string(path) + ".tmp" + std::to_string(getpid()) + "_" +
+                                    std::to_string(s_writeCount.fetch_add(1));
+  FILE *file = fopen(temporaryPath.c_str(), "wb");
+  if (file == nullptr) {
+    printf("[ERROR] Could not write mesh cache file %s\n", temporaryPath.c_str());
+    return false;
+  }
+  static const char PADDING[VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES] = {};
+  const uint64_t paddingSize = header.vertexOffset - sizeof(MeshCacheHeader) - header.nameLength;
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+  written &= fwrite(mesh.name.data(), 1, header.nameLength, file) == header.nameLength;
+  written &= fwrite(PADDING, 1, paddingSize, file) == paddingSize;
+  written &= fwrite(mesh.vertices.data(), 1, header.vertexSizeInBytes, file) ==
+             header.vertexSizeInBytes;
+  written &= fwrite(mesh.indices.data(), sizeof(uint32_t), header.indexCount, file) ==
+             header.indexCount;
+  written &= fclose(file) == 0;
+  if (written) { std::filesystem::rename(temporaryPath, path, error); }
+  if (!written || error) {
+    printf("[ERROR] Could not write mesh cache file %s\n", path);
+    std::filesystem::remove(temporaryPath, error);
+    return false;
+  }
+  return true;
+}
+
+bool CachedMesh::open(const char *path, const uint64_t key) {
+  close();
+  if (!m_file.open(path)) { return false; }
+  // everything is checked against the file size, a truncated or foreign file
+  // is never read past its end
+  const uint64_t size = m_file.getSize();
+  const auto *header = reinterpret_cast<const MeshCacheHeader *>(m_file.getData());
+  bool valid = size >= sizeof(MeshCacheHeader);
+  valid = valid && (header->magic == MESH_CACHE_MAGIC) && (header->version == MESH_CACHE_VERSION) &&
+          (header->key == key);
+  valid = valid && (header->vertexOffset <= size) && (header->vertexSizeInBytes <= size) &&
+          (header->vertexOffset >= sizeof(MeshCacheHeader) + header->nameLength) &&
+          (header->vertexOffset % VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES == 0) &&
+          (header->indexOffset == header->vertexOffset + header->vertexSizeInBytes) &&
+          (header->indexOffset + static_cast<uint64_t>(header->indexCount) * sizeof(uint32_t) ==
+           size);
+  for (uint32_t i = 0; valid && (i < MESH_ATTRIBUTE_TYPE_COUNT); ++i) {
+    valid = static_cast<uint64_t>(header->ranges[i].m_offset) + header->ranges[i].m_size <=
+            header->vertexSizeInBytes;
+  }
+  if (!valid) {
+    // stale or corrupted, not an error, the mesh is cooked and the file
+    // written again
+    printf("[WARN] Ignoring mesh cache file %s, stale or malformed\n", path);
+    m_file.close();
+    return false;
+  }
+  m_header = header;
+  return true;
+}
+
+} // namespace SirMetal
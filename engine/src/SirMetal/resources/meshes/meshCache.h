@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+
+#include "SirMetal/core/core.h"
+#include "SirMetal/io/mappedFile.h"
+#include "SirMetal/resources/resourceTypes.h"
+
+namespace SirMetal {
+
+// .smesh files, a mesh exactly as it is uploaded, the vertex blob, the
+// indices, the ranges and the bounding box. Cooking a mesh, the vertex cache
+// optimization and even more the light map charting, costs up to seconds, a
+// cached mesh is a mmap away. Files are named after a key, the hash of the
+// source data and of the load options that change the result, see
+// computeGltfMeshCacheKey, a source edit gives a new key and a new file.
+static constexpr uint32_t MESH_CACHE_MAGIC = 0x48534D53; // "SMSH"
+// bump it on any change of the layout or of the cooking, old files are then
+// ignored and cooked again
+static constexpr uint32_t MESH_CACHE_VERSION = 1;
+static constexpr const char *MESH_CACHE_EXTENSION = ".smesh";
+
+struct MeshCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  // offsets from the start of the file, the vertex blob is aligned as its
+  // ranges are, the mapping is page aligned
+  uint64_t vertexOffset;
+  uint64_t vertexSizeInBytes;
+  uint64_t indexOffset;
+  uint32_t indexCount;
+  // the name follows the header, not null terminated
+  uint32_t nameLength;
+  MemoryRange ranges[MESH_ATTRIBUTE_TYPE_COUNT];
+  float boundingBox[6];
+};
+
+// <folder>/<key in hex>.smesh
+std::string getMeshCachePath(const std::string &folder, uint64_t key);
+
+// writes through a temporary file renamed in place, a reader never sees a
+// partial file and concurrent writers of the same key are harmless. Creates
+// the folder if needed, false on any io error
+bool writeMeshCache(const char *path, uint64_t key, const MeshLoadResult &mesh);
+
+// A cached mesh, mapped. The getters point in the mapping, they can be handed
+// to the GPU upload as they are, no copy on the CPU side.
+// not thread safe
+class CachedMesh final {
+public:
+  CachedMesh() = default;
+  CachedMesh(CachedMesh &&other) noexcept
+      : m_file(std::move(other.m_file)), m_header(other.m_header) {
+    other.m_header = nullptr;
+  }
+  CachedMesh &operator=(CachedMesh &&other) noexcept {
+    m_file = std::move(other.m_file);
+    m_header = other.m_header;
+    other.m_header = nullptr;
+    return *this;
+  }
+
+  // false if the file is missing, was written for another key or version, or
+  // is malformed, the mesh has to be cooked then
+  bool open(const char *path, uint64_t key);
+  void close() {
+    m_file.close();
+    m_header = nullptr;
+  }
+
+  [[nodiscard]] bool isOpen() const { return m_header != nullptr; }
+  [[nodiscard]] const float *getVertices() const {
+    return reinterpret_cast<const float *>(m_file.getData() + m_header->vertexOffset);
+  }
+  [[nodiscard]] uint64_t getVertexSizeInBytes() const { return m_header->vertexSizeInBytes; }
+  [[nodiscard]] const uint32_t *getIndices() const {
+    return reinterpret_cast<const uint32_t *>(m_file.getData() + m_header->indexOffset);
+  }
+  [[nodiscard]] uint32_t getIndexCount() const { return m_header->indexCount; }
+  [[nodiscard]] const MemoryRange *getRanges() const { return m_header->ranges; }
+  [[nodiscard]] const float *getBoundingBox() const { return m_header->boundingBox; }
+  [[nodiscard]] std::string getName() const {
+    return {m_file.getData() + sizeof(MeshCacheHeader), m_header->nameLength};
+  }
+
+  // deleted copy constructor and assignment operator
+  CachedMesh(const CachedMesh &) = delete;
+  CachedMesh &operator=(const CachedMesh &) = delete;
+
+private:
+  MappedFile m_file;
+  const MeshCacheHeader *m_header = nullptr;
+};
+
+} // namespace SirMetal
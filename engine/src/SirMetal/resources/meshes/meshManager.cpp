@@ -1,6 +1,7 @@
 
 #include "SirMetal/resources/meshes/meshManager.h"
 #import "SirMetal/resources/meshes/gltfMesh.h"
+#import "SirMetal/resources/meshes/meshCache.h"
 #import "SirMetal/resources/meshes/meshOptimize.h"
 #import "SirMetal/resources/meshes/wavefrontobj.h"
 #include <SirMetal/io/file.h>
@@ -41,7 +42,6 @@ MeshHandle MeshManager::processObjMesh(const std::string &path) {
           BUFFER_FLAG_GPU_ONLY, result.indices.data());
   id indexBuffer = m_allocator.getBuffer(ihandle);
 
-  uint32_t index = m_meshCounter++;
   MeshData data{vertexBuffer,
                 indexBuffer,
                 std::move(meshName),
@@ -50,10 +50,9 @@ MeshHandle MeshManager::processObjMesh(const std::string &path) {
                 vhandle,
                 ihandle};
 
-  m_handleToMesh[index] = data;
+  auto handle = m_meshes.insert(std::move(data));
   const std::string fileName = getFileName(path);
-  auto handle = getHandle<MeshHandle>(index);
-  m_nameToHandle[fileName] = handle.handle;
+  m_idToHandle.insert(registerStringId(fileName.c_str()), handle.handle);
   return handle;
 }
 
@@ -73,34 +72,50 @@ MeshHandle MeshManager::loadFromMemory(const void *data, LOAD_MESH_TYPE type,
       loadGltfMesh(result, data, options);
     }
   }
+  return loadFromLoadResult(result);
+}
+
+MeshHandle MeshManager::loadFromLoadResult(MeshLoadResult &result) {
+  return createMesh(result.name, result.vertices.data(), result.vertices.size() * sizeof(float),
+                    result.indices.data(), static_cast<uint32_t>(result.indices.size()),
+                    result.ranges, result.m_boundingBox);
+}
 
+MeshHandle MeshManager::loadFromCachedMesh(const CachedMesh &mesh) {
+  return createMesh(mesh.getName(), mesh.getVertices(), mesh.getVertexSizeInBytes(),
+                    mesh.getIndices(), mesh.getIndexCount(), mesh.getRanges(),
+                    mesh.getBoundingBox());
+}
 
+MeshHandle MeshManager::createMesh(const std::string &name, const void *vertices,
+                                   const uint64_t vertexSizeInBytes, const uint32_t *indices,
+                                   const uint32_t indexCount, const MemoryRange *ranges,
+                                   const float *boundingBox) {
+  // the allocator only reads the data, it copies it in the new buffer
   BufferHandle vhandle = m_allocator.allocate(
-          sizeof(float) * result.vertices.size(), (result.name + "Vertices").c_str(),
-          BUFFER_FLAG_GPU_ONLY, result.vertices.data());
+          static_cast<uint32_t>(vertexSizeInBytes), (name + "Vertices").c_str(),
+          BUFFER_FLAG_GPU_ONLY, const_cast<void *>(vertices));
   id vertexBuffer = m_allocator.getBuffer(vhandle);
 
   BufferHandle ihandle = m_allocator.allocate(
-          result.indices.size() * sizeof(uint32_t), (result.name + "Indices").c_str(),
-          BUFFER_FLAG_GPU_ONLY, result.indices.data());
+          indexCount * sizeof(uint32_t), (name + "Indices").c_str(),
+          BUFFER_FLAG_GPU_ONLY, const_cast<uint32_t *>(indices));
   id indexBuffer = m_allocator.getBuffer(ihandle);
 
   MeshData outMesh{};
-  outMesh.name = result.name;
+  outMesh.name = name;
   outMesh.indexBuffer = indexBuffer;
   outMesh.vertexBuffer = vertexBuffer;
   outMesh.m_indexHandle = ihandle;
   outMesh.m_vertexHandle = vhandle;
-  outMesh.primitivesCount = result.indices.size();
+  outMesh.primitivesCount = indexCount;
   for (int r = 0; r < MESH_ATTRIBUTE_TYPE_COUNT; ++r) {
-    outMesh.ranges[r] = result.ranges[r];
+    outMesh.ranges[r] = ranges[r];
   }
+  memcpy(outMesh.m_boundingBox, boundingBox, sizeof(outMesh.m_boundingBox));
 
-  uint32_t index = m_meshCounter++;
-  m_handleToMesh[index] = outMesh;
   // NOTE we are not adding the handle to the look up by name because this comes
   // from a gltf file, meaning multiple meshes in a file
-  auto handle = getHandle<MeshHandle>(index);
-  return handle;
+  return m_meshes.insert(std::move(outMesh));
 }
 }// namespace SirMetal
@@ -3,10 +3,12 @@
 #include "SirMetal/resources/handle.h"
 #import <objc/objc.h>
 #import <string>
-#import <unordered_map>
 
 #import "SirMetal/core/core.h"
 #include "SirMetal/core/mathUtils.h"
+#include "SirMetal/core/hashing/stringId.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/slotMap.h"
 #include "SirMetal/core/memory/gpu/GPUMemoryAllocator.h"
 #include "SirMetal/resources/resourceTypes.h"
 
@@ -15,6 +17,7 @@
 struct cgltf_mesh;
 
 namespace SirMetal {
+class CachedMesh;
 
 
 // TODO: temp public, we will need to build abstraction to render
@@ -35,6 +38,10 @@ class MeshManager {
   public:
   MeshHandle loadMesh(const std::string &path);
   MeshHandle loadFromMemory(const void *data, LOAD_MESH_TYPE type, const void *options);
+  // uploads a mesh already cooked on the CPU, used by the async loads
+  MeshHandle loadFromLoadResult(MeshLoadResult &result);
+  // uploads a mesh mapped from the .smesh cache, straight from the mapping
+  MeshHandle loadFromCachedMesh(const CachedMesh &mesh);
 
   void initialize(id device, id queue) {
     m_allocator.initialize(device, queue);
@@ -42,17 +49,17 @@ class MeshManager {
     m_queue = queue;
   };
   const MeshHandle getHandleFromName(const std::string &name) const {
-    auto found = m_nameToHandle.find(name);
-    if (found != m_nameToHandle.end()) { return {found->second}; }
+    return getHandleFromId(StringId(name.c_str(), name.size()));
+  }
+  const MeshHandle getHandleFromId(const StringId id) const {
+    uint32_t found = 0;
+    if (m_idToHandle.get(id, found)) { return {found}; }
     return {};
   }
 
   const MeshData *getMeshData(MeshHandle handle) const {
     assert(getTypeFromHandle(handle) == HANDLE_TYPE::MESH);
-    uint32_t index = getIndexFromHandle(handle);
-    auto found = m_handleToMesh.find(index);
-    if (found != m_handleToMesh.end()) { return &found->second; }
-    return nullptr;
+    return m_meshes.get(handle);
   }
 
   void cleanup();
@@ -60,12 +67,14 @@ class MeshManager {
   private:
   id m_device;
   id m_queue;
-  std::unordered_map<uint32_t, MeshData> m_handleToMesh;
-  std::unordered_map<std::string, uint32_t> m_nameToHandle;
+  SlotMap<MeshData, MeshHandle> m_meshes;
+  HashMap<StringId, uint32_t, hashStringId> m_idToHandle{64};
 
   SirMetal::MeshHandle processObjMesh(const std::string &path);
+  MeshHandle createMesh(const std::string &name, const void *vertices, uint64_t vertexSizeInBytes,
+                        const uint32_t *indices, uint32_t indexCount, const MemoryRange *ranges,
+                        const float *boundingBox);
 
-  uint32_t m_meshCounter = 1;
   GPUMemoryAllocator m_allocator;
 };
 
@@ -12,10 +12,9 @@ struct MapperData
   const std::vector<float>* nIn;
   const std::vector<float>* uvIn;
   const std::vector<float>* tIn;
-  std::vector<float>* pOut;
-  std::vector<float>* nOut;
-  std::vector<float>* uvOut;
-  std::vector<float>* tOut;
+  // the remapped vertices are written straight in the final vertex blob
+  std::vector<float>* outVertices;
+  MemoryRange* outRanges;
   std::vector<uint32_t>* outIndex;
   uint32_t indexCount;
 };
@@ -24,10 +23,4 @@ void optimizeRawDeinterleavedMesh( const MapperData& data);
 void optimizeVertexCache(std::vector<uint32_t> &outIndices, const std::vector<uint32_t> &inIndices,
                          uint32_t indexCount, uint32_t vertexCount);
 
-void mergeRawMeshBuffers(
-        const std::vector<float> *attributes, float *strides,
-        uint32_t count, std::vector<float> &outData,
-        MemoryRange *ranges);
-
-
 }
\ No newline at end of file
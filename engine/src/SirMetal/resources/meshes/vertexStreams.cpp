@@ -0,0 +1,179 @@
+#include "SirMetal/resources/meshes/vertexStreams.h"
+
+#include <assert.h>
+#include <float.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SM_VERTEX_STREAMS_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SM_VERTEX_STREAMS_NEON 1
+#endif
+
+namespace SirMetal {
+
+uint64_t computeVertexBlobLayout(const uint32_t vertexCount, const uint32_t attributeCount,
+                                 MemoryRange *outRanges) {
+  assert(attributeCount > 0 && attributeCount <= MESH_ATTRIBUTE_TYPE_COUNT);
+  uint64_t offset = 0;
+  for (uint32_t i = 0; i < attributeCount; ++i) {
+    const uint64_t size = static_cast<uint64_t>(vertexCount) * MESH_ATTRIBUTE_SIZE_IN_BYTES[i];
+    outRanges[i].m_offset = static_cast<uint32_t>(offset);
+    outRanges[i].m_size = static_cast<uint32_t>(size);
+    offset += size;
+    // the last range is not padded, nothing comes after it
+    if (i + 1 < attributeCount) {
+      offset = (offset + VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES - 1) &
+               ~static_cast<uint64_t>(VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES - 1);
+    }
+  }
+  return offset / sizeof(float);
+}
+
+void extractFloat3ToFloat4(const void *source, const uint32_t strideInBytes, const uint32_t count,
+                           const float filler, float *out, float *outBoundingBox) {
+  assert(strideInBytes >= 3 * sizeof(float));
+  const auto *src = static_cast<const char *>(source);
+  if (count == 0) {
+    if (outBoundingBox != nullptr) { memset(outBoundingBox, 0, sizeof(float) * 6); }
+    return;
+  }
+  // a 16 bytes load of an element reads into the next one, the last element
+  // might end the buffer, it goes through a copy on the stack
+  float last[4];
+  memcpy(last, src + static_cast<uint64_t>(count - 1) * strideInBytes, sizeof(float) * 3);
+  last[3] = filler;
+
+#if SM_VERTEX_STREAMS_SSE2
+  const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  const __m128 w = _mm_set_ps(filler, 0.0f, 0.0f, 0.0f);
+  __m128 minV = _mm_set1_ps(FLT_MAX);
+  __m128 maxV = _mm_set1_ps(-FLT_MAX);
+  for (uint32_t i = 0; i < count - 1; ++i) {
+    const __m128 v = _mm_or_ps(
+            _mm_and_ps(_mm_loadu_ps(reinterpret_cast<const float *>(src)), xyzMask), w);
+    _mm_storeu_ps(out + i * 4, v);
+    minV = _mm_min_ps(minV, v);
+    maxV = _mm_max_ps(maxV, v);
+    src += strideInBytes;
+  }
+  const __m128 v = _mm_loadu_ps(last);
+  _mm_storeu_ps(out + (count - 1) * 4, v);
+  if (outBoundingBox != nullptr) {
+    float minOut[4];
+    float maxOut[4];
+    _mm_storeu_ps(minOut, _mm_min_ps(minV, v));
+    _mm_storeu_ps(maxOut, _mm_max_ps(maxV, v));
+    memcpy(outBoundingBox, minOut, sizeof(float) * 3);
+    memcpy(outBoundingBox + 3, maxOut, sizeof(float) * 3);
+  }
+#elif SM_VERTEX_STREAMS_NEON
+  float32x4_t minV = vdupq_n_f32(FLT_MAX);
+  float32x4_t maxV = vdupq_n_f32(-FLT_MAX);
+  for (uint32_t i = 0; i < count - 1; ++i) {
+    const float32x4_t v = vsetq_lane_f32(filler, vld1q_f32(reinterpret_cast<const float *>(src)), 3);
+    vst1q_f32(out + i * 4, v);
+    minV = vminq_f32(minV, v);
+    maxV = vmaxq_f32(maxV, v);
+    src += strideInBytes;
+  }
+  const float32x4_t v = vld1q_f32(last);
+  vst1q_f32(out + (count - 1) * 4, v);
+  if (outBoundingBox != nullptr) {
+    float minOut[4];
+    float maxOut[4];
+    vst1q_f32(minOut, vminq_f32(minV, v));
+    vst1q_f32(maxOut, vmaxq_f32(maxV, v));
+    memcpy(outBoundingBox, minOut, sizeof(float) * 3);
+    memcpy(outBoundingBox + 3, maxOut, sizeof(float) * 3);
+  }
+#else
+  float box[6] = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (uint32_t i = 0; i < count; ++i) {
+    float *dst = out + i * 4;
+    if (i + 1 < count) {
+      memcpy(dst, src, sizeof(float) * 3);
+      dst[3] = filler;
+    } else {
+      memcpy(dst, last, sizeof(float) * 4);
+    }
+    for (int c = 0; c < 3; ++c) {
+      box[c] = dst[c] < box[c] ? dst[c] : box[c];
+      box[c + 3] = dst[c] > box[c + 3] ? dst[c] : box[c + 3];
+    }
+    src += strideInBytes;
+  }
+  if (outBoundingBox != nullptr) { memcpy(outBoundingBox, box, sizeof(box)); }
+#endif
+}
+
+void extractFloat2(const void *source, const uint32_t strideInBytes, const uint32_t count,
+                   float *out) {
+  assert(strideInBytes >= 2 * sizeof(float));
+  const auto *src = static_cast<const char *>(source);
+  if (strideInBytes == 2 * sizeof(float)) {
+    memcpy(out, src, sizeof(float) * 2 * count);
+    return;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    memcpy(out + i * 2, src, sizeof(float) * 2);
+    src += strideInBytes;
+  }
+}
+
+template <typename T>
+static void widenIndices(const char *src, const uint32_t strideInBytes, const uint32_t count,
+                         uint32_t *out) {
+  for (uint32_t i = 0; i < count; ++i) {
+    T index;
+    memcpy(&index, src, sizeof(T));
+    out[i] = index;
+    src += strideInBytes;
+  }
+}
+
+bool extractIndices(const void *source, const uint32_t componentSizeInBytes,
+                    const uint32_t strideInBytes, const uint32_t count, uint32_t *out) {
+  const auto *src = static_cast<const char *>(source);
+  switch (componentSizeInBytes) {
+    case 1:
+      widenIndices<uint8_t>(src, strideInBytes, count, out);
+      return true;
+    case 2: {
+      uint32_t i = 0;
+      if (strideInBytes == sizeof(uint16_t)) {
+        // packed, 8 indices per load widened against zero
+#if SM_VERTEX_STREAMS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8) {
+          const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi16(v, zero));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4), _mm_unpackhi_epi16(v, zero));
+        }
+#elif SM_VERTEX_STREAMS_NEON
+        for (; i + 8 <= count; i += 8) {
+          const uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t *>(src + i * 2));
+          vst1q_u32(out + i, vmovl_u16(vget_low_u16(v)));
+          vst1q_u32(out + i + 4, vmovl_high_u16(v));
+        }
+#endif
+      }
+      widenIndices<uint16_t>(src + static_cast<uint64_t>(i) * strideInBytes, strideInBytes,
+                             count - i, out + i);
+      return true;
+    }
+    case 4:
+      if (strideInBytes == sizeof(uint32_t)) {
+        memcpy(out, src, sizeof(uint32_t) * count);
+      } else {
+        widenIndices<uint32_t>(src, strideInBytes, count, out);
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+}// namespace SirMetal
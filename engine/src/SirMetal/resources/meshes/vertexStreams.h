@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "SirMetal/core/core.h"
+#include "SirMetal/resources/resourceTypes.h"
+
+namespace SirMetal {
+
+// every attribute range of a vertex blob starts on this boundary, such that
+// the same buffer can be bound at each range offset
+static constexpr uint32_t VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES = 256;
+
+// Layout of the de-interleaved vertex blob the engine uploads, the first
+// attributeCount attributes, one after the other, each sized with
+// MESH_ATTRIBUTE_SIZE_IN_BYTES and starting on an aligned offset.
+// Fills the ranges and returns the size of the blob in floats.
+uint64_t computeVertexBlobLayout(uint32_t vertexCount, uint32_t attributeCount,
+                                 MemoryRange *outRanges);
+
+// The extractors read count elements, strideInBytes apart, straight from the
+// source buffer (a gltf buffer view, possibly interleaved) and write them
+// packed in the blob, this is the only copy the data goes through.
+
+// xyz of a float3 or wider element to a float4, w set to filler. If
+// outBoundingBox is not null it gets min xyz and max xyz of the elements,
+// computed in the same pass
+void extractFloat3ToFloat4(const void *source, uint32_t strideInBytes, uint32_t count,
+                           float filler, float *out, float *outBoundingBox = nullptr);
+void extractFloat2(const void *source, uint32_t strideInBytes, uint32_t count, float *out);
+// 1, 2 or 4 bytes indices widened to 32 bits, false on any other size
+bool extractIndices(const void *source, uint32_t componentSizeInBytes, uint32_t strideInBytes,
+                    uint32_t count, uint32_t *out);
+
+}// namespace SirMetal
@@ -1,5 +1,6 @@
 
 #include "SirMetal/resources/meshes/wavefrontobj.h"
+#include "SirMetal/core/jobs/jobSystem.h"
 #include "SirMetal/resources/meshes/meshOptimize.h"
 #include "SirMetal/resources/meshes/objparser.h"
 
@@ -31,61 +32,59 @@ bool loadMeshObj(MeshLoadResult &result, const char *path) {
     normals[i] = 0.0f;
   }
 
-  // let us extract the data from the obj, for later manipulation
-  //#pragma omp parallel for
-  for (size_t i = 0; i < index_count; ++i) {
+  // let us extract the data from the obj, for later manipulation, every
+  // corner writes its own slots, chunks can go wide on the job system
+  auto extractCorners = [&](const uint32_t begin, const uint32_t end) {
+    for (size_t i = begin; i < end; ++i) {
 
-    int vi = file.f[i * 3 + 0];
-    int vti = file.f[i * 3 + 1];
-    int vni = file.f[i * 3 + 2];
+      int vi = file.f[i * 3 + 0];
+      int vti = file.f[i * 3 + 1];
+      int vni = file.f[i * 3 + 2];
 
-    assert((i * 4 + 3) < (index_count * 4));
-    positions[i * 4 + 0] = file.v[vi * 3 + 0];
-    positions[i * 4 + 1] = file.v[vi * 3 + 1];
-    positions[i * 4 + 2] = file.v[vi * 3 + 2];
-    positions[i * 4 + 3] = 1.0f;
-
-    if ((vni >= 0) & (file.vn != nullptr)) {
       assert((i * 4 + 3) < (index_count * 4));
-      normals[i * 4 + 0] = file.vn[vni * 3 + 0];
-      normals[i * 4 + 1] = file.vn[vni * 3 + 1];
-      normals[i * 4 + 2] = file.vn[vni * 3 + 2];
-      normals[i * 4 + 3] = 0.0f;
-    }
-
-    if ((vti >= 0) & (file.vt != nullptr)) {
-      assert((i * 2 + 1) < (index_count * 2));
-      uvs[i * 2 + 0] = file.vt[vti * 3 + 0];
-      uvs[i * 2 + 1] = file.vt[vti * 3 + 1];
+      positions[i * 4 + 0] = file.v[vi * 3 + 0];
+      positions[i * 4 + 1] = file.v[vi * 3 + 1];
+      positions[i * 4 + 2] = file.v[vi * 3 + 2];
+      positions[i * 4 + 3] = 1.0f;
+
+      if ((vni >= 0) & (file.vn != nullptr)) {
+        assert((i * 4 + 3) < (index_count * 4));
+        normals[i * 4 + 0] = file.vn[vni * 3 + 0];
+        normals[i * 4 + 1] = file.vn[vni * 3 + 1];
+        normals[i * 4 + 2] = file.vn[vni * 3 + 2];
+        normals[i * 4 + 3] = 0.0f;
+      }
+
+      if ((vti >= 0) & (file.vt != nullptr)) {
+        assert((i * 2 + 1) < (index_count * 2));
+        uvs[i * 2 + 0] = file.vt[vti * 3 + 0];
+        uvs[i * 2 + 1] = file.vt[vti * 3 + 1];
+      }
     }
+  };
+  // obj corners are cheap, big chunks keep the split overhead out of the way
+  static constexpr uint32_t CORNERS_PER_CHUNK = 16 * 1024;
+  if (globals::JOB_SYSTEM != nullptr) {
+    globals::JOB_SYSTEM->parallelFor(static_cast<uint32_t>(index_count), CORNERS_PER_CHUNK,
+                                     extractCorners);
+  } else {
+    extractCorners(0, static_cast<uint32_t>(index_count));
   }
 
-  std::vector<float> posOut;
-  std::vector<float> nOut;
-  std::vector<float> uvOut;
-  std::vector<float> tOut;
   result.indices.resize(index_count);
   SirMetal::MapperData mapper{&positions,
                               &normals,
                               &uvs,
                               &tangents,
-                              &posOut,
-                              &nOut,
-                              &uvOut,
-                              &tOut,
+                              &result.vertices,
+                              result.ranges,
                               &result.indices,
                               static_cast<uint32_t>(index_count)};
 
   // generate an index buffer and optimize per vertex cache hit using mesh
-  // optimizer
+  // optimizer, the unique vertices land directly in the vertex blob
   SirMetal::optimizeRawDeinterleavedMesh(mapper);
 
-  // merge the buffer into a single one
-
-  std::vector<float> attributes[4] = {posOut, nOut, uvOut, tOut};
-  float strides[4]{4, 4, 2, 4};
-  SirMetal::mergeRawMeshBuffers(attributes, strides, 4, result.vertices, result.ranges);
-
   return true;
 }
 
@@ -6,7 +6,7 @@
 
 #include "SirMetal/core/core.h"
 #include "SirMetal/resources/handle.h"
-#include <simd/vector.h>
+#include "SirMetal/core/platform/simd.h"
 
 namespace SirMetal {
 
@@ -24,7 +24,7 @@ enum MESH_ATTRIBUTE_TYPE {
 
 
 // list of mesh attributes we want to extract from the gtlf file
-static char const *MESH_ATTRIBUTES[MESH_ATTRIBUTE_TYPE_COUNT] = {
+static constexpr const char *MESH_ATTRIBUTES[MESH_ATTRIBUTE_TYPE_COUNT] = {
         "POSITION", "NORMAL", "TEXCOORD_0", "TANGENT", "LIGHT_MAP_UPV"};
 
 static constexpr uint32_t MESH_ATTRIBUTE_SIZE_IN_BYTES[MESH_ATTRIBUTE_TYPE_COUNT] = {
@@ -38,8 +38,8 @@ static constexpr float MESH_ATTRIBUTES_COMPONENT_FILLER[MESH_ATTRIBUTE_TYPE_COUN
 struct MeshLoadResult {
   std::vector<float> vertices;
   std::vector<uint32_t> indices;
-  MemoryRange ranges[4];
-  float m_boundingBox[6];
+  MemoryRange ranges[MESH_ATTRIBUTE_TYPE_COUNT]{};
+  float m_boundingBox[6]{};
   std::string name;
 };
 
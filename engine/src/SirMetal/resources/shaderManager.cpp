@@ -7,9 +7,10 @@ LibraryHandle ShaderManager::loadShader(const char *path) {
 
   // checking if is already loaded
   const std::string fileName = getFileName(path);
-  auto found = m_nameToLibraryHandle.find(fileName);
-  if (found != m_nameToLibraryHandle.end()) {
-    return LibraryHandle{found->second};
+  const StringId id = registerStringId(fileName.c_str());
+  uint32_t found = 0;
+  if (m_idToLibraryHandle.get(id, found)) {
+    return LibraryHandle{found};
   }
 
   assert(fileExists(path));
@@ -40,24 +41,27 @@ LibraryHandle ShaderManager::loadShader(const char *path) {
     return {};
   }
 
-  uint32_t index = m_libraryCounter++;
-
   // updating the look ups
-  m_libraries[index] = metadata;
-  m_nameToLibraryHandle[fileName] = index;
+  LibraryHandle handle = m_libraries.insert(metadata);
+  m_idToLibraryHandle.insert(id, handle.handle);
 
-  return getHandle<LibraryHandle>(index);
+  return handle;
 }
 
 id ShaderManager::getLibraryFromHandle(LibraryHandle handle) {
-  uint32_t index = getIndexFromHandle(handle);
-  return m_libraries[index].library;
+  const ShaderMetadata *metadata = m_libraries.get(handle);
+  assert(metadata != nullptr);
+  return metadata->library;
 }
 
 LibraryHandle ShaderManager::getHandleFromName(const std::string &name) const {
-  auto found = m_nameToLibraryHandle.find(name);
-  if (found != m_nameToLibraryHandle.end()) {
-    return getHandle<LibraryHandle>(found->second);
+  return getHandleFromId(StringId(name.c_str(), name.size()));
+}
+
+LibraryHandle ShaderManager::getHandleFromId(const StringId id) const {
+  uint32_t found = 0;
+  if (m_idToLibraryHandle.get(id, found)) {
+    return LibraryHandle{found};
   }
   return {};
 }
@@ -167,23 +171,23 @@ for (MTLArgument *arg in reflectionObj.vertexArguments)
 */
 
 id ShaderManager::getVertexFunction(LibraryHandle handle) {
-  uint32_t index = getIndexFromHandle(handle);
-  assert(m_libraries.find(index) != m_libraries.end());
-  return m_libraries[index].vertexFn;
+  const ShaderMetadata *metadata = m_libraries.get(handle);
+  assert(metadata != nullptr);
+  return metadata->vertexFn;
 }
 id ShaderManager::getFragmentFunction(LibraryHandle handle) {
   assert(handle.isHandleValid());
   assert(getTypeFromHandle(handle) == LibraryHandle::type);
-  uint32_t index = getIndexFromHandle(handle);
-  assert(m_libraries.find(index) != m_libraries.end());
-  return m_libraries[index].fragFn;
+  const ShaderMetadata *metadata = m_libraries.get(handle);
+  assert(metadata != nullptr);
+  return metadata->fragFn;
 }
 id ShaderManager::getKernelFunction(LibraryHandle handle) {
   assert(handle.isHandleValid());
   assert(getTypeFromHandle(handle) == LibraryHandle::type);
-  uint32_t index = getIndexFromHandle(handle);
-  assert(m_libraries.find(index) != m_libraries.end());
-  return m_libraries[index].computeFn;
+  const ShaderMetadata *metadata = m_libraries.get(handle);
+  assert(metadata != nullptr);
+  return metadata->computeFn;
 
 }
 
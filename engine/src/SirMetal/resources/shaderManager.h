@@ -2,9 +2,11 @@
 
 #import <objc/objc.h>
 //
-#include <unordered_map>
 #include <string>
 #include "handle.h"
+#include "SirMetal/core/hashing/stringId.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/slotMap.h"
 #include "SirMetal/graphics/graphicsDefines.h"
 
 namespace SirMetal {
@@ -24,6 +26,8 @@ namespace SirMetal {
         id getLibraryFromHandle(LibraryHandle handle);
 
         LibraryHandle getHandleFromName(const std::string &name) const;
+        // the id is the StringId of the shader file name without extension
+        LibraryHandle getHandleFromId(StringId id) const;
 
         void initialize(id device) {
             m_device = device;
@@ -39,9 +43,8 @@ namespace SirMetal {
 
     private:
         id m_device;
-        std::unordered_map<uint32_t, ShaderMetadata> m_libraries;
-        std::unordered_map<std::string, uint32_t> m_nameToLibraryHandle;
-        uint32_t m_libraryCounter = 1;
+        SlotMap<ShaderMetadata, LibraryHandle> m_libraries;
+        HashMap<StringId, uint32_t, hashStringId> m_idToLibraryHandle{64};
     };
 }
 
@@ -40,15 +40,15 @@ id<MTLTexture> createTextureFromRequest(id<MTLDevice> device,
 TextureHandle TextureManager::allocate(id<MTLDevice> device,
                                        const AllocTextureRequest &request) {
 
-  auto found = m_nameToHandle.find(request.name);
-  if (found != m_nameToHandle.end()) {
-    return TextureHandle{found->second};
+  const StringId id = registerStringId(request.name.c_str());
+  uint32_t found = 0;
+  if (m_idToHandle.get(id, found)) {
+    return TextureHandle{found};
   }
   auto tex = createTextureFromRequest(device, request);
 
-  auto handle = getHandle<TextureHandle>(m_textureCounter++);
-  m_data[handle.handle] = TextureData{request, tex};
-  m_nameToHandle[request.name] = handle.handle;
+  auto handle = m_data.insert(TextureData{request, tex});
+  m_idToHandle.insert(id, handle.handle);
 
   return handle;
 }
@@ -71,9 +71,9 @@ TextureHandle TextureManager::loadFromMemory(id<MTLDevice> device, id<MTLCommand
 id TextureManager::getNativeFromHandle(TextureHandle handle) {
   HANDLE_TYPE type = getTypeFromHandle(handle);
   assert(type == HANDLE_TYPE::TEXTURE);
-  auto found = m_data.find(handle.handle);
-  if (found != m_data.end()) {
-    return found->second.texture;
+  const TextureData *found = m_data.get(handle);
+  if (found != nullptr) {
+    return found->texture;
   }
   assert(0 && "requested invalid texture");
   return nil;
@@ -90,12 +90,12 @@ bool TextureManager::resizeTexture(id<MTLDevice> device, TextureHandle handle,
   }
 
   // fetching the corresponding data
-  auto found = m_data.find(handle.handle);
-  if (found == m_data.end()) {
+  TextureData *found = m_data.get(handle);
+  if (found == nullptr) {
     printf("[ERROR][Texture Manager] Could not find data for requested handle");
     return false;
   }
-  TextureData &texData = found->second;
+  TextureData &texData = *found;
   if ((texData.request.width == newWidth) &
       (texData.request.height == newHeight)) {
     printf("[WARN][Texture Manager] Requested resize of texture with name%s "
@@ -173,9 +173,8 @@ TextureHandle TextureManager::createTextureFromTextureLoadResult(
   data.request.name = result.name;
   data.texture = tex;
 
-  auto handle = getHandle<TextureHandle>(m_textureCounter++);
-  m_data[handle.handle] = data;
-  m_nameToHandle[data.request.name] = handle.handle;
+  auto handle = m_data.insert(data);
+  m_idToHandle.insert(registerStringId(data.request.name.c_str()), handle.handle);
 
   return handle;
 }
@@ -257,9 +256,8 @@ TextureHandle TextureManager::generateSolidColorTexture(id<MTLDevice> device, id
   data.request.name = name;
   data.texture = tex;
 
-  auto handle = getHandle<TextureHandle>(m_textureCounter++);
-  m_data[handle.handle] = data;
-  m_nameToHandle[data.request.name] = handle.handle;
+  auto handle = m_data.insert(data);
+  m_idToHandle.insert(registerStringId(data.request.name.c_str()), handle.handle);
   return handle;
 }
 void TextureManager::initialize(id<MTLDevice> device, id<MTLCommandQueue> queue) {
@@ -3,10 +3,12 @@
 #include <assert.h>
 #include <stdint.h>
 #include <string>
-#include <unordered_map>
 
 #import <Metal/Metal.h>
 
+#include "SirMetal/core/hashing/stringId.h"
+#include "SirMetal/core/memory/cpu/hashMap.h"
+#include "SirMetal/core/memory/cpu/slotMap.h"
 #include "SirMetal/resources/handle.h"
 #include "SirMetal/resources/resourceTypes.h"
 #import "gltfLoader.h"
@@ -35,6 +37,11 @@ class TextureManager {
   TextureHandle allocate(id<MTLDevice> device,
                          const AllocTextureRequest &request);
   TextureHandle loadFromMemory(id<MTLDevice> device, id<MTLCommandQueue> queue, void *data, LOAD_TEXTURE_TYPE type, bool isGamma);
+  // uploads a texture already decoded on the CPU, used by the async loads
+  TextureHandle loadFromLoadResult(id<MTLDevice> device, id<MTLCommandQueue> queue,
+                                   const TextureLoadResult &result) {
+    return createTextureFromTextureLoadResult(device, queue, result);
+  }
 
   bool resizeTexture(id<MTLDevice> device, TextureHandle handle,
                      uint32_t newWidth, uint32_t newHeight);
@@ -42,9 +49,9 @@ class TextureManager {
   MTLPixelFormat getFormat(const TextureHandle handle) const {
     HANDLE_TYPE type = getTypeFromHandle(handle);
     assert(type == HANDLE_TYPE::TEXTURE);
-    auto found = m_data.find(handle.handle);
-    if (found != m_data.end()) {
-      return found->second.request.format;
+    const TextureData *found = m_data.get(handle);
+    if (found != nullptr) {
+      return found->request.format;
     }
     assert(0 && "requested invalid texture");
     return MTLPixelFormatInvalid;
@@ -52,6 +59,17 @@ class TextureManager {
 
   id getNativeFromHandle(TextureHandle handle);
 
+  TextureHandle getHandleFromName(const char *name) const {
+    return getHandleFromId(StringId(name));
+  }
+  TextureHandle getHandleFromId(const StringId id) const {
+    uint32_t found = 0;
+    if (m_idToHandle.get(id, found)) {
+      return TextureHandle{found};
+    }
+    return {};
+  }
+
   TextureHandle getWhiteTexture() const { return m_whiteTexture; }
   TextureHandle getBlackTexture() const { return m_blackTexture; }
 
@@ -67,9 +85,8 @@ class TextureManager {
   };
 
   private:
-  std::unordered_map<uint32_t, TextureData> m_data;
-  std::unordered_map<std::string, uint32_t> m_nameToHandle;
-  int m_textureCounter = 1;
+  SlotMap<TextureData, TextureHandle> m_data;
+  HashMap<StringId, uint32_t, hashStringId> m_idToHandle{64};
   TextureHandle m_whiteTexture{};
   TextureHandle m_blackTexture{};
 };
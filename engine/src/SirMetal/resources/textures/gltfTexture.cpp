@@ -36,6 +36,7 @@ void loadGltfTexture(TextureLoadResult &outData, void *data, bool isGamma) {
   size_t bufferSize = sizeof(char)*requestedChannels*x*y;
   outData.data.resize(bufferSize);
   memcpy(outData.data.data(), ptr, bufferSize);
+  stbi_image_free(ptr);
 
   outData.format = getGltfTextureFormat(texture, isGamma);
   outData.mipLevel = 1;
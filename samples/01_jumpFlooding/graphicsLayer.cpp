@@ -18,6 +18,8 @@
 
 #include <iostream>
 
+using namespace SirMetal::literals;
+
 typedef struct {
   matrix_float4x4 modelViewProjectionMatrix;
 } MBEUniforms;
@@ -115,7 +117,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget =
       m_engine->m_textureManager->getNativeFromHandle(m_depthHandle);
   SirMetal::PSOCache cache =
-      SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders", false});
+      SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders"_sid, false});
 
   MTLRenderPassDescriptor *passDescriptor =
       [MTLRenderPassDescriptor renderPassDescriptor];
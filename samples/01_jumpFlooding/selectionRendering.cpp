@@ -2,6 +2,7 @@
 
 #import <Metal/Metal.h>
 #import <SirMetal/core/memory/denseTree.h>
+#import <SirMetal/core/memory/cpu/frameAllocator.h>
 #import <SirMetal/engine.h>
 #import <SirMetal/graphics/constantBufferManager.h>
 #import <SirMetal/resources/meshes/meshManager.h>
@@ -12,8 +13,11 @@
 namespace SirMetal {
 
 void updateFloodIndices(EngineContext* context,int w, int h, ConstantBufferHandle buffer) {
-  std::vector<int> indices;
-  indices.resize(256 / 4 * 16);
+  // only lives until the copy in the constant buffer
+  StackAllocator::Scope scope(context->m_frameAllocator->getCurrent());
+  const uint32_t count = 256 / 4 * 16;
+  int *indices = context->m_frameAllocator->allocateArray<int>(count);
+  memset(indices, 0, sizeof(int) * count);
   int N = static_cast<int>(pow(2, 16));
   for (int i = 0; i < 16; ++i) {
     int offset = static_cast<int>(pow(2, (log2(N) - i - 1)));
@@ -23,20 +27,20 @@ void updateFloodIndices(EngineContext* context,int w, int h, ConstantBufferHandl
     indices[id + 2] = h;
   }
   ConstantBufferManager *cbManager = context->m_constantBufferManager;
-  cbManager->update(context,buffer, indices.data());
+  cbManager->update(context,buffer, indices);
 
 }
 
 void Selection::initialize(EngineContext* context ) {
 
   id<MTLDevice> device = context->m_renderingContext->getDevice();
-  m_jumpFloodInitMaterial.shaderName = "jumpInit";
+  m_jumpFloodInitMaterial.shaderName = "jumpInit"_sid;
   m_jumpFloodInitMaterial.blendingState.enabled = false;
-  m_jumpFloodMaskMaterial.shaderName = "jumpMask";
+  m_jumpFloodMaskMaterial.shaderName = "jumpMask"_sid;
   m_jumpFloodMaskMaterial.blendingState.enabled = false;
-  m_jumpFloodMaterial.shaderName = "jumpFlood";
+  m_jumpFloodMaterial.shaderName = "jumpFlood"_sid;
   m_jumpFloodMaterial.blendingState.enabled = false;
-  m_jumpOutlineMaterial.shaderName = "jumpOutline";
+  m_jumpOutlineMaterial.shaderName = "jumpOutline"_sid;
   m_jumpOutlineMaterial.blendingState.enabled = true;
   SirMetal::AlphaBlendingState &alpha = m_jumpOutlineMaterial.blendingState;
   alpha.rgbBlendOperation = MTLBlendOperationAdd;
@@ -26,6 +26,8 @@ static const char *shadowAlgorithms[] = {"PCF", "PCSS"};
 static constexpr float pcssPcfSizeDefault = 6.5f;
 static constexpr float pcfSizeDefault = 0.005f;
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -137,7 +139,7 @@ void GraphicsLayer::onUpdate() {
   shadowTracker.depthTarget =
       m_engine->m_textureManager->getNativeFromHandle(m_shadowHandle);
   SirMetal::PSOCache cache = SirMetal::getPSO(
-      m_engine, shadowTracker, SirMetal::Material{"shadows", false});
+      m_engine, shadowTracker, SirMetal::Material{"shadows"_sid, false});
 
   id<MTLCommandBuffer> commandBuffer = [queue commandBuffer];
   [commandBuffer setLabel:@"testName"];
@@ -191,7 +193,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget =
       m_engine->m_textureManager->getNativeFromHandle(m_depthHandle);
   cache =
-      SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders", false});
+      SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders"_sid, false});
 
   MTLRenderPassDescriptor *passDescriptor =
       [MTLRenderPassDescriptor renderPassDescriptor];
@@ -249,7 +251,7 @@ void GraphicsLayer::onUpdate() {
                         indexBufferOffset:0];
   }
   // render debug
-  m_engine->m_debugRenderer->newFrame();
+  m_engine->m_debugRenderer->newFrame(m_engine);
   float data[6]{0, 0, 0, 0, 100, 0};
   m_engine->m_debugRenderer->drawLines(data, sizeof(float) * 6,
                                        vector_float4{1, 0, 0, 1});
@@ -80,6 +80,8 @@ id createComputePipeline(id<MTLDevice> device, id function) {
   return toReturn;
 }
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -293,7 +295,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget = nullptr;
 
   SirMetal::PSOCache cache = SirMetal::getPSO(
-      m_engine, tracker, SirMetal::Material{"fullscreen", false});
+      m_engine, tracker, SirMetal::Material{"fullscreen"_sid, false});
 
   id<MTLCommandBuffer> commandBuffer = [queue commandBuffer];
 
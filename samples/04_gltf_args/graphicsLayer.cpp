@@ -20,6 +20,8 @@
 
 constexpr int kMaxInflightBuffers = 3;
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -53,12 +55,41 @@ void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
   // let us load the gltf file
 
   struct SirMetal::GLTFLoadOptions options;
-  options.flags= SirMetal::GLTFLoadFlags::GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY;
-  SirMetal::loadGLTF(m_engine, (baseSample + +"/test.glb").c_str(), m_asset, options);
+  options.flags = SirMetal::GLTFLoadFlags::GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY |
+                  SirMetal::GLTF_LOAD_FLAGS_MESH_CACHE;
+  // the asset streams in, the first frames are drawn while it is cooked and
+  // uploaded, see recordArgBuffers
+  m_assetLoad = SirMetal::loadGLTFAsync(m_engine, (baseSample + +"/test.glb").c_str(), options);
 
   m_shaderHandle =
           m_engine->m_shaderManager->loadShader((baseSample + "/Shaders.metal").c_str());
 
+  id<MTLDevice> device = m_engine->m_renderingContext->getDevice();
+  SirMetal::AllocTextureRequest requestDepth{m_engine->m_config.m_windowConfig.m_width,
+                                             m_engine->m_config.m_windowConfig.m_height,
+                                             1,
+                                             MTLTextureType2D,
+                                             MTLPixelFormatDepth32Float_Stencil8,
+                                             MTLTextureUsageRenderTarget |
+                                                     MTLTextureUsageShaderRead,
+                                             MTLStorageModePrivate,
+                                             1,
+                                             "depthTexture"};
+  m_depthHandle = m_engine->m_textureManager->allocate(device, requestDepth);
+
+  SirMetal::graphics::initImgui(m_engine);
+  frameBoundarySemaphore = dispatch_semaphore_create(kMaxInflightBuffers);
+
+  // this is to flush the gpu, making sure resources are properly loaded
+  m_engine->m_renderingContext->flush();
+
+  MTLArgumentBuffersTier tier = [device argumentBuffersSupport];
+  assert(tier == MTLArgumentBuffersTier2);
+}
+
+void GraphicsLayer::onDetach() {}
+
+void GraphicsLayer::recordArgBuffers() {
   // now we process the args buffer, we currently use two argument buffers
   // one is used in the vertex shader to fetch the mesh data
   // the second one is used in the fragment shader to fetch the material data (for now a simple
@@ -130,31 +161,8 @@ void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
     auto *ptr = [argumentEncoderFrag constantDataAtIndex:2];
     memcpy(ptr, &material.colorFactors, sizeof(float) * 4);
   }
-
-  SirMetal::AllocTextureRequest requestDepth{m_engine->m_config.m_windowConfig.m_width,
-                                             m_engine->m_config.m_windowConfig.m_height,
-                                             1,
-                                             MTLTextureType2D,
-                                             MTLPixelFormatDepth32Float_Stencil8,
-                                             MTLTextureUsageRenderTarget |
-                                                     MTLTextureUsageShaderRead,
-                                             MTLStorageModePrivate,
-                                             1,
-                                             "depthTexture"};
-  m_depthHandle = m_engine->m_textureManager->allocate(device, requestDepth);
-
-  SirMetal::graphics::initImgui(m_engine);
-  frameBoundarySemaphore = dispatch_semaphore_create(kMaxInflightBuffers);
-
-  // this is to flush the gpu, making sure resources are properly loaded
-  m_engine->m_renderingContext->flush();
-
-  MTLArgumentBuffersTier tier = [device argumentBuffersSupport];
-  assert(tier == MTLArgumentBuffersTier2);
 }
 
-void GraphicsLayer::onDetach() {}
-
 void GraphicsLayer::updateUniformsForView(float screenWidth, float screenHeight) {
 
   SirMetal::Input *input = m_engine->m_inputManager;
@@ -174,6 +182,17 @@ void GraphicsLayer::onUpdate() {
     SDL_PushEvent(&sdlevent);
   }
 
+  // the asset shows up once the async load is done, the meshes are drawn from
+  // the frame after
+  if (!m_argBuffersRecorded) {
+    const SirMetal::GLTFAsset *asset = SirMetal::getGLTFAsset(m_engine, m_assetLoad);
+    if (asset != nullptr) {
+      m_asset = *asset;
+      recordArgBuffers();
+      m_argBuffersRecorded = true;
+    }
+  }
+
   CAMetalLayer *swapchain = m_engine->m_renderingContext->getSwapchain();
   id<MTLCommandQueue> queue = m_engine->m_renderingContext->getQueue();
 
@@ -194,7 +213,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget = m_engine->m_textureManager->getNativeFromHandle(m_depthHandle);
 
   SirMetal::PSOCache cache =
-          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders", false});
+          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders"_sid, false});
 
   id<MTLCommandBuffer> commandBuffer = [queue commandBuffer];
 
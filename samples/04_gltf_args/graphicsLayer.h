@@ -39,6 +39,7 @@ private:
   void renderDebugWindow();
   void generateRandomTexture();
   void encodeShadeRt(id<MTLCommandBuffer> commandBuffer, float w, float h);
+  void recordArgBuffers();
 
 private:
   SirMetal::Camera m_camera;
@@ -63,5 +64,7 @@ private:
   void encodePrimaryRay(id<MTLCommandBuffer> commandBuffer, float w, float h);
 
   SirMetal::GLTFAsset m_asset;
+  SirMetal::AsyncLoadHandle m_assetLoad;
+  bool m_argBuffersRecorded = false;
 };
 } // namespace Sandbox
@@ -70,6 +70,8 @@ id createComputePipeline(id<MTLDevice> device, id function) {
   return toReturn;
 }
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -101,7 +103,8 @@ void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
   const std::string base = m_engine->m_config.m_dataSourcePath + "05_modern_rt";
   // let us load the gltf file
   struct SirMetal::GLTFLoadOptions options;
-  options.flags= SirMetal::GLTFLoadFlags::GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY;
+  options.flags = SirMetal::GLTFLoadFlags::GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY |
+                  SirMetal::GLTF_LOAD_FLAGS_MESH_CACHE;
 
   SirMetal::loadGLTF(m_engine, (base + +"/test.glb").c_str(), m_asset,
                      options );
@@ -244,7 +247,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget = {};
 
   SirMetal::PSOCache cache =
-          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"fullscreen", false});
+          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"fullscreen"_sid, false});
 
 
   encodeMonoRay(commandBuffer, w, h);
@@ -277,7 +280,7 @@ void GraphicsLayer::onUpdate() {
 
 
   // render debug
-  m_engine->m_debugRenderer->newFrame();
+  m_engine->m_debugRenderer->newFrame(m_engine);
   float data[6]{0, 0, 0, 0, 100, 0};
   m_engine->m_debugRenderer->drawLines(data, sizeof(float) * 6,
                                        vector_float4{1, 0, 0, 1});
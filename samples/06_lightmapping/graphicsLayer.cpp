@@ -59,6 +59,8 @@ id createComputePipeline(id<MTLDevice> device, id function) {
   return toReturn;
 }
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -83,8 +85,11 @@ void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
   const std::string base = m_engine->m_config.m_dataSourcePath + "/sandbox";
   // let us load the gltf file
   struct SirMetal::GLTFLoadOptions options;
+  // the light map uvs take seconds per mesh, they come from the mesh cache
+  // after the first run
   options.flags = SirMetal::GLTFLoadFlags::GLTF_LOAD_FLAGS_FLATTEN_HIERARCHY |
-                  SirMetal::GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS;
+                  SirMetal::GLTF_LOAD_FLAGS_GENERATE_LIGHT_MAP_UVS |
+                  SirMetal::GLTF_LOAD_FLAGS_MESH_CACHE;
   options.lightMapSize = lightMapSize;
 
   SirMetal::loadGLTF(m_engine, (base + +"/test.glb").c_str(), m_asset, options);
@@ -207,7 +212,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget = m_engine->m_textureManager->getNativeFromHandle(m_depthHandle);
 
   SirMetal::PSOCache cache =
-          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders", false});
+          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders"_sid, false});
 
   // blitting to the swap chain
   MTLRenderPassDescriptor *passDescriptor =
@@ -249,7 +254,7 @@ void GraphicsLayer::onUpdate() {
     SirMetal::graphics::doBlit(m_engine, commandEncoder, request);
   }
   // render debug
-  m_engine->m_debugRenderer->newFrame();
+  m_engine->m_debugRenderer->newFrame(m_engine);
   float data[6]{0, 0, 0, 0, 100, 0};
   m_engine->m_debugRenderer->drawLines(data, sizeof(float) * 6,
                                        vector_float4{1, 0, 0, 1});
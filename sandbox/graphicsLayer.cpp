@@ -59,6 +59,8 @@ id createComputePipeline(id<MTLDevice> device, id function) {
   return toReturn;
 }
 
+using namespace SirMetal::literals;
+
 namespace Sandbox {
 void GraphicsLayer::onAttach(SirMetal::EngineContext *context) {
 
@@ -207,7 +209,7 @@ void GraphicsLayer::onUpdate() {
   tracker.depthTarget = m_engine->m_textureManager->getNativeFromHandle(m_depthHandle);
 
   SirMetal::PSOCache cache =
-          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders", false});
+          SirMetal::getPSO(m_engine, tracker, SirMetal::Material{"Shaders"_sid, false});
 
   // blitting to the swap chain
   MTLRenderPassDescriptor *passDescriptor =
@@ -249,7 +251,7 @@ void GraphicsLayer::onUpdate() {
     SirMetal::graphics::doBlit(m_engine, commandEncoder, request);
   }
   // render debug
-  m_engine->m_debugRenderer->newFrame();
+  m_engine->m_debugRenderer->newFrame(m_engine);
   float data[6]{0, 0, 0, 0, 100, 0};
   m_engine->m_debugRenderer->drawLines(data, sizeof(float) * 6,
                                        vector_float4{1, 0, 0, 1});
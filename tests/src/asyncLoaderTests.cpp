@@ -0,0 +1,148 @@
+#include "SirMetal/core/jobs/jobSystem.h"
+#include "SirMetal/resources/asyncLoader.h"
+#include "catch/catch.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+// pretends to decode on cook and to push pieces of fixed size on upload
+class FakeLoadTask final : public SirMetal::AsyncLoadTask {
+public:
+  FakeLoadTask(const uint32_t pieceCount, const uint64_t pieceSize, const bool fails = false)
+      : m_pieceCount(pieceCount), m_pieceSize(pieceSize), m_fails(fails) {}
+
+  bool cook() override {
+    m_cookThread = std::this_thread::get_id();
+    m_cooked = true;
+    return !m_fails;
+  }
+  uint64_t upload(const uint64_t budgetInBytes) override {
+    uint64_t uploaded = 0;
+    do {
+      uploaded += m_pieceSize;
+      ++m_uploadedPieces;
+    } while ((m_uploadedPieces < m_pieceCount) && (uploaded + m_pieceSize <= budgetInBytes));
+    return uploaded;
+  }
+  bool isUploaded() const override { return m_uploadedPieces == m_pieceCount; }
+
+  uint32_t m_pieceCount;
+  uint64_t m_pieceSize;
+  bool m_fails;
+  bool m_cooked = false;
+  std::thread::id m_cookThread;
+  uint32_t m_uploadedPieces = 0;
+};
+} // namespace
+
+TEST_CASE("Async loader uploads within the frame budget", "[resources]") {
+  SirMetal::AsyncLoader loader;
+  // no job system, tasks are cooked in request
+  loader.initialize(nullptr, 2048);
+
+  auto *first = new FakeLoadTask(4, 1024);
+  auto *second = new FakeLoadTask(1, 4096);
+  auto *third = new FakeLoadTask(2, 512);
+  const SirMetal::AsyncLoadHandle firstHandle = loader.request(std::unique_ptr<FakeLoadTask>(first));
+  const SirMetal::AsyncLoadHandle secondHandle = loader.request(std::unique_ptr<FakeLoadTask>(second));
+  const SirMetal::AsyncLoadHandle thirdHandle = loader.request(std::unique_ptr<FakeLoadTask>(third));
+  REQUIRE(first->m_cooked);
+  REQUIRE(loader.getState(firstHandle) == SirMetal::ASYNC_LOAD_STATE::COOKING);
+  REQUIRE(loader.getTask(firstHandle) == nullptr);
+  REQUIRE(loader.getInFlightCount() == 3);
+
+  // two pieces of the first task a frame
+  REQUIRE(loader.processUploads() == 2048);
+  REQUIRE(loader.getState(firstHandle) == SirMetal::ASYNC_LOAD_STATE::UPLOADING);
+  REQUIRE(first->m_uploadedPieces == 2);
+  REQUIRE(loader.processUploads() == 2048);
+  REQUIRE(loader.isDone(firstHandle));
+  REQUIRE(loader.getTask(firstHandle) == first);
+  // a piece bigger than the budget still goes through, alone
+  REQUIRE(loader.processUploads() == 4096);
+  REQUIRE(loader.isDone(secondHandle));
+  REQUIRE(loader.getState(thirdHandle) == SirMetal::ASYNC_LOAD_STATE::UPLOADING);
+  REQUIRE(loader.processUploads() == 1024);
+  REQUIRE(loader.isDone(thirdHandle));
+  REQUIRE(loader.getInFlightCount() == 0);
+  REQUIRE(loader.processUploads() == 0);
+
+  // released handles are stale
+  REQUIRE(loader.release(firstHandle));
+  REQUIRE(loader.getState(firstHandle) == SirMetal::ASYNC_LOAD_STATE::INVALID);
+  REQUIRE_FALSE(loader.release(firstHandle));
+  REQUIRE(loader.isDone(secondHandle));
+}
+
+TEST_CASE("Async loader failures and release while uploading", "[resources]") {
+  SirMetal::AsyncLoader loader;
+  loader.initialize(nullptr, 1024);
+  const SirMetal::AsyncLoadHandle failing = loader.request(std::make_unique<FakeLoadTask>(1, 1024, true));
+  auto *dropped = new FakeLoadTask(8, 1024);
+  const SirMetal::AsyncLoadHandle droppedHandle = loader.request(std::unique_ptr<FakeLoadTask>(dropped));
+  const SirMetal::AsyncLoadHandle kept = loader.request(std::make_unique<FakeLoadTask>(1, 1024));
+
+  REQUIRE(loader.processUploads() == 1024);
+  REQUIRE(loader.getState(failing) == SirMetal::ASYNC_LOAD_STATE::FAILED);
+  REQUIRE(loader.getTask(failing) == nullptr);
+  REQUIRE(dropped->m_uploadedPieces == 1);
+  REQUIRE(loader.release(droppedHandle));
+  REQUIRE(loader.getInFlightCount() == 1);
+  REQUIRE(loader.processUploads() == 1024);
+  REQUIRE(loader.isDone(kept));
+  REQUIRE(loader.release(failing));
+}
+
+TEST_CASE("Async loader cooks on the job system", "[resources]") {
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(2);
+  SirMetal::AsyncLoader loader;
+  loader.initialize(&jobSystem, 4096);
+
+  static constexpr uint32_t LOADS = 64;
+  std::vector<FakeLoadTask *> tasks;
+  std::vector<SirMetal::AsyncLoadHandle> handles;
+  for (uint32_t i = 0; i < LOADS; ++i) {
+    tasks.push_back(new FakeLoadTask(1 + i % 3, 1024));
+    handles.push_back(loader.request(std::unique_ptr<FakeLoadTask>(tasks.back())));
+  }
+  // frames keep going while the workers cook, the budget holds every frame
+  uint32_t frames = 0;
+  while (loader.getInFlightCount() != 0) {
+    REQUIRE(loader.processUploads() <= 4096);
+    ++frames;
+    std::this_thread::yield();
+  }
+  REQUIRE(frames >= (LOADS * 2 * 1024) / 4096);
+  bool done = true;
+  for (const SirMetal::AsyncLoadHandle handle : handles) { done &= loader.isDone(handle); }
+  REQUIRE(done);
+
+  // flush does it all in one go
+  const SirMetal::AsyncLoadHandle last = loader.request(std::make_unique<FakeLoadTask>(16, 1024));
+  loader.flush();
+  REQUIRE(loader.isDone(last));
+  loader.cleanup();
+  REQUIRE(loader.getState(last) == SirMetal::ASYNC_LOAD_STATE::INVALID);
+  jobSystem.cleanup();
+}
+
+TEST_CASE("Async loader with a job system without workers", "[resources]") {
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(0);
+  SirMetal::AsyncLoader loader;
+  loader.initialize(&jobSystem, 4096);
+
+  // nothing would run the jobs, the task is cooked in request
+  auto *task = new FakeLoadTask(2, 1024);
+  const SirMetal::AsyncLoadHandle handle = loader.request(std::unique_ptr<FakeLoadTask>(task));
+  REQUIRE(task->m_cooked);
+  REQUIRE(task->m_cookThread == std::this_thread::get_id());
+  REQUIRE(loader.processUploads() == 2048);
+  REQUIRE(loader.isDone(handle));
+  REQUIRE(loader.getInFlightCount() == 0);
+  loader.cleanup();
+  jobSystem.cleanup();
+}
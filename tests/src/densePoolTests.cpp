@@ -0,0 +1,72 @@
+#include "SirMetal/core/memory/cpu/densePool.h"
+#include "catch/catch.h"
+#include <string>
+
+TEST_CASE("Dense pool insert get", "[memory]") {
+  SirMetal::DensePool<uint32_t> pool(16);
+  SirMetal::DensePoolHandle a = pool.insert(10);
+  SirMetal::DensePoolHandle b = pool.insert(20);
+  REQUIRE(a.isHandleValid());
+  REQUIRE(b.isHandleValid());
+  REQUIRE(pool.size() == 2);
+  REQUIRE(*pool.get(a) == 10);
+  REQUIRE(*pool.get(b) == 20);
+  REQUIRE(pool.get(SirMetal::DensePoolHandle{}) == nullptr);
+  // index never handed out
+  REQUIRE(pool.get(SirMetal::DensePoolHandle{10, 0}) == nullptr);
+}
+
+TEST_CASE("Dense pool remove keeps the objects packed", "[memory]") {
+  SirMetal::DensePool<uint32_t> pool(16);
+  SirMetal::DensePoolHandle handles[5];
+  for (uint32_t i = 0; i < 5; ++i) { handles[i] = pool.insert(i); }
+  REQUIRE(pool.remove(handles[1]));
+  REQUIRE(pool.size() == 4);
+  // the last object moved in the hole, its handle still finds it
+  REQUIRE(pool.data()[1] == 4);
+  REQUIRE(*pool.get(handles[4]) == 4);
+  REQUIRE(pool.getHandle(1).index == handles[4].index);
+  for (const uint32_t i : {0u, 2u, 3u, 4u}) { REQUIRE(*pool.get(handles[i]) == i); }
+
+  uint32_t sum = 0;
+  pool.forEach([&](const uint32_t value) { sum += value; });
+  REQUIRE(sum == 9);
+
+  // removing the last one does not move anything
+  REQUIRE(pool.remove(handles[3]));
+  REQUIRE(*pool.get(handles[4]) == 4);
+  REQUIRE(pool.size() == 3);
+}
+
+TEST_CASE("Dense pool stale handle", "[memory]") {
+  SirMetal::DensePool<std::string> pool(4);
+  SirMetal::DensePoolHandle a = pool.insert(std::string("first"));
+  REQUIRE(pool.remove(a));
+  REQUIRE_FALSE(pool.isValid(a));
+  REQUIRE(pool.get(a) == nullptr);
+  REQUIRE_FALSE(pool.remove(a));
+
+  // the sparse slot is reused with a new generation
+  SirMetal::DensePoolHandle b = pool.insert(std::string("second"));
+  REQUIRE(b.index == a.index);
+  REQUIRE(b.generation != a.generation);
+  REQUIRE(pool.get(a) == nullptr);
+  REQUIRE(*pool.get(b) == "second");
+}
+
+TEST_CASE("Dense pool clear", "[memory]") {
+  SirMetal::DensePool<uint32_t> pool(4);
+  SirMetal::DensePoolHandle a = pool.insert(1);
+  SirMetal::DensePoolHandle b = pool.insert(2);
+  pool.clear();
+  REQUIRE(pool.size() == 0);
+  REQUIRE(pool.get(a) == nullptr);
+  REQUIRE(pool.get(b) == nullptr);
+  SirMetal::DensePoolHandle c = pool.insert(3);
+  REQUIRE(c.index == a.index);
+  REQUIRE(pool.get(a) == nullptr);
+  REQUIRE(*pool.get(c) == 3);
+  // the pool can be filled again after a clear
+  for (uint32_t i = 0; i < 3; ++i) { REQUIRE(pool.insert(i).isHandleValid()); }
+  REQUIRE(pool.size() == 4);
+}
@@ -1,4 +1,5 @@
 #include "SirMetal/core/hashing/hashing.h"
+#include "SirMetal/core/memory/cpu/containerAllocators.h"
 #include "SirMetal/core/memory/cpu/hashMap.h"
 #include "catch/catch.h"
 #include <iostream>
@@ -179,3 +180,215 @@ TEST_CASE("hashmap empty 2000", "[memory]") {
     REQUIRE(alloc.get(k,value) == false);
   }
 }
+
+TEST_CASE("hashmap bins power of two", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(200);
+  REQUIRE(alloc.binCount() == 256);
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc2(256);
+  REQUIRE(alloc2.binCount() == 256);
+}
+
+TEST_CASE("hashmap grow past initial bins", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(16);
+  const uint32_t count = 5000;
+  for (uint32_t i = 0; i < count; ++i) {
+    REQUIRE(alloc.insert(i, i * 3) == true);
+  }
+  REQUIRE(alloc.getUsedBins() == count);
+  REQUIRE(alloc.binCount() >= count);
+  uint32_t value;
+  for (uint32_t i = 0; i < count; ++i) {
+    REQUIRE(alloc.get(i, value) == true);
+    REQUIRE(value == i * 3);
+  }
+}
+
+TEST_CASE("hashmap reserve", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(16);
+  alloc.reserve(1000);
+  const uint32_t bins = alloc.binCount();
+  REQUIRE(bins >= 1000);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    alloc.insert(i, i);
+  }
+  // no rehash should have happened
+  REQUIRE(alloc.binCount() == bins);
+}
+
+TEST_CASE("hashmap lookup after removing colliding keys", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(64);
+  // filling up to the max load such that keys get displaced from home
+  const uint32_t count = 48;
+  for (uint32_t k = 0; k < count; ++k) {
+    alloc.insert(k, k + 1);
+  }
+  REQUIRE(alloc.binCount() == 64);
+  uint32_t displaced = 0;
+  for (uint32_t bin = 0; bin < alloc.binCount(); ++bin) {
+    displaced += alloc.isBinUsed(bin) && alloc.probeLength(bin) != 0;
+  }
+  REQUIRE(displaced > 0);
+
+  for (uint32_t k = 0; k < count; k += 2) {
+    REQUIRE(alloc.remove(k) == true);
+    REQUIRE(alloc.remove(k) == false);
+  }
+  uint32_t value;
+  for (uint32_t k = 1; k < count; k += 2) {
+    REQUIRE(alloc.get(k, value) == true);
+    REQUIRE(value == k + 1);
+  }
+  // re inserting existing keys must not duplicate them
+  for (uint32_t k = 1; k < count; k += 2) {
+    alloc.insert(k, 99);
+  }
+  REQUIRE(alloc.getUsedBins() == count / 2);
+  REQUIRE(alloc.get(count - 1, value) == true);
+  REQUIRE(value == 99);
+}
+
+TEST_CASE("hashmap full group scan", "[memory]") {
+  // smallest map is a single group, probing wraps on the mirrored control bytes
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(1);
+  REQUIRE(alloc.binCount() == 16);
+  for (uint32_t k = 100; k < 112; ++k) {
+    alloc.insert(k, k);
+  }
+  REQUIRE(alloc.binCount() == 16);
+  uint32_t value;
+  for (uint32_t k = 100; k < 112; ++k) {
+    REQUIRE(alloc.get(k, value) == true);
+    REQUIRE(value == k);
+  }
+  for (uint32_t k = 0; k < 100; ++k) {
+    REQUIRE(alloc.containsKey(k) == false);
+  }
+}
+
+TEST_CASE("hashmap insert remove churn", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(256);
+  // keeping a small live set while leaving lots of tombstones behind
+  for (uint32_t i = 0; i < 20000; ++i) {
+    alloc.insert(i, i);
+    if (i >= 50) {
+      REQUIRE(alloc.remove(i - 50) == true);
+    }
+  }
+  REQUIRE(alloc.getUsedBins() == 50);
+  REQUIRE(alloc.binCount() == 256);
+  uint32_t value;
+  for (uint32_t i = 20000 - 50; i < 20000; ++i) {
+    REQUIRE(alloc.get(i, value) == true);
+    REQUIRE(value == i);
+  }
+  REQUIRE(alloc.containsKey(0) == false);
+}
+
+TEST_CASE("hashmap remove at low load leaves no tombstones", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(1024);
+  for (uint32_t k = 0; k < 64; ++k) {
+    alloc.insert(k, k);
+  }
+  for (uint32_t k = 0; k < 64; ++k) {
+    REQUIRE(alloc.remove(k) == true);
+  }
+  REQUIRE(alloc.getUsedBins() == 0);
+  REQUIRE(alloc.getDeletedBins() == 0);
+}
+
+TEST_CASE("hashmap tombstones stay bounded under churn", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(64);
+  // a single group table is always full enough to need tombstones
+  const uint32_t live = 40;
+  uint32_t maxDeleted = 0;
+  for (uint32_t i = 0; i < 50000; ++i) {
+    alloc.insert(i, i);
+    if (i >= live) {
+      REQUIRE(alloc.remove(i - live) == true);
+    }
+    const uint32_t deleted = alloc.getDeletedBins();
+    maxDeleted = deleted > maxDeleted ? deleted : maxDeleted;
+  }
+  const auto stats = alloc.getStats();
+  REQUIRE(stats.usedBins == live);
+  REQUIRE(stats.deletedBins == alloc.getDeletedBins());
+  REQUIRE(maxDeleted <= (stats.binCount * decltype(alloc)::MAX_DELETED_PERCENT) / 100 + 1);
+  uint32_t value;
+  for (uint32_t i = 50000 - live; i < 50000; ++i) {
+    REQUIRE(alloc.get(i, value) == true);
+    REQUIRE(value == i);
+  }
+}
+
+TEST_CASE("hashmap stats", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(256);
+  auto stats = alloc.getStats();
+  REQUIRE(stats.binCount == 256);
+  REQUIRE(stats.usedBins == 0);
+  REQUIRE(stats.averageProbeLength == 0.0f);
+  for (uint32_t k = 0; k < 150; ++k) {
+    alloc.insert(k, k);
+  }
+  stats = alloc.getStats();
+  REQUIRE(stats.usedBins == 150);
+  uint32_t maxProbe = 0;
+  for (uint32_t bin = 0; bin < alloc.binCount(); ++bin) {
+    if (alloc.isBinUsed(bin)) {
+      maxProbe = alloc.probeLength(bin) > maxProbe ? alloc.probeLength(bin) : maxProbe;
+    }
+  }
+  REQUIRE(stats.maxProbeLength == maxProbe);
+  REQUIRE(stats.averageProbeLength <= static_cast<float>(maxProbe));
+}
+
+TEST_CASE("hashmap get batch", "[memory]") {
+  SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32> alloc(64);
+  for (uint32_t k = 0; k < 500; k += 2) {
+    alloc.insert(k, k * 10);
+  }
+  // not a multiple of the batch chunk on purpose
+  const uint32_t count = 101;
+  std::vector<uint32_t> keys(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    keys[i] = i * 3;
+  }
+  std::vector<uint32_t> values(count, 0xFFFFFFFF);
+  bool found[count];
+  alloc.getBatch(keys.data(), values.data(), found, count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const bool expected = (keys[i] % 2 == 0) && keys[i] < 500;
+    REQUIRE(found[i] == expected);
+    if (expected) {
+      REQUIRE(values[i] == keys[i] * 10);
+    } else {
+      REQUIRE(values[i] == 0xFFFFFFFF);
+    }
+  }
+  // empty batch is a no op
+  alloc.getBatch(keys.data(), values.data(), found, 0);
+}
+
+TEST_CASE("hashmap in pool", "[memory]") {
+  SirMetal::ThreeSizesPool pool(1 << 20);
+  SirMetal::BudgetAllocator<SirMetal::ThreeSizesPool> budget(&pool, "hashmap", 1 << 20);
+  {
+    SirMetal::HashMap<uint32_t, uint32_t, SirMetal::hashUint32,
+                      SirMetal::BudgetAllocator<SirMetal::ThreeSizesPool>>
+        alloc(16, &budget);
+    // keys, values and control bytes
+    REQUIRE(budget.getAllocationCount() == 3);
+    for (uint32_t k = 0; k < 2000; ++k) {
+      alloc.insert(k, k + 1);
+    }
+    // rehashes gave back the old arrays
+    REQUIRE(budget.getAllocationCount() == 3);
+    REQUIRE(budget.getUsedBytes() ==
+            alloc.binCount() * (sizeof(uint32_t) * 2 + 1) + 16);
+    uint32_t value;
+    for (uint32_t k = 0; k < 2000; ++k) {
+      REQUIRE(alloc.get(k, value) == true);
+      REQUIRE(value == k + 1);
+    }
+  }
+  REQUIRE(budget.getUsedBytes() == 0);
+}
@@ -0,0 +1,212 @@
+#include "SirMetal/core/jobs/jobSystem.h"
+#include "SirMetal/core/jobs/workStealingDeque.h"
+#include "catch/catch.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Work stealing deque owner and thief ends", "[jobs]") {
+  SirMetal::WorkStealingDeque<uint32_t> deque(3);
+  REQUIRE(deque.capacity() == 4);
+  uint32_t values[5] = {0, 1, 2, 3, 4};
+  REQUIRE(deque.pop() == nullptr);
+  REQUIRE(deque.steal() == nullptr);
+  for (uint32_t i = 0; i < 4; ++i) { REQUIRE(deque.push(&values[i])); }
+  REQUIRE_FALSE(deque.push(&values[4]));
+  // owner is last in first out, thieves take the oldest
+  REQUIRE(deque.pop() == &values[3]);
+  REQUIRE(deque.steal() == &values[0]);
+  REQUIRE(deque.push(&values[4]));
+  REQUIRE(deque.steal() == &values[1]);
+  REQUIRE(deque.pop() == &values[4]);
+  REQUIRE(deque.pop() == &values[2]);
+  REQUIRE(deque.pop() == nullptr);
+  REQUIRE(deque.isEmptyApprox());
+}
+
+TEST_CASE("Work stealing deque every value taken once", "[jobs]") {
+  static constexpr uint32_t COUNT = 100000;
+  static constexpr uint32_t THIEVES = 3;
+  SirMetal::WorkStealingDeque<uint32_t> deque(256);
+  std::vector<uint32_t> values(COUNT);
+  std::vector<std::atomic<uint32_t>> taken(COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) { values[i] = i; }
+  std::atomic<uint32_t> takenCount{0};
+  std::vector<std::thread> thieves;
+  for (uint32_t t = 0; t < THIEVES; ++t) {
+    thieves.emplace_back([&] {
+      while (takenCount.load(std::memory_order_relaxed) < COUNT) {
+        uint32_t *value = deque.steal();
+        if (value == nullptr) {
+          std::this_thread::yield();
+          continue;
+        }
+        taken[*value].fetch_add(1, std::memory_order_relaxed);
+        takenCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (uint32_t i = 0; i < COUNT;) {
+    if (deque.push(&values[i])) {
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+    // the owner takes its share from the bottom
+    if ((i & 3) == 0) {
+      uint32_t *value = deque.pop();
+      if (value != nullptr) {
+        taken[*value].fetch_add(1, std::memory_order_relaxed);
+        takenCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+  while (uint32_t *value = deque.pop()) {
+    taken[*value].fetch_add(1, std::memory_order_relaxed);
+    takenCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (std::thread &thread : thieves) { thread.join(); }
+  bool once = true;
+  for (uint32_t i = 0; i < COUNT; ++i) { once &= taken[i].load() == 1; }
+  REQUIRE(once);
+}
+
+TEST_CASE("Job system without workers runs jobs in wait", "[jobs]") {
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(0);
+  REQUIRE(jobSystem.getWorkerCount() == 0);
+  REQUIRE(jobSystem.getThreadCount() == 1);
+  REQUIRE(jobSystem.getCurrentThreadIndex() == 0);
+
+  SirMetal::TaskGroup group;
+  uint32_t sum = 0;
+  for (uint32_t i = 1; i <= 10; ++i) {
+    jobSystem.run(group, [&sum, i] { sum += i; });
+  }
+  REQUIRE(group.getPendingCount() == 10);
+  REQUIRE(sum == 0);
+  jobSystem.wait(group);
+  REQUIRE(group.isDone());
+  REQUIRE(sum == 55);
+  jobSystem.cleanup();
+  REQUIRE(jobSystem.getCurrentThreadIndex() == SirMetal::JobSystem::NOT_A_WORKER);
+}
+
+TEST_CASE("Job system groups of jobs", "[jobs]") {
+  static constexpr uint32_t JOBS = 20000;
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(3);
+  REQUIRE(jobSystem.getThreadCount() == 4);
+
+  SirMetal::TaskGroup group;
+  std::atomic<uint32_t> sum{0};
+  for (uint32_t i = 0; i < JOBS; ++i) {
+    jobSystem.run(group, [&sum] { sum.fetch_add(1, std::memory_order_relaxed); });
+  }
+  jobSystem.wait(group);
+  REQUIRE(sum.load() == JOBS);
+
+  // jobs spawning more jobs in the same group, the group is only done once
+  // the children are
+  std::atomic<uint32_t> children{0};
+  for (uint32_t i = 0; i < 64; ++i) {
+    jobSystem.run(group, [&jobSystem, &group, &children] {
+      for (uint32_t c = 0; c < 16; ++c) {
+        jobSystem.run(group, [&children] { children.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+  }
+  jobSystem.wait(group);
+  REQUIRE(children.load() == 64 * 16);
+
+  // threads outside the system go through the shared queue
+  uint32_t outsiderIndex = 0;
+  std::thread outsider([&jobSystem, &group, &sum, &outsiderIndex] {
+    outsiderIndex = jobSystem.getCurrentThreadIndex();
+    for (uint32_t i = 0; i < 100; ++i) {
+      jobSystem.run(group, [&sum] { sum.fetch_add(1, std::memory_order_relaxed); });
+    }
+    jobSystem.wait(group);
+  });
+  outsider.join();
+  REQUIRE(outsiderIndex == SirMetal::JobSystem::NOT_A_WORKER);
+  REQUIRE(sum.load() == JOBS + 100);
+  jobSystem.cleanup();
+}
+
+TEST_CASE("Job system parallel for", "[jobs]") {
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(3);
+
+  const uint32_t counts[] = {0, 1, 7, 1000, 100003};
+  const uint32_t grains[] = {0, 1, 64, 200000};
+  for (const uint32_t count : counts) {
+    for (const uint32_t grain : grains) {
+      std::vector<uint32_t> hits(count, 0);
+      std::atomic<uint32_t> chunks{0};
+      std::atomic<uint32_t> biggestChunk{0};
+      jobSystem.parallelFor(count, grain, [&](const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) { ++hits[i]; }
+        chunks.fetch_add(1, std::memory_order_relaxed);
+        uint32_t biggest = biggestChunk.load(std::memory_order_relaxed);
+        while ((end - begin > biggest) &&
+               !biggestChunk.compare_exchange_weak(biggest, end - begin)) {}
+      });
+      bool once = true;
+      for (uint32_t i = 0; i < count; ++i) { once &= hits[i] == 1; }
+      REQUIRE(once);
+      if ((grain != 0) && (count != 0)) { REQUIRE(biggestChunk.load() <= grain); }
+      if (count == 0) { REQUIRE(chunks.load() == 0); }
+    }
+  }
+
+  // nested, a parallel for inside the chunks of another
+  std::atomic<uint32_t> total{0};
+  jobSystem.parallelFor(16, 1, [&](const uint32_t begin, const uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      jobSystem.parallelFor(1000, 50, [&total](const uint32_t innerBegin, const uint32_t innerEnd) {
+        total.fetch_add(innerEnd - innerBegin, std::memory_order_relaxed);
+      });
+    }
+  });
+  REQUIRE(total.load() == 16 * 1000);
+  jobSystem.cleanup();
+}
+
+TEST_CASE("Job system dependencies", "[jobs]") {
+  SirMetal::JobSystem jobSystem;
+  jobSystem.initialize(2);
+
+  // a chain of groups, each stage reads what the previous one wrote
+  static constexpr uint32_t COUNT = 256;
+  std::vector<uint32_t> first(COUNT, 0);
+  std::vector<uint32_t> second(COUNT, 0);
+  uint32_t sum = 0;
+  SirMetal::TaskGroup firstStage;
+  SirMetal::TaskGroup secondStage;
+  SirMetal::TaskGroup lastStage;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    jobSystem.run(firstStage, [&first, i] {
+      std::this_thread::yield();
+      first[i] = i;
+    });
+  }
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    jobSystem.runAfter(firstStage, secondStage, [&first, &second, i] { second[i] = first[i] * 2; });
+  }
+  jobSystem.runAfter(secondStage, lastStage, [&second, &sum] {
+    for (const uint32_t value : second) { sum += value; }
+  });
+  jobSystem.wait(lastStage);
+  REQUIRE(firstStage.isDone());
+  REQUIRE(secondStage.isDone());
+  REQUIRE(sum == COUNT * (COUNT - 1));
+
+  // depending on a group already done runs right away
+  bool ran = false;
+  SirMetal::TaskGroup group;
+  jobSystem.runAfter(firstStage, group, [&ran] { ran = true; });
+  jobSystem.wait(group);
+  REQUIRE(ran);
+  jobSystem.cleanup();
+}
@@ -114,3 +114,28 @@ TEST_CASE("linear buffer manager basic alloc aligned", "[memory]") {
   REQUIRE(range.m_offset == 320);
   REQUIRE(range.m_size == 256);
 }
+
+TEST_CASE("linear buffer manager reuse keeps other handles", "[memory]") {
+  SirMetal::LinearBufferManager alloc(2 * SirMetal::MB_TO_BYTE);
+  auto first = alloc.allocate(64, 1);
+  auto second = alloc.allocate(128, 1);
+  alloc.free(second);
+  // the reused range goes back to the slot of second, first is untouched
+  auto reused = alloc.allocate(100, 1);
+  REQUIRE(alloc.getBufferRange(first).m_offset == 0);
+  REQUIRE(alloc.getBufferRange(first).m_size == 64);
+  REQUIRE(alloc.getBufferRange(reused).m_offset == 64);
+  REQUIRE(alloc.getBufferRange(reused).m_size == 100);
+}
+
+TEST_CASE("linear buffer manager reuse honors alignment", "[memory]") {
+  SirMetal::LinearBufferManager alloc(2 * SirMetal::MB_TO_BYTE);
+  alloc.allocate(10, 1);
+  auto handle = alloc.allocate(200, 1);
+  alloc.allocate(10, 1);
+  alloc.free(handle);
+  auto aligned = alloc.allocate(64, 64);
+  auto range = alloc.getBufferRange(aligned);
+  REQUIRE(range.m_offset == 64);
+  REQUIRE(range.m_size == 64);
+}
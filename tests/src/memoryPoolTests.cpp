@@ -56,3 +56,38 @@ TEST_CASE("MemoryPool mixed deletion and addition", "[memory]") {
     REQUIRE(idx == indices[5 - i - 1]);
   }
 }
+
+TEST_CASE("MemoryPool hands out fresh slots after the freed ones", "[memory]") {
+
+  SirMetal::SparseMemoryPool<DummyAlloc> pool(20);
+  uint32_t idx;
+  for (uint32_t i = 0; i < 4; ++i) { pool.getFreeMemoryData(idx); }
+  REQUIRE(pool.getHighWaterMark() == 4);
+  pool.free(2);
+  DummyAlloc &fresh = pool.getFreeMemoryData(idx);
+  REQUIRE(idx == 2);
+  REQUIRE(pool.getHighWaterMark() == 4);
+  // the freed list is empty, next one comes from the mark and is constructed
+  DummyAlloc &next = pool.getFreeMemoryData(idx);
+  REQUIRE(idx == 4);
+  REQUIRE(next.value == 0xBADDCAFE);
+  REQUIRE(pool.getHighWaterMark() == 5);
+  (void)fresh;
+}
+
+TEST_CASE("MemoryPool clear", "[memory]") {
+
+  SirMetal::SparseMemoryPool<DummyAlloc> pool(20);
+  uint32_t idx;
+  for (uint32_t i = 0; i < 20; ++i) { pool.getFreeMemoryData(idx); }
+  pool.free(7);
+  pool.free(3);
+  pool.clear();
+  REQUIRE(pool.getAllocatedCount() == 0);
+  REQUIRE(pool.getHighWaterMark() == 0);
+  // the freed list is gone as well, slots come back in order
+  for (uint32_t i = 0; i < 20; ++i) {
+    pool.getFreeMemoryData(idx);
+    REQUIRE(idx == i);
+  }
+}
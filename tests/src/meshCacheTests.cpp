@@ -0,0 +1,103 @@
+#include "SirMetal/io/mappedFile.h"
+#include "SirMetal/resources/meshes/meshCache.h"
+#include "SirMetal/resources/meshes/vertexStreams.h"
+#include "catch/catch.h"
+#include <filesystem>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+SirMetal::MeshLoadResult makeMesh(const uint32_t vertexCount) {
+  SirMetal::MeshLoadResult mesh;
+  mesh.name = "quad";
+  mesh.vertices.resize(SirMetal::computeVertexBlobLayout(vertexCount, 4, mesh.ranges));
+  for (uint32_t i = 0; i < mesh.vertices.size(); ++i) { mesh.vertices[i] = static_cast<float>(i); }
+  for (uint32_t i = 0; i < vertexCount * 3; ++i) { mesh.indices.push_back(i % vertexCount); }
+  for (uint32_t i = 0; i < 6; ++i) { mesh.m_boundingBox[i] = static_cast<float>(i) - 3.0f; }
+  return mesh;
+}
+} // namespace
+
+TEST_CASE("Mesh cache round trip", "[resources]") {
+  const std::string folder =
+          (std::filesystem::temp_directory_path() / "sirMetalMeshCacheTests").string();
+  std::filesystem::remove_all(folder);
+  static constexpr uint64_t KEY = 0x0123456789abcdefull;
+  const std::string path = SirMetal::getMeshCachePath(folder, KEY);
+  REQUIRE(path == folder + "/0123456789abcdef.smesh");
+
+  SirMetal::CachedMesh cached;
+  REQUIRE_FALSE(cached.open(path.c_str(), KEY));
+  REQUIRE_FALSE(cached.isOpen());
+
+  // the folder is created on write
+  const SirMetal::MeshLoadResult mesh = makeMesh(100);
+  REQUIRE(SirMetal::writeMeshCache(path.c_str(), KEY, mesh));
+  REQUIRE(cached.open(path.c_str(), KEY));
+  REQUIRE(cached.getName() == "quad");
+  REQUIRE(cached.getVertexSizeInBytes() == mesh.vertices.size() * sizeof(float));
+  REQUIRE(memcmp(cached.getVertices(), mesh.vertices.data(), cached.getVertexSizeInBytes()) == 0);
+  REQUIRE(reinterpret_cast<uintptr_t>(cached.getVertices()) %
+                  SirMetal::VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES ==
+          0);
+  REQUIRE(cached.getIndexCount() == mesh.indices.size());
+  REQUIRE(memcmp(cached.getIndices(), mesh.indices.data(), mesh.indices.size() * 4) == 0);
+  REQUIRE(memcmp(cached.getRanges(), mesh.ranges, sizeof(mesh.ranges)) == 0);
+  REQUIRE(cached.getBoundingBox()[5] == 2.0f);
+
+  // moving keeps the mapping
+  SirMetal::CachedMesh moved(std::move(cached));
+  REQUIRE_FALSE(cached.isOpen());
+  REQUIRE(moved.isOpen());
+  REQUIRE(moved.getIndices()[1] == 1);
+
+  // the mapping outlives a rewrite of the file
+  const SirMetal::MeshLoadResult other = makeMesh(10);
+  REQUIRE(SirMetal::writeMeshCache(path.c_str(), KEY, other));
+  REQUIRE(moved.getIndexCount() == mesh.indices.size());
+  REQUIRE(cached.open(path.c_str(), KEY));
+  REQUIRE(cached.getIndexCount() == other.indices.size());
+  moved.close();
+  cached.close();
+
+  // another key, a file named after a key holds that key only
+  REQUIRE_FALSE(cached.open(path.c_str(), KEY + 1));
+  std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("Mesh cache rejects stale and truncated files", "[resources]") {
+  const std::string folder =
+          (std::filesystem::temp_directory_path() / "sirMetalMeshCacheStaleTests").string();
+  std::filesystem::remove_all(folder);
+  const std::string path = SirMetal::getMeshCachePath(folder, 7);
+  REQUIRE(SirMetal::writeMeshCache(path.c_str(), 7, makeMesh(64)));
+  const auto fullSize = std::filesystem::file_size(path);
+
+  // an old version
+  SirMetal::MeshCacheHeader header{};
+  FILE *file = fopen(path.c_str(), "r+b");
+  REQUIRE(fread(&header, sizeof(header), 1, file) == 1);
+  header.version = SirMetal::MESH_CACHE_VERSION + 1;
+  fseek(file, 0, SEEK_SET);
+  fwrite(&header, sizeof(header), 1, file);
+  fclose(file);
+  SirMetal::CachedMesh cached;
+  REQUIRE_FALSE(cached.open(path.c_str(), 7));
+
+  // cut in the index buffer
+  REQUIRE(SirMetal::writeMeshCache(path.c_str(), 7, makeMesh(64)));
+  std::filesystem::resize_file(path, fullSize - 4);
+  REQUIRE_FALSE(cached.open(path.c_str(), 7));
+  // shorter than the header
+  std::filesystem::resize_file(path, 16);
+  REQUIRE_FALSE(cached.open(path.c_str(), 7));
+
+  // empty files map to nothing
+  std::filesystem::resize_file(path, 0);
+  SirMetal::MappedFile mapped;
+  REQUIRE(mapped.open(path.c_str()));
+  REQUIRE(mapped.getSize() == 0);
+  REQUIRE(mapped.getData() == nullptr);
+  REQUIRE_FALSE(cached.open(path.c_str(), 7));
+  std::filesystem::remove_all(folder);
+}
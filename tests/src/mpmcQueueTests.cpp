@@ -0,0 +1,93 @@
+#include "SirMetal/core/memory/cpu/mpmcQueue.h"
+#include "catch/catch.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Mpmc queue push pop", "[memory]") {
+  SirMetal::MpmcQueue<uint32_t> queue(3);
+  REQUIRE(queue.capacity() == 4);
+  uint32_t value = 0;
+  REQUIRE_FALSE(queue.pop(value));
+  for (uint32_t i = 0; i < 4; ++i) { REQUIRE(queue.push(i)); }
+  REQUIRE_FALSE(queue.push(4));
+  REQUIRE(queue.sizeApprox() == 4);
+  for (uint32_t i = 0; i < 20; ++i) {
+    REQUIRE(queue.pop(value));
+    REQUIRE(value == i);
+    REQUIRE(queue.push(i + 4));
+  }
+}
+
+TEST_CASE("Mpmc queue batch", "[memory]") {
+  SirMetal::MpmcQueue<uint32_t> queue(8);
+  const uint32_t values[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  REQUIRE(queue.pushBatch(values, 5) == 5);
+  REQUIRE(queue.pushBatch(values + 5, 7) == 3);
+  REQUIRE(queue.pushBatch(values, 1) == 0);
+  uint32_t out[12] = {};
+  REQUIRE(queue.popBatch(out, 6) == 6);
+  REQUIRE(queue.pushBatch(values + 8, 4) == 4);
+  REQUIRE(queue.popBatch(out + 6, 12) == 6);
+  bool ordered = true;
+  for (uint32_t i = 0; i < 12; ++i) { ordered &= out[i] == i; }
+  REQUIRE(ordered);
+  REQUIRE(queue.popBatch(out, 12) == 0);
+}
+
+TEST_CASE("Mpmc queue empty batch", "[memory]") {
+  SirMetal::MpmcQueue<uint32_t> queue(4);
+  const uint32_t values[4] = {0, 1, 2, 3};
+  uint32_t out[4] = {};
+  // an empty batch returns right away, on an empty, a half and a full queue
+  REQUIRE(queue.pushBatch(values, 0) == 0);
+  REQUIRE(queue.popBatch(out, 0) == 0);
+  REQUIRE(queue.pushBatch(values, 2) == 2);
+  REQUIRE(queue.pushBatch(values, 0) == 0);
+  REQUIRE(queue.popBatch(out, 0) == 0);
+  REQUIRE(queue.pushBatch(values + 2, 2) == 2);
+  REQUIRE(queue.pushBatch(values, 0) == 0);
+  REQUIRE(queue.popBatch(out, 0) == 0);
+  REQUIRE(queue.sizeApprox() == 4);
+  REQUIRE(queue.popBatch(out, 4) == 4);
+  REQUIRE(out[3] == 3);
+}
+
+TEST_CASE("Mpmc queue many producers and consumers", "[memory]") {
+  static constexpr uint32_t THREADS = 4;
+  static constexpr uint32_t PER_THREAD = 50000;
+  SirMetal::MpmcQueue<uint32_t> queue(128);
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint32_t> popped{0};
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&queue, t] {
+      uint32_t batch[8];
+      for (uint32_t i = 0; i < PER_THREAD;) {
+        const uint32_t value = t * PER_THREAD + i + 1;
+        if ((t & 1) == 0) {
+          if (queue.push(value)) { ++i; }
+        } else {
+          const uint32_t count = PER_THREAD - i < 8 ? PER_THREAD - i : 8;
+          for (uint32_t b = 0; b < count; ++b) { batch[b] = value + b; }
+          i += queue.pushBatch(batch, count);
+        }
+        std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&queue, &sum, &popped, t] {
+      uint32_t out[8];
+      while (popped.load() < THREADS * PER_THREAD) {
+        const uint32_t count = (t & 1) == 0 ? queue.popBatch(out, 8) : queue.pop(out[0]);
+        for (uint32_t i = 0; i < count; ++i) { sum += out[i]; }
+        popped += count;
+        if (count == 0) { std::this_thread::yield(); }
+      }
+    });
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+  const uint64_t total = static_cast<uint64_t>(THREADS) * PER_THREAD;
+  REQUIRE(popped.load() == total);
+  // every value 1..total exactly once
+  REQUIRE(sum.load() == total * (total + 1) / 2);
+}
@@ -0,0 +1,104 @@
+#include "SirMetal/core/memory/cpu/offsetAllocator.h"
+#include "catch/catch.h"
+#include <vector>
+
+TEST_CASE("Offset allocator size bins", "[memory]") {
+  using namespace SirMetal::offsetAllocator;
+  // small sizes are their own bin
+  for (uint32_t size = 0; size < 8; ++size) {
+    REQUIRE(sizeToBinRoundUp(size) == size);
+    REQUIRE(sizeToBinRoundDown(size) == size);
+  }
+  // every size sits between its bins, and round up is the next bin
+  bool valid = true;
+  for (uint32_t size = 8; size < 100000; size += 7) {
+    const uint32_t down = sizeToBinRoundDown(size);
+    const uint32_t up = sizeToBinRoundUp(size);
+    valid &= binToSize(down) <= size;
+    valid &= binToSize(up) >= size;
+    valid &= (up == down) == (binToSize(down) == size);
+    valid &= (up == down) || (up == down + 1);
+  }
+  REQUIRE(valid);
+  REQUIRE(sizeToBinRoundUp(0xFFFFFFFF) < LEAF_BIN_COUNT);
+}
+
+TEST_CASE("Offset allocator basic alloc", "[memory]") {
+  SirMetal::OffsetAllocator alloc(1024 * 1024);
+  auto a = alloc.allocate(100, 1);
+  auto b = alloc.allocate(200, 1);
+  REQUIRE(a.isHandleValid());
+  REQUIRE(b.isHandleValid());
+  REQUIRE(alloc.getBufferRange(a).m_offset == 0);
+  REQUIRE(alloc.getBufferRange(a).m_size == 100);
+  REQUIRE(alloc.getBufferRange(b).m_offset == 100);
+  REQUIRE(alloc.getAllocationsCount() == 2);
+  REQUIRE(alloc.getFreeBytes() == 1024 * 1024 - 300);
+  REQUIRE(alloc.getFreeRegionsCount() == 1);
+}
+
+TEST_CASE("Offset allocator alignment", "[memory]") {
+  SirMetal::OffsetAllocator alloc(1024 * 1024);
+  alloc.allocate(61, 1);
+  auto handle = alloc.allocate(128, 256);
+  REQUIRE(alloc.getBufferRange(handle).m_offset == 256);
+  REQUIRE(alloc.getBufferRange(handle).m_size == 128);
+  handle = alloc.allocate(17, 64);
+  REQUIRE(alloc.getBufferRange(handle).m_offset == 384);
+}
+
+TEST_CASE("Offset allocator merges neighbours", "[memory]") {
+  SirMetal::OffsetAllocator alloc(4096);
+  std::vector<SirMetal::BufferRangeHandle> handles;
+  for (uint32_t i = 0; i < 8; ++i) { handles.push_back(alloc.allocate(512, 1)); }
+  REQUIRE(alloc.getFreeBytes() == 0);
+  REQUIRE_FALSE(alloc.allocate(1, 1).isHandleValid());
+
+  // holes not next to each other stay apart
+  alloc.free(handles[1]);
+  alloc.free(handles[3]);
+  REQUIRE(alloc.getFreeRegionsCount() == 2);
+  REQUIRE_FALSE(alloc.canAllocate(1024));
+  // freeing the one in the middle makes a single 1536 bytes region
+  alloc.free(handles[2]);
+  REQUIRE(alloc.getFreeRegionsCount() == 1);
+  REQUIRE(alloc.canAllocate(1536));
+  auto big = alloc.allocate(1536, 1);
+  REQUIRE(big.isHandleValid());
+  REQUIRE(alloc.getBufferRange(big).m_offset == 512);
+
+  // everything back is the whole buffer again
+  alloc.free(big);
+  for (const uint32_t i : {0u, 4u, 5u, 6u, 7u}) { alloc.free(handles[i]); }
+  REQUIRE(alloc.getAllocationsCount() == 0);
+  REQUIRE(alloc.getFreeRegionsCount() == 1);
+  REQUIRE(alloc.getFreeBytes() == 4096);
+  REQUIRE(alloc.getBufferRange(alloc.allocate(4096, 1)).m_offset == 0);
+}
+
+TEST_CASE("Offset allocator more than 65k live ranges", "[memory]") {
+  const uint32_t count = 100000;
+  SirMetal::OffsetAllocator alloc(count * 16, count + 1);
+  std::vector<SirMetal::BufferRangeHandle> handles(count);
+  bool valid = true;
+  for (uint32_t i = 0; i < count; ++i) {
+    handles[i] = alloc.allocate(16, 16);
+    valid &= handles[i].isHandleValid();
+  }
+  REQUIRE(valid);
+  REQUIRE(alloc.getBufferRange(handles[count - 1]).m_offset == (count - 1) * 16);
+  for (uint32_t i = 0; i < count; i += 2) { alloc.free(handles[i]); }
+  for (uint32_t i = 1; i < count; i += 2) { alloc.free(handles[i]); }
+  REQUIRE(alloc.getFreeRegionsCount() == 1);
+  REQUIRE(alloc.getFreeBytes() == count * 16);
+}
+
+TEST_CASE("Offset allocator clear", "[memory]") {
+  SirMetal::OffsetAllocator alloc(4096, 16);
+  for (uint32_t i = 0; i < 8; ++i) { alloc.allocate(100, 1); }
+  alloc.clear();
+  REQUIRE(alloc.getAllocationsCount() == 0);
+  REQUIRE(alloc.getFreeBytes() == 4096);
+  REQUIRE(alloc.getLargestFreeRegion() == 4096);
+  REQUIRE(alloc.getBufferRange(alloc.allocate(64, 1)).m_offset == 0);
+}
@@ -1,5 +1,7 @@
 #include "SirMetal/core/memory/cpu/randomSizeAllocator.h"
 #include "catch/catch.h"
+#include <string.h>
+#include <vector>
 
 TEST_CASE("Random size allocator simple allocation", "[memory]") {
 
@@ -45,39 +47,110 @@ TEST_CASE("Random size allocator multiple allocations", "[memory]") {
   REQUIRE(newMem2.allocSize == 24);
   REQUIRE(newMem2.dataSize == 12);
 
-  // do a couple more de-alloc
+  // do a couple more de-alloc, adjacent free blocks get merged
   char *mem3ptr = alloc.getPointer(mem3);
   alloc.freeAllocation(mem3);
   REQUIRE(alloc.getStartPtr() + (112) == alloc.getUnfragmentedPtr());
-  char *mem5ptr = alloc.getPointer(mem5);
   alloc.freeAllocation(mem5);
   REQUIRE(alloc.getStartPtr() + (112) == alloc.getUnfragmentedPtr());
-  char *mem4ptr = alloc.getPointer(mem4);
+  REQUIRE(alloc.getFreeBlocksCount() == 2);
+  // mem4 sits between mem3 and mem5, the three become one block
   alloc.freeAllocation(mem4);
   REQUIRE(alloc.getStartPtr() + (112) == alloc.getUnfragmentedPtr());
+  REQUIRE(alloc.getFreeBlocksCount() == 1);
+  REQUIRE(alloc.getLargestFreeBlock() == 72);
 
-  REQUIRE(alloc.getFreeBlocksCount() == 3);
+  // the merged block gets split
   SirMetal::RandomSizeAllocationHandle newMem3 = alloc.allocate(18);
   REQUIRE(alloc.getPointer(newMem3) == mem3ptr);
-  REQUIRE(alloc.getFreeBlocksCount() == 2);
+  REQUIRE(alloc.getFreeBlocksCount() == 1);
   REQUIRE(alloc.getStartPtr() + (112) == alloc.getUnfragmentedPtr());
-  REQUIRE(newMem3.allocSize == 48);
-  REQUIRE(newMem3.dataSize== 18);
+  REQUIRE(newMem3.allocSize == 18);
+  REQUIRE(newMem3.dataSize == 18);
+  REQUIRE(alloc.getFreeBytes() == 54);
 
-  SirMetal::RandomSizeAllocationHandle newMem5 = alloc.allocate(16);
-  REQUIRE(alloc.getPointer(newMem5) == mem5ptr);
+  // a left over smaller than the split threshold is handed out with the block
+  SirMetal::RandomSizeAllocationHandle newMem5 = alloc.allocate(30);
+  REQUIRE(alloc.getPointer(newMem5) == mem3ptr + 18);
   REQUIRE(alloc.getFreeBlocksCount() == 1);
+  SirMetal::RandomSizeAllocationHandle newMem4 = alloc.allocate(12);
+  REQUIRE(alloc.getPointer(newMem4) == mem3ptr + 48);
+  REQUIRE(newMem4.allocSize == 24);
+  REQUIRE(newMem4.dataSize == 12);
+  REQUIRE(alloc.getFreeBlocksCount() == 0);
   REQUIRE(alloc.getStartPtr() + (112) == alloc.getUnfragmentedPtr());
-  REQUIRE(newMem5.allocSize == 16);
-  REQUIRE(newMem5.dataSize== 16);
+}
 
-  // now we have one slot free, but we will ask for a bigger memory alloction
-  // than the one we have, original mem4 was 8 bytes, so we should see the frag
-  // pointer move and number of free block to not decrease
-  SirMetal::RandomSizeAllocationHandle newMem4 = alloc.allocate(12);
-  REQUIRE(alloc.getPointer(newMem4) != mem4ptr);
-  REQUIRE(alloc.getFreeBlocksCount() == 1);
-  REQUIRE(alloc.getStartPtr() + (124) == alloc.getUnfragmentedPtr());
-  REQUIRE(newMem4.allocSize == 12);
-  REQUIRE(newMem4.dataSize== 12);
+TEST_CASE("Random size allocator best fit", "[memory]") {
+  SirMetal::RandomSizeAllocator alloc;
+  alloc.initialize(1024);
+  SirMetal::RandomSizeAllocationHandle big = alloc.allocate(100);
+  alloc.allocate(8);
+  SirMetal::RandomSizeAllocationHandle small = alloc.allocate(40);
+  alloc.allocate(8);
+  alloc.freeAllocation(big);
+  alloc.freeAllocation(small);
+  // first fit would take the 100 bytes block
+  SirMetal::RandomSizeAllocationHandle fit = alloc.allocate(36);
+  REQUIRE(fit.offset == small.offset);
+  REQUIRE(fit.allocSize == 40);
+  REQUIRE(alloc.getLargestFreeBlock() == 100);
+}
+
+TEST_CASE("Random size allocator 32 bits sizes", "[memory]") {
+  SirMetal::RandomSizeAllocator alloc;
+  alloc.initialize(1 << 24);
+  const uint32_t size = 3 * 1024 * 1024;
+  SirMetal::RandomSizeAllocationHandle mem = alloc.allocate(size);
+  REQUIRE(mem.allocSize == size);
+  memset(alloc.getPointer(mem), 1, size);
+  alloc.freeAllocation(mem);
+  SirMetal::RandomSizeAllocationHandle other = alloc.allocate(size - 100);
+  REQUIRE(other.offset == 0);
+  REQUIRE(other.allocSize == size - 100);
+  REQUIRE(alloc.getFreeBytes() == 100);
+}
+
+TEST_CASE("Random size allocator compaction", "[memory]") {
+  SirMetal::RandomSizeAllocator alloc;
+  alloc.initialize(1 << 20);
+  std::vector<SirMetal::RandomSizeAllocationHandle> handles;
+  for (uint32_t i = 0; i < 64; ++i) {
+    SirMetal::RandomSizeAllocationHandle handle = alloc.allocate(16 + i * 8);
+    memset(alloc.getPointer(handle), static_cast<int>(i), handle.dataSize);
+    handles.push_back(handle);
+  }
+  // freeing every third, the first one stays so the start does not move
+  uint32_t liveBytes = 0;
+  std::vector<uint32_t> liveIndices;
+  for (uint32_t i = 0; i < 64; ++i) {
+    if ((i % 3) == 1) {
+      alloc.freeAllocation(handles[i]);
+    } else {
+      liveBytes += handles[i].allocSize;
+      liveIndices.push_back(i);
+    }
+  }
+  REQUIRE(alloc.getFreeBlocksCount() > 0);
+
+  const SirMetal::RandomSizeAllocationRemap remap = alloc.compact();
+  REQUIRE(alloc.getFreeBlocksCount() == 0);
+  REQUIRE(alloc.getUnfragmentedPtr() == alloc.getStartPtr() + liveBytes);
+  REQUIRE(remap.remap(handles[0]).offset == 0);
+
+  bool intact = true;
+  uint32_t expectedOffset = 0;
+  for (const uint32_t i : liveIndices) {
+    const SirMetal::RandomSizeAllocationHandle moved = remap.remap(handles[i]);
+    intact &= moved.offset == expectedOffset;
+    intact &= moved.allocSize == handles[i].allocSize;
+    const char *ptr = alloc.getPointer(moved);
+    for (uint32_t b = 0; b < moved.dataSize; ++b) { intact &= ptr[b] == static_cast<char>(i); }
+    expectedOffset += moved.allocSize;
+  }
+  REQUIRE(intact);
+
+  // the space is contiguous again
+  SirMetal::RandomSizeAllocationHandle after = alloc.allocate(4096);
+  REQUIRE(after.offset == liveBytes);
 }
@@ -1,3 +1,4 @@
+#include "SirMetal/core/memory/cpu/containerAllocators.h"
 #include "SirMetal/core/memory/cpu/resizableVector.h"
 #include "SirMetal/core/memory/cpu/threeSizesPool.h"
 #include "catch/catch.h"
@@ -308,3 +309,65 @@ TEST_CASE("Vector remove by patching", "[memory]") {
   REQUIRE(value == 6.0f);
 
 }
+
+TEST_CASE("Vector grow in pool", "[memory]") {
+  SirMetal::ThreeSizesPool pool(1 << 20);
+  SirMetal::ResizableVector<uint32_t> vec(4, &pool);
+  for (uint32_t i = 0; i < 1000; ++i) {
+    vec.pushBack(i);
+  }
+  REQUIRE(vec.size() == 1000);
+  REQUIRE(pool.allocationInPool(vec.data()));
+  for (uint32_t i = 0; i < 1000; ++i) {
+    REQUIRE(vec[i] == i);
+  }
+}
+
+TEST_CASE("Vector in frame memory", "[memory]") {
+  SirMetal::StackAllocator stack;
+  stack.initialize(1 << 16);
+  SirMetal::StackAllocatorAdapter frame(&stack);
+  {
+    SirMetal::ResizableVector<float, SirMetal::StackAllocatorAdapter> vec(8, &frame);
+    for (int i = 0; i < 100; ++i) {
+      vec.pushBack(static_cast<float>(i));
+    }
+    REQUIRE(vec.size() == 100);
+    REQUIRE(vec[99] == 99.0f);
+    REQUIRE(vec.data() >= stack.getStartPtr());
+    REQUIRE(vec.data() < stack.getEndPtr());
+  }
+  // odd sizes do not misalign the next block
+  frame.allocate(3);
+  void *next = frame.allocate(8);
+  REQUIRE(reinterpret_cast<uintptr_t>(next) % alignof(max_align_t) == 0);
+  // neither does a budget on top of it
+  SirMetal::BudgetAllocator<SirMetal::StackAllocatorAdapter> budget(&frame, "frame", 1024);
+  budget.allocate(3);
+  REQUIRE(reinterpret_cast<uintptr_t>(budget.allocate(8)) % alignof(max_align_t) == 0);
+  stack.reset();
+  REQUIRE(stack.getStackPtr() == stack.getStartPtr());
+}
+
+TEST_CASE("Vector budget tracking", "[memory]") {
+  SirMetal::ThreeSizesPool pool(1 << 20);
+  SirMetal::BudgetAllocator<SirMetal::ThreeSizesPool> budget(&pool, "test", 1024);
+  {
+    SirMetal::ResizableVector<uint32_t, SirMetal::BudgetAllocator<SirMetal::ThreeSizesPool>>
+        vec(16, &budget);
+    REQUIRE(budget.getUsedBytes() == 16 * sizeof(uint32_t));
+    REQUIRE(budget.getAllocationCount() == 1);
+    for (uint32_t i = 0; i < 17; ++i) {
+      vec.pushBack(i);
+    }
+    REQUIRE(budget.getUsedBytes() == 32 * sizeof(uint32_t));
+    REQUIRE(budget.getAllocationCount() == 1);
+    REQUIRE(budget.hasGoneOverBudget() == false);
+    vec.resize(1000);
+    REQUIRE(budget.hasGoneOverBudget() == true);
+  }
+  REQUIRE(budget.getUsedBytes() == 0);
+  REQUIRE(budget.getAllocationCount() == 0);
+  // old and new buffers are both alive while resizing
+  REQUIRE(budget.getPeakBytes() == (2000 + 32) * sizeof(uint32_t));
+}
@@ -0,0 +1,102 @@
+#include "SirMetal/core/memory/cpu/slotMap.h"
+#include "catch/catch.h"
+#include <string>
+
+using SirMetal::getGenerationFromHandle;
+using SirMetal::getIndexFromHandle;
+using SirMetal::getTypeFromHandle;
+using SirMetal::HANDLE_TYPE;
+using SirMetal::MeshHandle;
+using SirMetal::TextureHandle;
+
+TEST_CASE("slot map insert get", "[memory]") {
+  SirMetal::SlotMap<uint32_t, TextureHandle> map;
+  TextureHandle a = map.insert(10);
+  TextureHandle b = map.insert(20);
+  REQUIRE(a.isHandleValid());
+  REQUIRE(b.isHandleValid());
+  REQUIRE(getTypeFromHandle(a) == HANDLE_TYPE::TEXTURE);
+  REQUIRE(getIndexFromHandle(a) != getIndexFromHandle(b));
+  REQUIRE(map.size() == 2);
+  REQUIRE(*map.get(a) == 10);
+  REQUIRE(*map.get(b) == 20);
+  *map.get(a) = 11;
+  REQUIRE(*map.get(a) == 11);
+}
+
+TEST_CASE("slot map invalid handle", "[memory]") {
+  SirMetal::SlotMap<uint32_t, TextureHandle> map;
+  REQUIRE(map.get(TextureHandle{}) == nullptr);
+  map.insert(1);
+  REQUIRE(map.get(TextureHandle{}) == nullptr);
+  // index never handed out
+  REQUIRE(map.get(SirMetal::getHandle<TextureHandle>(100)) == nullptr);
+  REQUIRE_FALSE(map.remove(TextureHandle{}));
+}
+
+TEST_CASE("slot map stale handle", "[memory]") {
+  SirMetal::SlotMap<uint32_t, TextureHandle> map;
+  TextureHandle a = map.insert(10);
+  REQUIRE(map.remove(a));
+  REQUIRE(map.size() == 0);
+  REQUIRE(map.get(a) == nullptr);
+  REQUIRE_FALSE(map.isValid(a));
+  REQUIRE_FALSE(map.remove(a));
+
+  // slot gets reused with a new generation, the old handle stays stale
+  TextureHandle b = map.insert(30);
+  REQUIRE(getIndexFromHandle(b) == getIndexFromHandle(a));
+  REQUIRE(getGenerationFromHandle(b) != getGenerationFromHandle(a));
+  REQUIRE(map.slotCount() == 1);
+  REQUIRE(map.get(a) == nullptr);
+  REQUIRE(*map.get(b) == 30);
+}
+
+TEST_CASE("slot map generation wraps", "[memory]") {
+  SirMetal::SlotMap<uint32_t, MeshHandle> map;
+  MeshHandle first = map.insert(0);
+  MeshHandle h = first;
+  const uint32_t reuses = SirMetal::HANDLE_GENERATION_MASK + 1;
+  for (uint32_t i = 0; i < reuses; ++i) {
+    REQUIRE(map.remove(h));
+    h = map.insert(i + 1);
+    REQUIRE(h.isHandleValid());
+    REQUIRE(getTypeFromHandle(h) == HANDLE_TYPE::MESH);
+  }
+  // after a full cycle the generation is back where it started
+  REQUIRE(h.handle == first.handle);
+  REQUIRE(*map.get(h) == reuses);
+}
+
+TEST_CASE("slot map releases removed values", "[memory]") {
+  SirMetal::SlotMap<std::string, TextureHandle> map;
+  TextureHandle a = map.insert(std::string(64, 'a'));
+  TextureHandle b = map.insert(std::string("b"));
+  REQUIRE(*map.get(a) == std::string(64, 'a'));
+  map.remove(a);
+  TextureHandle c = map.insert(std::string("c"));
+  REQUIRE(*map.get(c) == "c");
+  REQUIRE(*map.get(b) == "b");
+}
+
+TEST_CASE("slot map for each and clear", "[memory]") {
+  SirMetal::SlotMap<uint32_t, TextureHandle> map;
+  TextureHandle handles[100];
+  for (uint32_t i = 0; i < 100; ++i) { handles[i] = map.insert(i); }
+  for (uint32_t i = 0; i < 100; i += 2) { map.remove(handles[i]); }
+  REQUIRE(map.size() == 50);
+
+  uint32_t count = 0;
+  uint32_t sum = 0;
+  map.forEach([&](TextureHandle handle, uint32_t &value) {
+    REQUIRE(map.get(handle) == &value);
+    ++count;
+    sum += value;
+  });
+  REQUIRE(count == 50);
+  REQUIRE(sum == 2500);
+
+  map.clear();
+  REQUIRE(map.size() == 0);
+  for (auto handle : handles) { REQUIRE(map.get(handle) == nullptr); }
+}
@@ -0,0 +1,79 @@
+#include "SirMetal/core/memory/cpu/spscQueue.h"
+#include "catch/catch.h"
+#include <memory>
+#include <thread>
+
+TEST_CASE("Spsc queue capacity is a power of two", "[memory]") {
+  SirMetal::SpscQueue<uint32_t> queue(100);
+  REQUIRE(queue.capacity() == 128);
+  SirMetal::SpscQueue<uint32_t> exact(64);
+  REQUIRE(exact.capacity() == 64);
+}
+
+TEST_CASE("Spsc queue push pop", "[memory]") {
+  SirMetal::SpscQueue<uint32_t> queue(4);
+  uint32_t value = 0;
+  REQUIRE_FALSE(queue.pop(value));
+  for (uint32_t i = 0; i < 4; ++i) { REQUIRE(queue.push(i)); }
+  REQUIRE_FALSE(queue.push(4));
+  REQUIRE(queue.sizeApprox() == 4);
+  // wrapping around a few times
+  for (uint32_t i = 0; i < 20; ++i) {
+    REQUIRE(queue.pop(value));
+    REQUIRE(value == i);
+    REQUIRE(queue.push(i + 4));
+  }
+}
+
+TEST_CASE("Spsc queue batch", "[memory]") {
+  SirMetal::SpscQueue<uint32_t> queue(8);
+  const uint32_t values[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  REQUIRE(queue.pushBatch(values, 5) == 5);
+  // only what fits goes in
+  REQUIRE(queue.pushBatch(values + 5, 7) == 3);
+  uint32_t out[12] = {};
+  REQUIRE(queue.popBatch(out, 6) == 6);
+  REQUIRE(queue.pushBatch(values + 8, 4) == 4);
+  REQUIRE(queue.popBatch(out + 6, 12) == 6);
+  bool ordered = true;
+  for (uint32_t i = 0; i < 12; ++i) { ordered &= out[i] == i; }
+  REQUIRE(ordered);
+  REQUIRE(queue.popBatch(out, 12) == 0);
+}
+
+TEST_CASE("Spsc queue moves values", "[memory]") {
+  SirMetal::SpscQueue<std::unique_ptr<uint32_t>> queue(2);
+  REQUIRE(queue.push(std::make_unique<uint32_t>(7)));
+  std::unique_ptr<uint32_t> out;
+  REQUIRE(queue.pop(out));
+  REQUIRE(*out == 7);
+}
+
+TEST_CASE("Spsc queue producer consumer threads", "[memory]") {
+  static constexpr uint32_t COUNT = 200000;
+  SirMetal::SpscQueue<uint32_t> queue(64);
+  std::thread producer([&queue] {
+    uint32_t batch[16];
+    for (uint32_t i = 0; i < COUNT;) {
+      if ((i & 1) == 0) {
+        if (queue.push(i)) { ++i; }
+      } else {
+        const uint32_t count = COUNT - i < 16 ? COUNT - i : 16;
+        for (uint32_t b = 0; b < count; ++b) { batch[b] = i + b; }
+        i += queue.pushBatch(batch, count);
+      }
+      std::this_thread::yield();
+    }
+  });
+  bool ordered = true;
+  uint32_t expected = 0;
+  uint32_t out[16];
+  while (expected < COUNT) {
+    const uint32_t popped = queue.popBatch(out, 16);
+    for (uint32_t i = 0; i < popped; ++i) { ordered &= out[i] == expected++; }
+    if (popped == 0) { std::this_thread::yield(); }
+  }
+  producer.join();
+  REQUIRE(ordered);
+  REQUIRE(queue.isEmptyApprox());
+}
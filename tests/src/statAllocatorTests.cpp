@@ -1,3 +1,4 @@
+#include "SirMetal/core/memory/cpu/frameAllocator.h"
 #include "SirMetal/core/memory/cpu/stackAllocator.h"
 #include "catch/catch.h"
 
@@ -42,3 +43,86 @@ TEST_CASE("StackAllocator  multiple alloc/free", "[memory]") {
   mem = alloc.free(8);
   REQUIRE(mem == alloc.getStartPtr());
 }
+
+TEST_CASE("StackAllocator aligned allocation", "[memory]") {
+  SirMetal::StackAllocator alloc;
+  alloc.initialize(256);
+  alloc.allocate(3);
+  void *mem = alloc.allocate(16, 16);
+  REQUIRE(reinterpret_cast<uintptr_t>(mem) % 16 == 0);
+  REQUIRE(alloc.getStackPtr() == (static_cast<char *>(mem) + 16));
+  auto *doubles = alloc.allocateArray<double>(4);
+  REQUIRE(reinterpret_cast<uintptr_t>(doubles) % alignof(double) == 0);
+}
+
+TEST_CASE("StackAllocator fill to the end", "[memory]") {
+  SirMetal::StackAllocator alloc;
+  alloc.initialize(64);
+  alloc.allocate(64);
+  REQUIRE(alloc.getUsedBytes() == 64);
+  alloc.reset();
+  REQUIRE(alloc.getUsedBytes() == 0);
+}
+
+TEST_CASE("StackAllocator marker", "[memory]") {
+  SirMetal::StackAllocator alloc;
+  alloc.initialize(256);
+  alloc.allocate(16);
+  const SirMetal::StackAllocator::Marker marker = alloc.getMarker();
+  alloc.allocate(32);
+  alloc.allocate(8, 8);
+  alloc.freeToMarker(marker);
+  REQUIRE(alloc.getUsedBytes() == 16);
+}
+
+TEST_CASE("StackAllocator nested scopes", "[memory]") {
+  SirMetal::StackAllocator alloc;
+  alloc.initialize(256);
+  alloc.allocate(8);
+  {
+    SirMetal::StackAllocator::Scope outer(alloc);
+    alloc.allocate(16);
+    {
+      SirMetal::StackAllocator::Scope inner(alloc);
+      alloc.allocate(64);
+      REQUIRE(alloc.getUsedBytes() == 88);
+    }
+    REQUIRE(alloc.getUsedBytes() == 24);
+  }
+  REQUIRE(alloc.getUsedBytes() == 8);
+}
+
+TEST_CASE("StackAllocator on external memory", "[memory]") {
+  // the allocator must not free memory it does not own
+  char memory[128];
+  SirMetal::StackAllocator alloc;
+  alloc.setMemoryStartEnd(memory, memory + 128);
+  REQUIRE(alloc.allocate(32) == memory);
+}
+
+TEST_CASE("FrameAllocator keeps the frames in flight", "[memory]") {
+  SirMetal::FrameAllocator alloc;
+  alloc.initialize(100, 3);
+  REQUIRE(alloc.getSizePerFrame() == 112);
+  REQUIRE(alloc.getBufferCount() == 3);
+
+  int *frames[3];
+  for (uint64_t frame = 0; frame < 3; ++frame) {
+    alloc.newFrame(frame);
+    REQUIRE(alloc.getFrameIndex() == frame);
+    frames[frame] = alloc.allocateArray<int>(16);
+    REQUIRE(reinterpret_cast<uintptr_t>(frames[frame]) % 16 == 0);
+    for (int i = 0; i < 16; ++i) { frames[frame][i] = static_cast<int>(frame); }
+  }
+  // frames 1 and 2 may still be read, only frame 0 memory is recycled
+  alloc.newFrame(3);
+  REQUIRE(alloc.getFrameIndex() == 0);
+  REQUIRE(alloc.getCurrent().getUsedBytes() == 0);
+  int *reused = alloc.allocateArray<int>(16);
+  REQUIRE(reused == frames[0]);
+  for (int i = 0; i < 16; ++i) { reused[i] = 42; }
+  for (int i = 0; i < 16; ++i) {
+    REQUIRE(frames[1][i] == 1);
+    REQUIRE(frames[2][i] == 2);
+  }
+}
@@ -0,0 +1,141 @@
+#include "SirMetal/core/memory/cpu/stringHashMap.h"
+#include "catch/catch.h"
+#include <string>
+
+namespace {
+struct ScopedStringPool {
+  ScopedStringPool() { SirMetal::globals::STRING_POOL = new SirMetal::StringPool(2 << 20); }
+  ~ScopedStringPool() {
+    delete SirMetal::globals::STRING_POOL;
+    SirMetal::globals::STRING_POOL = nullptr;
+  }
+};
+} // namespace
+
+TEST_CASE("string hashmap insert", "[memory]") {
+  ScopedStringPool pool;
+  SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32> alloc(32);
+  alloc.insert("hello", 1);
+  alloc.insert("world", 2);
+
+  uint32_t value;
+  REQUIRE(alloc.get("hello", value) == true);
+  REQUIRE(value == 1);
+  REQUIRE(alloc.get("world", value) == true);
+  REQUIRE(value == 2);
+  REQUIRE(alloc.containsKey("missing") == false);
+  REQUIRE(alloc.getUsedBins() == 2);
+
+  // key is internalized, not the pointer we passed
+  std::string temp = "hello";
+  REQUIRE(alloc.containsKey(temp.c_str()) == true);
+  alloc.insert(temp.c_str(), 5);
+  REQUIRE(alloc.getUsedBins() == 2);
+  REQUIRE(alloc.get("hello", value) == true);
+  REQUIRE(value == 5);
+}
+
+TEST_CASE("string hashmap grow and remove", "[memory]") {
+  ScopedStringPool pool;
+  SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32> alloc(16);
+  const uint32_t count = 2000;
+  for (uint32_t i = 0; i < count; ++i) {
+    alloc.insert(std::to_string(i).c_str(), i);
+  }
+  REQUIRE(alloc.getUsedBins() == count);
+  for (uint32_t i = 0; i < count; i += 2) {
+    REQUIRE(alloc.remove(std::to_string(i).c_str()) == true);
+  }
+  REQUIRE(alloc.getUsedBins() == count / 2);
+  uint32_t value;
+  for (uint32_t i = 0; i < count; ++i) {
+    const bool found = alloc.get(std::to_string(i).c_str(), value);
+    REQUIRE(found == ((i % 2) == 1));
+    if (found) {
+      REQUIRE(value == i);
+    }
+  }
+}
+
+TEST_CASE("string hashmap churn", "[memory]") {
+  ScopedStringPool pool;
+  SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32> alloc(32);
+  const uint32_t live = 20;
+  for (uint32_t i = 0; i < 5000; ++i) {
+    alloc.insert(std::to_string(i).c_str(), i);
+    if (i >= live) {
+      REQUIRE(alloc.remove(std::to_string(i - live).c_str()) == true);
+    }
+  }
+  const auto stats = alloc.getStats();
+  REQUIRE(stats.usedBins == live);
+  REQUIRE(stats.binCount <= 64);
+  uint32_t value;
+  for (uint32_t i = 5000 - live; i < 5000; ++i) {
+    REQUIRE(alloc.get(std::to_string(i).c_str(), value) == true);
+    REQUIRE(value == i);
+  }
+}
+
+TEST_CASE("string hashmap find with precomputed hash", "[memory]") {
+  ScopedStringPool pool;
+  SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32> alloc(32);
+  const char *name = "shaders/jumpFlood.metal";
+  const uint32_t hash = SirMetal::hashString32(name);
+  alloc.insert(name, hash, 7);
+  alloc.insert("shaders/jumpMask.metal", 8);
+
+  const uint32_t *found = alloc.find(name, hash);
+  REQUIRE(found != nullptr);
+  REQUIRE(*found == 7);
+  found = alloc.find("shaders/jumpMask.metal");
+  REQUIRE(found != nullptr);
+  REQUIRE(*found == 8);
+  REQUIRE(alloc.find("shaders/missing.metal") == nullptr);
+
+  uint32_t value;
+  REQUIRE(alloc.get(name, hash, value) == true);
+  REQUIRE(value == 7);
+  // same string with a different hash cannot match
+  REQUIRE(alloc.containsKey(name, hash + 1) == false);
+
+  uint32_t *mutableValue = alloc.find(name, hash);
+  *mutableValue = 11;
+  REQUIRE(alloc.get(name, value) == true);
+  REQUIRE(value == 11);
+
+  REQUIRE(alloc.remove(name, hash) == true);
+  REQUIRE(alloc.find(name, hash) == nullptr);
+  REQUIRE(alloc.getUsedBins() == 1);
+}
+
+TEST_CASE("string hashmap get batch", "[memory]") {
+  ScopedStringPool pool;
+  SirMetal::HashMap<const char *, uint32_t, SirMetal::hashString32> alloc(16);
+  const uint32_t count = 40;
+  std::vector<std::string> names(count);
+  std::vector<const char *> keys(count);
+  std::vector<uint32_t> hashes(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    names[i] = "texture_" + std::to_string(i);
+    keys[i] = names[i].c_str();
+    hashes[i] = SirMetal::hashString32(keys[i]);
+    if (i % 3 != 0) {
+      alloc.insert(keys[i], i);
+    }
+  }
+  std::vector<uint32_t> values(count, 0);
+  bool found[count];
+  alloc.getBatch(keys.data(), values.data(), found, count);
+  for (uint32_t i = 0; i < count; ++i) {
+    REQUIRE(found[i] == (i % 3 != 0));
+    if (found[i]) {
+      REQUIRE(values[i] == i);
+    }
+  }
+  bool foundPrecomputed[count];
+  alloc.getBatch(keys.data(), values.data(), foundPrecomputed, count, hashes.data());
+  for (uint32_t i = 0; i < count; ++i) {
+    REQUIRE(foundPrecomputed[i] == found[i]);
+  }
+}
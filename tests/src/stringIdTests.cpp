@@ -0,0 +1,65 @@
+#include "SirMetal/core/hashing/stringId.h"
+#include "SirMetal/core/memory/cpu/stringPool.h"
+#include "catch/catch.h"
+#include <string.h>
+#include <string>
+
+using namespace SirMetal::literals;
+
+namespace {
+struct ScopedStringIdNames {
+  ScopedStringIdNames() { SirMetal::globals::STRING_POOL = new SirMetal::StringPool(2 << 20); }
+  ~ScopedStringIdNames() {
+    SirMetal::clearStringIdNames();
+    delete SirMetal::globals::STRING_POOL;
+    SirMetal::globals::STRING_POOL = nullptr;
+  }
+};
+} // namespace
+
+// literals need to be hashed by the compiler
+static_assert("jumpFlood"_sid.getHash() != 0);
+static_assert("jumpFlood"_sid == SirMetal::StringId("jumpFlood"));
+static_assert("jumpFlood"_sid != "jumpMask"_sid);
+static_assert(SirMetal::hashStringFnv64("") == SirMetal::FNV_OFFSET_BASIS_64);
+
+TEST_CASE("string id runtime matches compile time", "[hashing]") {
+  // built at runtime so the compiler can't fold it
+  std::string name = "jump";
+  name += "Flood";
+  constexpr SirMetal::StringId literal = "jumpFlood"_sid;
+  REQUIRE(SirMetal::StringId(name.c_str()) == literal);
+  REQUIRE(SirMetal::StringId(name.c_str(), name.size()) == literal);
+  REQUIRE(SirMetal::registerStringId(name.c_str()) == literal);
+  REQUIRE_FALSE(SirMetal::StringId().isValid());
+  REQUIRE(literal.isValid());
+}
+
+TEST_CASE("string id known fnv values", "[hashing]") {
+  // reference values of 64 bits FNV-1a
+  REQUIRE("a"_sid.getHash() == 0xaf63dc4c8601ec8cull);
+  REQUIRE("foobar"_sid.getHash() == 0x85944171f73967e8ull);
+}
+
+TEST_CASE("string id debug names", "[hashing]") {
+  ScopedStringIdNames names;
+  std::string name = "lucy";
+  const SirMetal::StringId id = SirMetal::registerStringId(name.c_str());
+  // registering again is fine
+  SirMetal::registerStringId("lucy");
+  name = "changed";
+#ifndef NDEBUG
+  REQUIRE(strcmp(id.getDebugName(), "lucy") == 0);
+  REQUIRE(strcmp("lucy"_sid.getDebugName(), "lucy") == 0);
+#endif
+  REQUIRE(strcmp("neverRegistered"_sid.getDebugName(), "<unknown>") == 0);
+  SirMetal::clearStringIdNames();
+  REQUIRE(strcmp(id.getDebugName(), "<unknown>") == 0);
+}
+
+TEST_CASE("string id without string pool", "[hashing]") {
+  // no pool, nothing gets recorded but the id is still valid
+  const SirMetal::StringId id = SirMetal::registerStringId("noPool");
+  REQUIRE(id == "noPool"_sid);
+  REQUIRE(strcmp(id.getDebugName(), "<unknown>") == 0);
+}
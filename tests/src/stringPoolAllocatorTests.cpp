@@ -125,7 +125,9 @@ TEST_CASE("String pool basic mixed alloc static", "[memory]") {
   SirMetal::StringPool alloc(2 << 16);
   const char *original = "hello world plus something";
   const char *original2 = "hello world";
-  const char *original3 = "hello world two";
+  // strings are recycled within their size class, original3 is in the class
+  // of original
+  const char *original3 = "hello world plus another";
   const char *original4 = "hello world two two";
   const char *original5 =
       "hello world plus something but much longer than anything else";
@@ -160,11 +162,13 @@ TEST_CASE("String pool basic mixed alloc static 2", "[memory]") {
   SirMetal::StringPool alloc(2 << 16);
   const wchar_t *original = L"hello world plus something";
   const wchar_t *original2 = L"hello world";
-  const wchar_t *original3 = L"hello world two";
+  // strings are recycled within their size class, original3 is in the class
+  // of original and original6 in the one of original2
+  const wchar_t *original3 = L"hello world plus another";
   const wchar_t *original4 = L"hello world two two";
   const wchar_t *original5 =
       L"hello world plus something but much longer than anything else";
-  const wchar_t *original6 = L"short";
+  const wchar_t *original6 = L"short one";
 
   const wchar_t *mem = alloc.allocatePersistent(original);
   const wchar_t *mem2 = alloc.allocatePersistent(original2);
@@ -0,0 +1,165 @@
+#include "SirMetal/core/memory/cpu/threadCachingPool.h"
+#include "catch/catch.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Thread caching pool size classes", "[memory]") {
+  using namespace SirMetal::threadCache;
+  for (uint32_t size = 1; size <= MAX_CACHED_SIZE; ++size) {
+    const uint32_t sizeClass = getSizeClass(size);
+    REQUIRE(SIZE_CLASSES[sizeClass] >= size);
+    if (sizeClass > 0) { REQUIRE(SIZE_CLASSES[sizeClass - 1] < size); }
+  }
+  REQUIRE(getSizeClassOfBlock(16) == 0);
+  REQUIRE(getSizeClassOfBlock(40) == 1);
+  REQUIRE(getSizeClassOfBlock(1024) == SIZE_CLASS_COUNT - 1);
+}
+
+TEST_CASE("Thread caching pool basic alloc", "[memory]") {
+  SirMetal::ThreadCachingPool pool(1 << 16);
+  void *mem = pool.allocate(20, 3);
+  REQUIRE(mem != nullptr);
+  REQUIRE(pool.allocationInPool(mem));
+  REQUIRE(SirMetal::ThreadCachingPool::getAllocSize(mem) == 32);
+  REQUIRE(SirMetal::ThreadCachingPool::getAllocFlags(mem) == 3);
+  REQUIRE(pool.getThreadCacheCount() == 1);
+  // the rest of the refill batch stays cached
+  REQUIRE(pool.getThreadCachedBlockCount() == SirMetal::ThreadCachingPool::REFILL_BATCH - 1);
+
+  pool.free(mem);
+  REQUIRE(pool.getThreadCachedBlockCount() == SirMetal::ThreadCachingPool::REFILL_BATCH);
+  // last freed is the first handed out
+  REQUIRE(pool.allocate(30) == mem);
+  pool.free(mem);
+
+  pool.flushThreadCache();
+  REQUIRE(pool.getThreadCachedBlockCount() == 0);
+  REQUIRE(pool.getCentralPool().getSmallAllocCount() == 0);
+}
+
+TEST_CASE("Thread caching pool big allocations skip the caches", "[memory]") {
+  SirMetal::ThreadCachingPool pool(1 << 16);
+  void *mem = pool.allocate(4000);
+  REQUIRE(SirMetal::ThreadCachingPool::getAllocSize(mem) == 4000);
+  REQUIRE(pool.getThreadCacheCount() == 0);
+  pool.free(mem);
+  REQUIRE(pool.getCentralPool().getLargeAllocCount() == 0);
+
+  void *huge = pool.allocate(1 << 20);
+  REQUIRE(pool.getCentralPool().getBypassAllocCount() == 1);
+  pool.free(huge);
+  REQUIRE(pool.getCentralPool().getBypassAllocCount() == 0);
+}
+
+TEST_CASE("Thread caching pool used with several pools from one thread", "[memory]") {
+  // more pools than the recent caches of a thread, each keeps its own cache
+  const uint32_t poolCount = 6;
+  std::vector<std::unique_ptr<SirMetal::ThreadCachingPool>> pools;
+  for (uint32_t p = 0; p < poolCount; ++p) {
+    pools.push_back(std::make_unique<SirMetal::ThreadCachingPool>(1 << 16));
+  }
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i < 100; ++i) { blocks.push_back(pools[i % poolCount]->allocate(40)); }
+  for (uint32_t i = 0; i < 100; ++i) {
+    SirMetal::ThreadCachingPool &pool = *pools[i % poolCount];
+    REQUIRE(pool.allocationInPool(blocks[i]));
+    REQUIRE_FALSE(pools[(i + 1) % poolCount]->allocationInPool(blocks[i]));
+    pool.free(blocks[i]);
+  }
+  for (const auto &pool : pools) {
+    REQUIRE(pool->getThreadCacheCount() == 1);
+    REQUIRE(pool->getThreadCachedBlockCount() == SirMetal::ThreadCachingPool::REFILL_BATCH);
+    pool->flushThreadCache();
+    REQUIRE(pool->getCentralPool().getMediumAllocCount() == 0);
+  }
+}
+
+TEST_CASE("Thread caching pool finds allocations out of the pages", "[memory]") {
+  SirMetal::ThreadCachingPool pool(1 << 12);
+  const char *literal = "not in the pool";
+  REQUIRE_FALSE(pool.allocationInPool(literal));
+  // past the central threshold, not in a page
+  void *huge = pool.allocate(1 << 14);
+  REQUIRE(pool.allocationInPool(huge));
+  REQUIRE_FALSE(pool.allocationInPool(literal));
+  // enough blocks to chain pages
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i < 200; ++i) { blocks.push_back(pool.allocate(500)); }
+  REQUIRE(pool.getCentralPool().getPageCount() > 16);
+  for (void *block : blocks) {
+    REQUIRE(pool.allocationInPool(block));
+    pool.free(block);
+  }
+  pool.free(huge);
+  REQUIRE_FALSE(pool.allocationInPool(huge));
+}
+
+TEST_CASE("Thread caching pool full magazine goes back to the central pool", "[memory]") {
+  SirMetal::ThreadCachingPool pool(1 << 16);
+  const uint32_t count = SirMetal::ThreadCachingPool::MAGAZINE_SIZE * 3;
+  std::vector<void *> blocks(count);
+  for (uint32_t i = 0; i < count; ++i) { blocks[i] = pool.allocate(64); }
+  for (uint32_t i = 0; i < count; ++i) {
+    pool.free(blocks[i]);
+    REQUIRE(pool.getThreadCachedBlockCount() <= SirMetal::ThreadCachingPool::MAGAZINE_SIZE);
+  }
+  pool.flushThreadCache();
+  REQUIRE(pool.getCentralPool().getMediumAllocCount() == 0);
+}
+
+TEST_CASE("Thread caching pool multi threaded", "[memory]") {
+  SirMetal::ThreadCachingPool pool(1 << 16);
+  const uint32_t threadCount = 8;
+  const uint32_t iterations = 20000;
+  const uint32_t liveCount = 128;
+  // blocks handed from each thread to the next one, freed over there
+  std::vector<std::vector<unsigned char *>> handoff(threadCount);
+  std::atomic<uint32_t> corrupted{0};
+
+  auto worker = [&](const uint32_t threadIndex) {
+    std::vector<unsigned char *> live(liveCount, nullptr);
+    std::vector<uint32_t> sizes(liveCount, 0);
+    uint32_t random = threadIndex * 7919 + 1;
+    for (uint32_t i = 0; i < iterations; ++i) {
+      random = random * 1664525u + 1013904223u;
+      const uint32_t slot = (random >> 8) % liveCount;
+      if (live[slot] != nullptr) {
+        const auto tag = static_cast<unsigned char>(threadIndex + slot);
+        if ((live[slot][0] != tag) | (live[slot][sizes[slot] - 1] != tag)) { ++corrupted; }
+        pool.free(live[slot]);
+      }
+      sizes[slot] = 1 + (random >> 20) % 1500;
+      live[slot] = reinterpret_cast<unsigned char *>(pool.allocate(sizes[slot]));
+      memset(live[slot], threadIndex + slot, sizes[slot]);
+      // lock free lookup while other threads add pages
+      if (!pool.allocationInPool(live[slot])) { ++corrupted; }
+    }
+    handoff[threadIndex] = live;
+    // the next threads are new ones, they only adopt this cache if they
+    // happen to get the same thread id
+    pool.flushThreadCache();
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < threadCount; ++t) { threads.emplace_back(worker, t); }
+  for (std::thread &thread : threads) { thread.join(); }
+  REQUIRE(corrupted == 0);
+  REQUIRE(pool.getThreadCacheCount() == threadCount);
+
+  // freeing on other threads than the allocating one
+  threads.clear();
+  for (uint32_t t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&, t] {
+      for (unsigned char *memory : handoff[(t + 1) % threadCount]) { pool.free(memory); }
+      pool.flushThreadCache();
+    });
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+  const SirMetal::ThreeSizesPool &central = pool.getCentralPool();
+  REQUIRE(central.getSmallAllocCount() + central.getMediumAllocCount() +
+                  central.getLargeAllocCount() + central.getBypassAllocCount() ==
+          0);
+}
@@ -0,0 +1,120 @@
+#include "SirMetal/core/memory/cpu/resizableVector.h"
+#include "SirMetal/core/memory/cpu/tlsfAllocator.h"
+#include "catch/catch.h"
+#include <random>
+#include <vector>
+
+TEST_CASE("tlsf basic alloc", "[memory]") {
+  SirMetal::TlsfAllocator alloc(1 << 16);
+  void *mem = alloc.allocate(16);
+  void *mem2 = alloc.allocate(300);
+  REQUIRE(mem != nullptr);
+  REQUIRE(mem2 != nullptr);
+  REQUIRE(mem != mem2);
+  REQUIRE(alloc.getAllocCount() == 2);
+  REQUIRE(alloc.getAllocSize(mem) >= 16);
+  REQUIRE(alloc.getAllocSize(mem2) >= 300);
+  REQUIRE(alloc.allocationInPool(mem));
+  // allocations are 8 bytes aligned
+  REQUIRE(reinterpret_cast<uintptr_t>(mem) % 8 == 0);
+  REQUIRE(reinterpret_cast<uintptr_t>(mem2) % 8 == 0);
+  memset(mem, 0xAB, 16);
+  memset(mem2, 0xCD, 300);
+  REQUIRE(static_cast<unsigned char *>(mem)[15] == 0xAB);
+  alloc.free(mem);
+  alloc.free(mem2);
+  REQUIRE(alloc.getAllocCount() == 0);
+  REQUIRE(alloc.getUsedBytes() == 0);
+}
+
+TEST_CASE("tlsf zero and tiny sizes", "[memory]") {
+  SirMetal::TlsfAllocator alloc(1 << 12);
+  void *a = alloc.allocate(0);
+  void *b = alloc.allocate(1);
+  REQUIRE(a != nullptr);
+  REQUIRE(b != nullptr);
+  REQUIRE(alloc.getAllocSize(a) >= SirMetal::TlsfAllocator::getMinAllocSize());
+  alloc.free(a);
+  alloc.free(b);
+  alloc.free(nullptr);
+  REQUIRE(alloc.getAllocCount() == 0);
+}
+
+TEST_CASE("tlsf out of memory returns null", "[memory]") {
+  SirMetal::TlsfAllocator alloc(1 << 12);
+  REQUIRE(alloc.allocate(1 << 12) == nullptr);
+  REQUIRE(alloc.allocate(0xFFFFFFFF) == nullptr);
+  std::vector<void *> live;
+  void *mem = nullptr;
+  while ((mem = alloc.allocate(100)) != nullptr) { live.push_back(mem); }
+  REQUIRE(!live.empty());
+  REQUIRE(alloc.getFreeBytes() < 128);
+  for (void *p : live) { alloc.free(p); }
+  REQUIRE(alloc.getAllocCount() == 0);
+}
+
+TEST_CASE("tlsf coalesces neighbours", "[memory]") {
+  const uint32_t poolSize = 1 << 16;
+  SirMetal::TlsfAllocator alloc(poolSize);
+  const uint32_t fullBlock = alloc.getLargestFreeBlock();
+  REQUIRE(fullBlock > poolSize - 64);
+
+  // fill the pool with small blocks and free them in an interleaved order,
+  // every free merges with whatever neighbour is already free
+  std::vector<void *> live;
+  void *mem = nullptr;
+  while ((mem = alloc.allocate(40)) != nullptr) { live.push_back(mem); }
+  REQUIRE(alloc.getLargestFreeBlock() < 40 + 8);
+  for (size_t i = 0; i < live.size(); i += 2) { alloc.free(live[i]); }
+  REQUIRE(alloc.getLargestFreeBlock() < 100);
+  // too big for any hole
+  REQUIRE(alloc.allocate(1024) == nullptr);
+  for (size_t i = 1; i < live.size(); i += 2) { alloc.free(live[i]); }
+
+  // everything went back to a single block
+  REQUIRE(alloc.getLargestFreeBlock() == fullBlock);
+  REQUIRE(alloc.allocate(fullBlock) != nullptr);
+}
+
+TEST_CASE("tlsf random churn keeps data intact", "[memory]") {
+  SirMetal::TlsfAllocator alloc(1 << 20);
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint32_t> sizeDist(1, 2000);
+  std::uniform_int_distribution<uint32_t> slotDist(0, 255);
+  std::vector<unsigned char *> live(256, nullptr);
+  std::vector<uint32_t> sizes(256, 0);
+
+  for (uint32_t i = 0; i < 20000; ++i) {
+    const uint32_t slot = slotDist(gen);
+    if (live[slot] != nullptr) {
+      // the pattern written at allocation time must still be there
+      bool intact = true;
+      for (uint32_t b = 0; b < sizes[slot]; ++b) {
+        intact &= live[slot][b] == static_cast<unsigned char>(slot);
+      }
+      REQUIRE(intact);
+      alloc.free(live[slot]);
+    }
+    sizes[slot] = sizeDist(gen);
+    live[slot] = static_cast<unsigned char *>(alloc.allocate(sizes[slot]));
+    REQUIRE(live[slot] != nullptr);
+    memset(live[slot], static_cast<int>(slot), sizes[slot]);
+  }
+  for (unsigned char *p : live) { alloc.free(p); }
+  REQUIRE(alloc.getAllocCount() == 0);
+  REQUIRE(alloc.getUsedBytes() == 0);
+  // a single block is left, the free bytes count its header
+  REQUIRE(alloc.getLargestFreeBlock() + 8 == alloc.getFreeBytes());
+}
+
+TEST_CASE("tlsf as container allocator", "[memory]") {
+  SirMetal::TlsfAllocator alloc(1 << 20);
+  {
+    SirMetal::ResizableVector<uint32_t, SirMetal::TlsfAllocator> vec(4, &alloc);
+    for (uint32_t i = 0; i < 10000; ++i) { vec.pushBack(i); }
+    REQUIRE(vec.size() == 10000);
+    REQUIRE(vec[9999] == 9999);
+    REQUIRE(alloc.getAllocCount() == 1);
+  }
+  REQUIRE(alloc.getAllocCount() == 0);
+}
@@ -1,5 +1,8 @@
+#include "SirMetal/core/memory/cpu/stringPool.h"
 #include "SirMetal/core/memory/cpu/threeSizesPool.h"
 #include "catch/catch.h"
+#include <string>
+#include <vector>
 
 TEST_CASE("Tree sizes pool basic alloc 1", "[memory]") {
   SirMetal::ThreeSizesPool alloc(2 << 16,64,256);
@@ -47,8 +50,8 @@ TEST_CASE("Tree sizes pool min alloc size", "[memory]") {
 
   uint32_t allocSize = alloc.getAllocSize(mem);
   uint32_t rawAllocSize = alloc.getRawAllocSize(mem);
-  // -4 due to the fact the header is 4 bytes
-  REQUIRE(allocSize == (minAllocSize - 4));
+  // minus the header
+  REQUIRE(allocSize == (minAllocSize - sizeof(SirMetal::ThreeSizesPool::AllocHeader)));
   REQUIRE(rawAllocSize == minAllocSize);
 }
 
@@ -160,3 +163,116 @@ TEST_CASE("Tree sizes pool delete alloc 2", "[memory]") {
   alloc.allocate(200);
   REQUIRE(alloc.getMediumAllocCount() == 5);
 }
+
+TEST_CASE("Tree sizes pool alignment", "[memory]") {
+  SirMetal::ThreeSizesPool alloc(2 << 16);
+  for (uint32_t size = 1; size < 300; size += 7) {
+    void *mem = alloc.allocate(size);
+    REQUIRE(reinterpret_cast<uintptr_t>(mem) % 8 == 0);
+    REQUIRE(alloc.getAllocSize(mem) >= size);
+  }
+}
+
+TEST_CASE("Tree sizes pool grows pages", "[memory]") {
+  const uint32_t pageSize = 4096;
+  SirMetal::ThreeSizesPool alloc(pageSize);
+  REQUIRE(alloc.getPageCount() == 1);
+  std::vector<unsigned char *> live;
+  for (uint32_t i = 0; i < 200; ++i) {
+    auto *mem = reinterpret_cast<unsigned char *>(alloc.allocate(100));
+    REQUIRE(mem != nullptr);
+    memset(mem, static_cast<int>(i), 100);
+    live.push_back(mem);
+  }
+  REQUIRE(alloc.getPageCount() > 1);
+  REQUIRE(alloc.getMediumAllocCount() == 200);
+  uint32_t allocCount = 0;
+  for (uint32_t p = 0; p < alloc.getPageCount(); ++p) {
+    const SirMetal::ThreeSizesPoolPageStats stats = alloc.getPageStats(p);
+    REQUIRE(stats.sizeInByte == pageSize);
+    REQUIRE(stats.usedBytes <= stats.highWaterMark);
+    REQUIRE(stats.highWaterMark <= pageSize);
+    allocCount += stats.allocCount;
+  }
+  REQUIRE(allocCount == 200);
+  // nothing got overwritten across pages
+  for (uint32_t i = 0; i < 200; ++i) {
+    REQUIRE(alloc.allocationInPool(live[i]));
+    REQUIRE(live[i][0] == static_cast<unsigned char>(i));
+    REQUIRE(live[i][99] == static_cast<unsigned char>(i));
+  }
+  for (unsigned char *mem : live) { alloc.free(mem); }
+  for (uint32_t p = 0; p < alloc.getPageCount(); ++p) {
+    REQUIRE(alloc.getPageStats(p).usedBytes == 0);
+    REQUIRE(alloc.getPageStats(p).allocCount == 0);
+  }
+}
+
+TEST_CASE("Tree sizes pool big allocations bypass the pages", "[memory]") {
+  SirMetal::ThreeSizesPool alloc(1 << 16);
+  REQUIRE(alloc.getLargeAllocationThreshold() == (1 << 14));
+  // over the old 1MB limit of the header
+  const uint32_t bigSize = 3 * 1024 * 1024;
+  auto *big = reinterpret_cast<unsigned char *>(alloc.allocate(bigSize));
+  REQUIRE(big != nullptr);
+  big[0] = 1;
+  big[bigSize - 1] = 2;
+  REQUIRE(alloc.getAllocSize(big) == bigSize);
+  REQUIRE(alloc.getBypassAllocCount() == 1);
+  REQUIRE(alloc.getLargeAllocCount() == 0);
+  REQUIRE(alloc.allocationInPool(big));
+  REQUIRE(alloc.getPageStats(0).highWaterMark == 0);
+
+  void *other = alloc.allocate(1 << 15);
+  REQUIRE(alloc.getBypassAllocCount() == 2);
+  alloc.free(big);
+  REQUIRE(alloc.getBypassAllocCount() == 1);
+  REQUIRE_FALSE(alloc.allocationInPool(big));
+  REQUIRE(alloc.allocationInPool(other));
+  // left alive on purpose, the pool releases it
+}
+
+TEST_CASE("Tree sizes pool finds its allocations without walking", "[memory]") {
+  // not a power of two, the pages are aligned past their size
+  SirMetal::ThreeSizesPool alloc(3000);
+  std::vector<void *> live;
+  for (uint32_t i = 0; i < 300; ++i) { live.push_back(alloc.allocate(8 + (i % 200))); }
+  for (uint32_t i = 0; i < 20; ++i) { live.push_back(alloc.allocate(2000 + i)); }
+  REQUIRE(alloc.getPageCount() > 10);
+  REQUIRE(alloc.getBypassAllocCount() == 20);
+  // freeing every other one shuffles the bypass set
+  for (uint32_t i = 0; i < live.size(); i += 2) {
+    alloc.free(live[i]);
+    live[i] = nullptr;
+  }
+
+  int onStack = 0;
+  const char *literal = "not in the pool";
+  std::vector<char> heap(64);
+  REQUIRE_FALSE(alloc.allocationInPool(&onStack));
+  REQUIRE_FALSE(alloc.allocationInPool(literal));
+  REQUIRE_FALSE(alloc.allocationInPool(heap.data()));
+  for (void *mem : live) {
+    if (mem == nullptr) { continue; }
+    REQUIRE(alloc.allocationInPool(mem));
+    // any address in a page counts, only the start of a bypass block does
+    const char *inside = static_cast<char *>(mem) + 1;
+    const int inPool = alloc.allocationInPool(inside);
+    REQUIRE(inPool == (alloc.getAllocSize(mem) <= alloc.getLargeAllocationThreshold()));
+#ifndef NDEBUG
+    REQUIRE(inPool == alloc.allocationInPoolByWalking(inside));
+#endif
+  }
+  for (void *mem : live) {
+    if (mem != nullptr) { alloc.free(mem); }
+  }
+  REQUIRE(alloc.getBypassAllocCount() == 0);
+}
+
+TEST_CASE("String pool loads big strings", "[memory]") {
+  SirMetal::StringPool pool(1 << 16);
+  std::string big(2 * 1024 * 1024, 'x');
+  const char *mem = pool.allocatePersistent(big.c_str());
+  REQUIRE(strlen(mem) == big.size());
+  pool.free(mem);
+}
@@ -0,0 +1,96 @@
+#include "SirMetal/resources/meshes/vertexStreams.h"
+#include "catch/catch.h"
+#include <vector>
+
+namespace {
+// what an interleaved gltf view looks like, position, uv and padding
+struct InterleavedVertex {
+  float position[3];
+  float uv[2];
+  float padding[3];
+};
+} // namespace
+
+TEST_CASE("Vertex blob layout", "[resources]") {
+  SirMetal::MemoryRange ranges[SirMetal::MESH_ATTRIBUTE_TYPE_COUNT];
+  const uint64_t floats = SirMetal::computeVertexBlobLayout(
+          3, SirMetal::MESH_ATTRIBUTE_TYPE_COUNT, ranges);
+  const uint32_t alignment = SirMetal::VERTEX_ATTRIBUTE_ALIGNMENT_IN_BYTES;
+  REQUIRE(ranges[0].m_offset == 0);
+  for (uint32_t i = 0; i < SirMetal::MESH_ATTRIBUTE_TYPE_COUNT; ++i) {
+    REQUIRE(ranges[i].m_offset % alignment == 0);
+    REQUIRE(ranges[i].m_size == 3 * SirMetal::MESH_ATTRIBUTE_SIZE_IN_BYTES[i]);
+  }
+  REQUIRE(ranges[1].m_offset == alignment);
+  // the last range ends the blob, no padding after it
+  REQUIRE(floats * sizeof(float) == ranges[4].m_offset + ranges[4].m_size);
+
+  // ranges bigger than the alignment
+  SirMetal::computeVertexBlobLayout(100, 4, ranges);
+  REQUIRE(ranges[1].m_offset == 1792);
+  REQUIRE(ranges[2].m_offset == 1792 * 2);
+  REQUIRE(ranges[3].m_offset == 1792 * 2 + 1024);
+}
+
+TEST_CASE("Vertex streams extraction from interleaved views", "[resources]") {
+  static constexpr uint32_t COUNT = 37;
+  std::vector<InterleavedVertex> vertices(COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    const auto value = static_cast<float>(i);
+    vertices[i] = {{value, -value, value * 0.5f}, {value + 0.25f, value + 0.75f}, {9, 9, 9}};
+  }
+
+  std::vector<float> positions(COUNT * 4, -1.0f);
+  float boundingBox[6];
+  SirMetal::extractFloat3ToFloat4(vertices[0].position, sizeof(InterleavedVertex), COUNT, 1.0f,
+                                  positions.data(), boundingBox);
+  std::vector<float> uvs(COUNT * 2, -1.0f);
+  SirMetal::extractFloat2(vertices[0].uv, sizeof(InterleavedVertex), COUNT, uvs.data());
+  bool matches = true;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    const float *position = &positions[i * 4];
+    matches &= (position[0] == vertices[i].position[0]) & (position[1] == vertices[i].position[1]) &
+               (position[2] == vertices[i].position[2]) & (position[3] == 1.0f);
+    matches &= (uvs[i * 2] == vertices[i].uv[0]) & (uvs[i * 2 + 1] == vertices[i].uv[1]);
+  }
+  REQUIRE(matches);
+  REQUIRE(boundingBox[0] == 0.0f);
+  REQUIRE(boundingBox[1] == -36.0f);
+  REQUIRE(boundingBox[2] == 0.0f);
+  REQUIRE(boundingBox[3] == 36.0f);
+  REQUIRE(boundingBox[4] == 0.0f);
+  REQUIRE(boundingBox[5] == 18.0f);
+
+  // packed vec3, the last element ends the buffer
+  std::vector<float> packed = {1, 2, 3, 4, 5, 6};
+  float out[8];
+  SirMetal::extractFloat3ToFloat4(packed.data(), 12, 2, 0.0f, out);
+  REQUIRE(out[3] == 0.0f);
+  REQUIRE(out[4] == 4.0f);
+  REQUIRE(out[6] == 6.0f);
+  REQUIRE(out[7] == 0.0f);
+}
+
+TEST_CASE("Vertex streams index widening", "[resources]") {
+  static constexpr uint32_t COUNT = 21;
+  std::vector<uint16_t> shortIndices(COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) { shortIndices[i] = static_cast<uint16_t>(65535 - i); }
+  std::vector<uint32_t> out(COUNT, 0);
+  REQUIRE(SirMetal::extractIndices(shortIndices.data(), 2, 2, COUNT, out.data()));
+  bool matches = true;
+  for (uint32_t i = 0; i < COUNT; ++i) { matches &= out[i] == 65535 - i; }
+  REQUIRE(matches);
+
+  // strided, every other index
+  std::vector<uint32_t> wideIndices(COUNT * 2);
+  for (uint32_t i = 0; i < COUNT * 2; ++i) { wideIndices[i] = i; }
+  REQUIRE(SirMetal::extractIndices(wideIndices.data(), 4, 8, COUNT, out.data()));
+  matches = true;
+  for (uint32_t i = 0; i < COUNT; ++i) { matches &= out[i] == i * 2; }
+  REQUIRE(matches);
+
+  const uint8_t byteIndices[3] = {7, 0, 255};
+  REQUIRE(SirMetal::extractIndices(byteIndices, 1, 1, 3, out.data()));
+  REQUIRE(out[2] == 255);
+  REQUIRE_FALSE(SirMetal::extractIndices(byteIndices, 3, 3, 1, out.data()));
+}
@@ -0,0 +1,126 @@
+#include "SirMetal/core/memory/cpu/resizableVector.h"
+#include "SirMetal/core/memory/cpu/stackAllocator.h"
+#include "SirMetal/core/memory/cpu/virtualArena.h"
+#include "catch/catch.h"
+
+static constexpr uint64_t ARENA_RESERVE = 1ull << 30;
+
+TEST_CASE("Virtual arena reserve does not commit", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(ARENA_RESERVE));
+  REQUIRE(arena.isReserved());
+  REQUIRE(arena.getReservedSize() == ARENA_RESERVE);
+  REQUIRE(arena.getCommittedSize() == 0);
+  arena.release();
+  REQUIRE_FALSE(arena.isReserved());
+}
+
+TEST_CASE("Virtual arena commits on demand", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(ARENA_RESERVE));
+  auto *first = static_cast<char *>(arena.allocate(100));
+  REQUIRE(first == arena.getBase());
+  REQUIRE(arena.getCommittedSize() == arena.getCommitGranularity());
+  memset(first, 1, 100);
+
+  auto *second = static_cast<char *>(arena.allocate(3 * arena.getCommitGranularity(), 64));
+  REQUIRE(reinterpret_cast<uintptr_t>(second) % 64 == 0);
+  REQUIRE(arena.getCommittedSize() >= arena.getUsedBytes());
+  memset(second, 2, 3 * arena.getCommitGranularity());
+  REQUIRE(first[99] == 1);
+
+  // only the last allocation goes back
+  arena.free(first);
+  REQUIRE(arena.getUsedBytes() > 100);
+  arena.free(second);
+  REQUIRE(arena.getUsedBytes() == 128);
+}
+
+TEST_CASE("Virtual arena runs out of reserve", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(1 << 20));
+  REQUIRE(arena.allocate(1 << 19) != nullptr);
+  REQUIRE(arena.allocate(1 << 20) == nullptr);
+  REQUIRE(arena.allocate(1 << 18) != nullptr);
+}
+
+TEST_CASE("Virtual arena grows in place", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(ARENA_RESERVE));
+  void *block = arena.allocate(64);
+  REQUIRE(arena.tryGrowInPlace(block, 10 * 1024 * 1024));
+  memset(block, 3, 10 * 1024 * 1024);
+  REQUIRE(arena.getUsedBytes() == 10 * 1024 * 1024);
+  void *other = arena.allocate(64);
+  // not the last allocation anymore
+  REQUIRE_FALSE(arena.tryGrowInPlace(block, 20 * 1024 * 1024));
+  REQUIRE(arena.tryGrowInPlace(other, 128));
+}
+
+TEST_CASE("Virtual arena decommit", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(ARENA_RESERVE));
+  auto *memory = static_cast<char *>(arena.allocate(8 * 1024 * 1024));
+  memset(memory, 5, 8 * 1024 * 1024);
+  REQUIRE(arena.getCommittedSize() >= 8 * 1024 * 1024);
+
+  // level unloaded
+  arena.reset();
+  arena.shrinkToFit();
+  REQUIRE(arena.getCommittedSize() == 0);
+
+  // pages come back zeroed
+  memory = static_cast<char *>(arena.allocate(1024 * 1024));
+  REQUIRE(memory == arena.getBase());
+  bool zeroed = true;
+  for (uint32_t i = 0; i < 1024 * 1024; i += 4096) { zeroed &= memory[i] == 0; }
+  REQUIRE(zeroed);
+
+  arena.decommit(4 * 1024 * 1024);
+  REQUIRE(arena.getCommittedSize() == 1024 * 1024);
+}
+
+TEST_CASE("Virtual arena huge pages hint", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(64 * 1024 * 1024, SirMetal::VIRTUAL_ARENA_FLAG_HUGE_PAGES));
+  REQUIRE(reinterpret_cast<uintptr_t>(arena.getBase()) %
+                  SirMetal::VirtualArena::HUGE_PAGE_SIZE ==
+          0);
+  REQUIRE(arena.getCommitGranularity() == SirMetal::VirtualArena::HUGE_PAGE_SIZE);
+  auto *memory = static_cast<char *>(arena.allocate(3 * 1024 * 1024));
+  memset(memory, 1, 3 * 1024 * 1024);
+  REQUIRE(arena.getCommittedSize() == 4 * 1024 * 1024);
+}
+
+TEST_CASE("Resizable vector grows in place in a virtual arena", "[memory]") {
+  SirMetal::VirtualArena arena;
+  REQUIRE(arena.reserve(ARENA_RESERVE));
+  SirMetal::ResizableVector<uint32_t, SirMetal::VirtualArena> vec(16, &arena);
+  const uint32_t *start = vec.data();
+  for (uint32_t i = 0; i < 1000000; ++i) { vec.pushBack(i); }
+  REQUIRE(vec.data() == start);
+  bool valid = true;
+  for (uint32_t i = 0; i < vec.size(); ++i) { valid &= vec[i] == i; }
+  REQUIRE(valid);
+  vec.resize(4000000);
+  REQUIRE(vec.data() == start);
+}
+
+TEST_CASE("StackAllocator virtual grows", "[memory]") {
+  SirMetal::StackAllocator alloc;
+  alloc.initializeVirtual(ARENA_RESERVE);
+  REQUIRE(alloc.isVirtual());
+  const size_t initialSize = alloc.getSizeInByte();
+  void *first = alloc.allocate(16);
+  REQUIRE(first == alloc.getStartPtr());
+  auto *big = static_cast<char *>(alloc.allocate(initialSize * 10));
+  REQUIRE(big != nullptr);
+  memset(big, 1, initialSize * 10);
+  REQUIRE(alloc.getSizeInByte() > initialSize);
+  REQUIRE(alloc.getStartPtr() == first);
+
+  alloc.reset();
+  alloc.decommitUnused();
+  REQUIRE(alloc.getSizeInByte() == initialSize);
+  REQUIRE(alloc.allocate(64) == first);
+}